@@ -0,0 +1,389 @@
+#include "analizador_exhaustivo.hpp"
+#include "buscador_patrones.hpp"
+#include "calculador_costos.hpp"
+#include "calculador_tabular.hpp"
+#include "escenario.hpp"
+#include "formato_csv.hpp"
+#include "resumen_agregado.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sched.h>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Microbenchmarks reproducibles del optimizador. Cada caso hace una cantidad
+// fija de operaciones sobre entradas fijas (semilla constante); se calienta y
+// se repite, y se informa la mediana y los percentiles del tiempo por
+// operación. El proceso se fija a un núcleo (salvo el barrido multihilo).
+//
+// Uso: bench_maquina [--repeticiones N] [--cpu N] [--filtro texto] [--json salida.json]
+//                    [--comparar base.json] [--tolerancia PORCIENTO]
+// Con --comparar, termina con código 3 si algún caso es más lento que la base
+// por encima de la tolerancia (10% por defecto).
+
+namespace {
+using Reloj = std::chrono::steady_clock;
+
+const std::vector<double> DEMANDA_FIJA = {
+    300, 200, 100, 100, 100, 200, 300, 500, 800, 1000, 1000, 1000,
+    1000, 900, 800, 800, 800, 1000, 1000, 1000, 600, 600, 400, 300
+};
+
+// Evita que el compilador descarte un resultado que no se usa
+template <typename T>
+void consumir(const T& valor) {
+    asm volatile("" : : "g"(&valor) : "memory");
+}
+
+struct Opciones {
+    int repeticiones = 15;
+    int calentamiento = 2;
+    int cpu = -1;                 // -1 = el primero permitido
+    std::string filtro;
+    std::string archivo_json;
+    std::string archivo_base;
+    double tolerancia = 10.0;
+};
+
+struct Medicion {
+    std::string nombre;
+    uint64_t operaciones;         // Por repetición
+    std::vector<double> ns_por_operacion;
+
+    double percentil(double p) const {
+        std::vector<double> orden = ns_por_operacion;
+        std::sort(orden.begin(), orden.end());
+        double posicion = p / 100.0 * (orden.size() - 1);
+        size_t i = static_cast<size_t>(posicion);
+        double fraccion = posicion - i;
+        return i + 1 < orden.size() ? orden[i] * (1 - fraccion) + orden[i + 1] * fraccion : orden[i];
+    }
+    double mediana() const { return percentil(50); }
+};
+
+class Suite {
+private:
+    const Opciones& opciones_;
+    std::vector<Medicion> mediciones_;
+
+public:
+    explicit Suite(const Opciones& opciones) : opciones_(opciones) {}
+
+    // `cuerpo` hace `operaciones` operaciones por llamada
+    void medir(const std::string& nombre, uint64_t operaciones, const std::function<void()>& cuerpo) {
+        if (!opciones_.filtro.empty() && nombre.find(opciones_.filtro) == std::string::npos) return;
+        for (int i = 0; i < opciones_.calentamiento; i++) cuerpo();
+        Medicion medicion{nombre, operaciones, {}};
+        for (int i = 0; i < opciones_.repeticiones; i++) {
+            auto inicio = Reloj::now();
+            cuerpo();
+            double ns = std::chrono::duration<double, std::nano>(Reloj::now() - inicio).count();
+            medicion.ns_por_operacion.push_back(ns / operaciones);
+        }
+        std::cout << std::left << std::setw(40) << nombre << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << medicion.mediana() << " ns/op  (p10 " << medicion.percentil(10)
+                  << ", p90 " << medicion.percentil(90) << ")  " << std::setprecision(0)
+                  << 1e9 / medicion.mediana() << " op/s" << std::endl;
+        mediciones_.push_back(std::move(medicion));
+    }
+
+    const std::vector<Medicion>& mediciones() const { return mediciones_; }
+};
+
+// Patrones eólicos fijos para todos los casos (convención del analizador: bit h = hora h)
+std::vector<uint32_t> patronesFijos(size_t cantidad) {
+    std::mt19937 generador(20240611);
+    std::vector<uint32_t> patrones(cantidad);
+    for (uint32_t& patron : patrones) patron = generador() & 0xFFFFFF;
+    return patrones;
+}
+
+void configurarEscenario(Escenario& escenario, uint32_t patron) {
+    for (int hora = 0; hora < 24; hora++) {
+        escenario.setDemanda(hora, DEMANDA_FIJA[hora]);
+        escenario.setEnergiaOtrasFuentes(hora, (patron >> hora) & 1 ? 500.0 : 0.0);
+    }
+}
+
+void casosSolvers(Suite& suite) {
+    const std::vector<uint32_t> patrones = patronesFijos(2000);
+
+    std::vector<Escenario> escenarios(patrones.size());
+    for (size_t i = 0; i < patrones.size(); i++) configurarEscenario(escenarios[i], patrones[i]);
+
+    suite.medir("escenario.construccion", patrones.size(), [&] {
+        for (uint32_t patron : patrones) {
+            Escenario escenario;
+            configurarEscenario(escenario, patron);
+            consumir(escenario);
+        }
+    });
+
+    suite.medir("calculador_costos.resolver", patrones.size(), [&] {
+        for (const Escenario& escenario : escenarios) {
+            CalculadorCostos calculador(escenario);
+            calculador.configurarCostos(1.0, 2.5, 5.0);
+            calculador.configurarSilencioso(true);
+            Solucion solucion = calculador.resolver();
+            consumir(solucion.costo_total);
+        }
+    });
+
+    CalculadorTabular tabular;
+    tabular.configurarDemanda(DEMANDA_FIJA, 500.0);
+    tabular.configurarCostos(1.0, 2.5, 5.0);
+    std::vector<uint32_t> mascaras(patrones.size());
+    for (size_t i = 0; i < patrones.size(); i++) mascaras[i] = tabular.mascaraCriticas(patrones[i]);
+
+    suite.medir("calculador_tabular.resolver", mascaras.size(), [&] {
+        EstadoMaquina estados[24];
+        for (uint32_t mascara : mascaras) consumir(tabular.resolver(mascara, estados));
+    });
+    suite.medir("calculador_tabular.resolver_solo_costo", mascaras.size(), [&] {
+        for (uint32_t mascara : mascaras) consumir(tabular.resolver(mascara));
+    });
+
+    suite.medir("buscador_patrones.top10_baratos", 50, [&] {
+        for (int i = 0; i < 50; i++) {
+            BuscadorPatrones buscador(tabular);
+            consumir(buscador.buscar(CriterioBusqueda::MAS_BARATOS, 10));
+        }
+    });
+    suite.medir("buscador_patrones.top10_caros", 50, [&] {
+        for (int i = 0; i < 50; i++) {
+            BuscadorPatrones buscador(tabular);
+            consumir(buscador.buscar(CriterioBusqueda::MAS_CAROS, 10));
+        }
+    });
+}
+
+void casosFormato(Suite& suite) {
+    const std::vector<uint32_t> patrones = patronesFijos(20000);
+    CalculadorTabular tabular;
+    tabular.configurarCostos(1.0, 2.5, 5.0);
+    std::vector<std::vector<EstadoMaquina>> secuencias(patrones.size());
+    std::vector<double> costos(patrones.size());
+    std::vector<uint32_t> encendidos(patrones.size());
+    for (size_t i = 0; i < patrones.size(); i++) {
+        EstadoMaquina estados[24];
+        costos[i] = tabular.resolver(tabular.mascaraCriticas(patrones[i]), estados);
+        secuencias[i].assign(estados, estados + 24);
+        encendidos[i] = ResumenAgregado::mascaraEncendido(secuencias[i]);
+    }
+
+    char fila[MAX_FILA_CSV];
+    suite.medir("formato_csv.fila_transiciones", patrones.size(), [&] {
+        for (size_t i = 0; i < patrones.size(); i++) {
+            consumir(escribirFilaTransicionesCsv(fila, patrones[i], costos[i], true, 12, encendidos[i]));
+        }
+    });
+    suite.medir("formato_csv.fila_secuencia", patrones.size(), [&] {
+        for (size_t i = 0; i < patrones.size(); i++) {
+            consumir(escribirFilaSecuenciaCsv(fila, patrones[i], costos[i], true, 12, secuencias[i]));
+        }
+    });
+    suite.medir("formato_csv.ostream_referencia", patrones.size(), [&] {
+        std::ostringstream salida;
+        for (size_t i = 0; i < patrones.size(); i++) {
+            salida << patrones[i] << "," << std::fixed << std::setprecision(2) << costos[i] << ",SI,12,"
+                   << ResumenAgregado::transicionesDeMascara(encendidos[i]) << "\n";
+        }
+        consumir(salida);
+    });
+    // Cadena de transiciones: la versión sin asignaciones y la que arma un std::string
+    suite.medir("transiciones.escribir_csv", patrones.size(), [&] {
+        for (uint32_t encendido : encendidos) consumir(escribirTransicionesCsv(fila, encendido));
+    });
+    suite.medir("transiciones.string", patrones.size(), [&] {
+        for (uint32_t encendido : encendidos) consumir(ResumenAgregado::transicionesDeMascara(encendido));
+    });
+    suite.medir("transiciones.mascara_encendido", patrones.size(), [&] {
+        for (const auto& secuencia : secuencias) consumir(ResumenAgregado::mascaraEncendido(secuencia));
+    });
+}
+
+// Barrido de punta a punta con AnalizadorExhaustivo (CSV, log y resumen en un directorio temporal)
+void casosBarrido(Suite& suite, const cpu_set_t& afinidad_original) {
+    char plantilla[] = "/tmp/bench_maquina_XXXXXX";
+    if (mkdtemp(plantilla) == nullptr) {
+        std::cerr << "⚠️  No se pudo crear el directorio temporal; se omiten los barridos\n";
+        return;
+    }
+    std::string directorio = plantilla;
+    const uint32_t COMBINACIONES = 16384;
+
+    auto barrer = [&](unsigned num_hilos) {
+        std::streambuf* consola = std::cout.rdbuf();
+        std::ofstream nulo("/dev/null");
+        std::cout.rdbuf(nulo.rdbuf());
+        AnalizadorExhaustivo analizador;
+        analizador.configurarDemanda(DEMANDA_FIJA);
+        analizador.configurarReporte(COMBINACIONES * 2, true);
+        analizador.configurarHilos(num_hilos);
+        analizador.configurarArchivos(directorio + "/resultados.csv", directorio + "/progreso.log");
+        analizador.ejecutarAnalisisParcial(0, COMBINACIONES);
+        std::cout.rdbuf(consola);
+    };
+    suite.medir("barrido.secuencial_16k", COMBINACIONES, [&] { barrer(1); });
+
+    // El barrido multihilo usa todos los núcleos que tenía el proceso
+    cpu_set_t fijado;
+    sched_getaffinity(0, sizeof(fijado), &fijado);
+    sched_setaffinity(0, sizeof(afinidad_original), &afinidad_original);
+    suite.medir("barrido.multihilo_16k", COMBINACIONES, [&] { barrer(0); });
+    sched_setaffinity(0, sizeof(fijado), &fijado);
+
+    for (const char* archivo : {"/resultados.csv", "/progreso.log", "/resultados_resumen.txt"}) {
+        std::remove((directorio + archivo).c_str());
+    }
+    rmdir(directorio.c_str());
+}
+
+std::string escaparJson(const std::string& texto) {
+    std::string salida;
+    for (char c : texto) {
+        if (c == '"' || c == '\\') salida += '\\';
+        salida += c;
+    }
+    return salida;
+}
+
+// Un caso por línea, para que la comparación pueda leerlo sin un parser de JSON
+void escribirJson(const std::string& archivo, const Opciones& opciones, int cpu, const std::vector<Medicion>& mediciones) {
+    std::ofstream salida(archivo);
+    if (!salida.is_open()) {
+        throw std::runtime_error("No se pudo crear " + archivo);
+    }
+    salida << std::fixed << std::setprecision(2);
+    salida << "{\n  \"formato\": \"bench_maquina/1\",\n"
+           << "  \"compilador\": \"" << escaparJson(__VERSION__) << "\",\n"
+           << "  \"cpu\": " << cpu << ",\n  \"repeticiones\": " << opciones.repeticiones << ",\n"
+           << "  \"casos\": [\n";
+    for (size_t i = 0; i < mediciones.size(); i++) {
+        const Medicion& m = mediciones[i];
+        salida << "    {\"nombre\": \"" << escaparJson(m.nombre) << "\", \"operaciones\": " << m.operaciones
+               << ", \"mediana_ns\": " << m.mediana() << ", \"p10_ns\": " << m.percentil(10)
+               << ", \"p90_ns\": " << m.percentil(90) << ", \"p99_ns\": " << m.percentil(99)
+               << ", \"min_ns\": " << m.percentil(0) << ", \"ops_por_segundo\": " << 1e9 / m.mediana() << "}"
+               << (i + 1 < mediciones.size() ? "," : "") << "\n";
+    }
+    salida << "  ]\n}\n";
+}
+
+// Medianas de un JSON escrito por escribirJson
+std::map<std::string, double> leerBase(const std::string& archivo) {
+    std::ifstream entrada(archivo);
+    if (!entrada.is_open()) {
+        throw std::runtime_error("No se pudo abrir la base " + archivo);
+    }
+    std::map<std::string, double> medianas;
+    std::string linea;
+    const std::string clave_nombre = "\"nombre\": \"", clave_mediana = "\"mediana_ns\": ";
+    while (std::getline(entrada, linea)) {
+        size_t nombre = linea.find(clave_nombre), mediana = linea.find(clave_mediana);
+        if (nombre == std::string::npos || mediana == std::string::npos) continue;
+        nombre += clave_nombre.size();
+        medianas[linea.substr(nombre, linea.find('"', nombre) - nombre)] =
+            std::stod(linea.substr(mediana + clave_mediana.size()));
+    }
+    return medianas;
+}
+
+// Devuelve la cantidad de regresiones
+int comparar(const std::vector<Medicion>& mediciones, const std::map<std::string, double>& base, double tolerancia) {
+    int regresiones = 0;
+    std::cout << "\n📏 Comparación con la base (tolerancia " << tolerancia << "%)\n";
+    for (const Medicion& m : mediciones) {
+        auto anterior = base.find(m.nombre);
+        if (anterior == base.end()) {
+            std::cout << "  " << std::left << std::setw(40) << m.nombre << "   (sin base)\n";
+            continue;
+        }
+        double cambio = (m.mediana() / anterior->second - 1.0) * 100.0;
+        bool regresion = cambio > tolerancia;
+        regresiones += regresion;
+        std::cout << (regresion ? "❌ " : "   ") << std::left << std::setw(40) << m.nombre << std::right
+                  << std::showpos << std::setprecision(1) << std::setw(8) << cambio << "%" << std::noshowpos << "\n";
+    }
+    return regresiones;
+}
+
+bool interpretarOpciones(int argc, char* argv[], Opciones& opciones) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hay_valor = i + 1 < argc;
+        if (arg == "--repeticiones" && hay_valor) {
+            opciones.repeticiones = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--cpu" && hay_valor) {
+            opciones.cpu = std::stoi(argv[++i]);
+        } else if (arg == "--filtro" && hay_valor) {
+            opciones.filtro = argv[++i];
+        } else if (arg == "--json" && hay_valor) {
+            opciones.archivo_json = argv[++i];
+        } else if (arg == "--comparar" && hay_valor) {
+            opciones.archivo_base = argv[++i];
+        } else if (arg == "--tolerancia" && hay_valor) {
+            opciones.tolerancia = std::stod(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+int main(int argc, char* argv[]) {
+    Opciones opciones;
+    try {
+        if (!interpretarOpciones(argc, argv, opciones)) {
+            std::cerr << "Uso: " << argv[0] << " [--repeticiones N] [--cpu N] [--filtro texto] [--json salida.json]\n"
+                      << "       [--comparar base.json] [--tolerancia PORCIENTO]\n";
+            return 1;
+        }
+
+        // Fijar el proceso a un núcleo para que las repeticiones sean comparables
+        cpu_set_t original, fijado;
+        sched_getaffinity(0, sizeof(original), &original);
+        int cpu = opciones.cpu;
+        for (int c = 0; cpu < 0 && c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &original)) cpu = c;
+        }
+        CPU_ZERO(&fijado);
+        CPU_SET(cpu, &fijado);
+        if (sched_setaffinity(0, sizeof(fijado), &fijado) != 0) {
+            std::cerr << "⚠️  No se pudo fijar el proceso al núcleo " << cpu << "\n";
+        }
+
+        std::cout << "⏱️  === BENCHMARKS (" << opciones.repeticiones << " repeticiones, núcleo " << cpu << ") ===\n";
+        Suite suite(opciones);
+        casosSolvers(suite);
+        casosFormato(suite);
+        casosBarrido(suite, original);
+
+        if (!opciones.archivo_json.empty()) {
+            escribirJson(opciones.archivo_json, opciones, cpu, suite.mediciones());
+            std::cout << "\nResultados guardados en: " << opciones.archivo_json << "\n";
+        }
+        if (!opciones.archivo_base.empty()) {
+            int regresiones = comparar(suite.mediciones(), leerBase(opciones.archivo_base), opciones.tolerancia);
+            if (regresiones > 0) {
+                std::cout << "❌ " << regresiones << " caso(s) más lentos que la base\n";
+                return 3;
+            }
+            std::cout << "✅ Sin regresiones\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
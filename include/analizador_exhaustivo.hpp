@@ -3,10 +3,18 @@
 
 #include "calculador_costos.hpp"
 #include "escenario.hpp"
+#include "escritor_asincrono.hpp"
+#include "escritor_cubo.hpp"
+#include "resumen_agregado.hpp"
+#include "shard_barrido.hpp"
+#include "telemetria.hpp"
 #include <fstream>
 #include <chrono>
 #include <bitset>
 #include <limits>
+#include <memory>
+#include <string>
+#include <vector>
 // Estructura para almacenar resultados de una combinación
 struct ResultadoCombinacion {
     uint32_t combinacion_id;           // ID de la combinación (0 a 2^24-1)
@@ -28,12 +36,17 @@ struct EstadisticasProgreso {
     double costo_minimo_global;
     double costo_maximo_global;
     double costo_promedio;
+    double suma_costos;                // Suma de costos válidos (para el promedio)
     std::chrono::steady_clock::time_point tiempo_inicio;
     std::chrono::steady_clock::time_point ultimo_reporte;
     
     EstadisticasProgreso() : combinaciones_procesadas(0), combinaciones_totales(16777216),
                             soluciones_validas(0), costo_minimo_global(std::numeric_limits<double>::infinity()),
-                            costo_maximo_global(0.0), costo_promedio(0.0) {}
+                            costo_maximo_global(0.0), costo_promedio(0.0), suma_costos(0.0) {}
+    
+    // Acumular un resultado y combinar estadísticas parciales (modo multihilo)
+    void registrar(bool solucion_valida, double costo_total);
+    void combinar(const EstadisticasProgreso& otras);
 };
 
 class AnalizadorExhaustivo {
@@ -41,19 +54,79 @@ private:
     std::vector<double> demanda_fija_;     // Demanda fija para las 24 horas
     std::ofstream archivo_resultados_;    // Archivo para guardar resultados
     std::ofstream archivo_log_;           // Archivo de log para progreso
+    // Todas las filas pasan por el escritor; el stream solo se toca tras vaciar()
+    std::unique_ptr<EscritorAsincrono> escritor_;
+    EscritorAsincrono::Config config_escritor_;
     EstadisticasProgreso stats_;          // Estadísticas de progreso
+    std::unique_ptr<ResumenAgregado> resumen_;  // Histograma, extremos y transiciones
+    std::string ruta_cubo_;               // Cubo binario con todas las filas ("" = no)
+    std::unique_ptr<EscritorCubo> cubo_;
     
     // Configuración
     uint32_t intervalo_reporte_;          // Cada cuántas combinaciones reportar progreso
     bool guardar_todas_soluciones_;       // Si guardar todas o solo las mejores
     double umbral_costo_interes_;         // Solo guardar soluciones bajo este costo
+    unsigned num_hilos_;                  // 1 = secuencial
+    uint32_t tam_bloque_;                 // Combinaciones por bloque en modo multihilo
+    bool afinidad_;                       // Atar los hilos a CPUs por dominio de memoria
+    
+    // Checkpoints: cada cuántas combinaciones guardar el estado (0 = nunca)
+    uint32_t intervalo_checkpoint_;
+    std::string archivo_checkpoint_;      // <archivo_resultados>.checkpoint
+    std::string ruta_resultados_;         // Se fuerza a disco antes de cada checkpoint
+    std::string ruta_log_;                // Para reabrir el log al reanudar
+    uint32_t rango_desde_;                // Rango de la corrida en curso
+    uint32_t rango_hasta_;
+    bool analisis_completo_;              // Completo o parcial (define el cierre)
+    
+    // Modo shard: los resultados se escriben como shard autodescriptivo
+    bool modo_shard_;
+    uint32_t indice_shard_;
+    uint32_t total_shards_;
+    
+    // Progreso en vivo: una ranura por hilo, leída sin detener a los hilos
+    std::unique_ptr<TelemetriaHilos> telemetria_;
+    uint32_t procesadas_previas_;         // Ya contadas al empezar el rango (al reanudar)
+    EstimadorAvance avance_;              // Tasa suavizada para el ETA
+    std::string ruta_metricas_;           // Métricas de Prometheus ("" = no)
+    uint32_t intervalo_metricas_ms_;
+    
+    // Lo que aporta un bloque del modo multihilo; se acumula al emitirlo, en
+    // orden, así las estadísticas siempre corresponden al prefijo escrito
+    struct RegistroResumen {
+        uint32_t combinacion_id;
+        uint32_t mascara_encendido;
+        double costo_total;
+        int horas_criticas;
+        bool solucion_valida;
+    };
+    struct ParcialBloque {
+        EstadisticasProgreso stats;
+        std::vector<RegistroResumen> registros;
+    };
     
     // Métodos privados
-    void configurarEscenario(Escenario& escenario, const std::bitset<24>& patron_eolica);
+    void configurarEscenario(Escenario& escenario, const std::bitset<24>& patron_eolica) const;
+    ResultadoCombinacion resolverCombinacion(uint32_t combinacion, bool silencioso) const;
+    bool debeGuardarse(const ResultadoCombinacion& resultado) const;
+    char* formatearResultado(char* p, const ResultadoCombinacion& resultado) const;
     void guardarResultado(const ResultadoCombinacion& resultado);
+    void completarRango(uint32_t desde);
+    void procesarRango(uint32_t desde, uint32_t hasta);
+    void procesarRangoSecuencial(uint32_t desde, uint32_t hasta);
+    void procesarRangoParalelo(uint32_t desde, uint32_t hasta);
     void mostrarProgreso();
+    uint64_t procesadasEnVivo() const;
+    MetricasBarrido metricasEnVivo(EstimadorAvance& avance) const;
     void generarReporteProgreso();
-    std::string estadoToString(EstadoMaquina estado) const;
+    void registrarEnResumen(ResumenAgregado& resumen, const ResultadoCombinacion& resultado) const;
+    void registrarEnCubo(const ResultadoCombinacion& resultado);
+    CabeceraCubo cabeceraCubo() const;
+    void escribirResumenAgregado();
+    MetadatosShard metadatosShard() const;
+    void completarShard();
+    void escribirCheckpoint(uint32_t siguiente_id);
+    void borrarCheckpoint();
     std::string tiempoTranscurrido() const;
     double tiempoEstimadoRestante() const;
     
@@ -65,11 +138,33 @@ public:
     void configurarDemanda(const std::vector<double>& demanda);
     void configurarArchivos(const std::string& archivo_resultados, const std::string& archivo_log);
     void configurarReporte(uint32_t intervalo, bool guardar_todas = false, double umbral_costo = std::numeric_limits<double>::infinity());
+    void configurarHilos(unsigned num_hilos, uint32_t tam_bloque = 4096);  // 0 = todos los núcleos
+    // Modo multihilo: atar cada hilo a una CPU según la topología de /sys
+    // (topologia.hpp), robar primero dentro del dominio y reportar su rendimiento
+    void configurarAfinidad(bool activa);
+    void configurarCheckpoint(uint32_t intervalo);                         // 0 = desactivado
+    // Escritura asíncrona: tamaño de buffer, buffers en vuelo y flush por bytes o milisegundos
+    void configurarEscritura(size_t tam_buffer, size_t max_buffers, size_t bytes_flush, uint32_t ms_flush);
+    // Escribir el próximo análisis como shard i de N (antes de configurarArchivos);
+    // fusionar_shards junta los shards de todos los tramos
+    void configurarShard(uint32_t indice, uint32_t total_shards);
+    // Además del CSV, escribir cada fila del próximo análisis en un cubo binario
+    // (cubo_resultados.hpp); a diferencia del CSV no depende del umbral de costo.
+    // Con "" no se escribe cubo
+    void configurarCubo(const std::string& archivo_cubo);
+    // Reescribir `ruta` cada `intervalo_ms` con el progreso en formato de texto de
+    // Prometheus (telemetria.hpp) mientras corre el análisis; con "" no se escriben
+    void configurarMetricas(const std::string& ruta, uint32_t intervalo_ms = 1000);
     
     // Análisis principal
     void ejecutarAnalisisCompleto();
     void ejecutarAnalisisParcial(uint32_t desde, uint32_t hasta);
     
+    // Continúa una corrida interrumpida a partir de <archivo_resultados>.checkpoint:
+    // recorta el CSV al último punto guardado y sigue desde ahí. Devuelve false
+    // si no hay checkpoint; lanza std::runtime_error si no es compatible.
+    bool reanudarAnalisis(const std::string& archivo_resultados);
+    
     // Utilidades
     void mostrarEstadisticasFinales();
     void generarResumenEjecutivo();
@@ -0,0 +1,101 @@
+#ifndef BUSCADOR_PATRONES_HPP
+#define BUSCADOR_PATRONES_HPP
+
+#include "calculador_tabular.hpp"
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+// Qué extremo del espacio de patrones se busca
+enum class CriterioBusqueda {
+    MAS_BARATOS,   // Top-K de menor costo
+    MAS_CAROS      // Top-K de mayor costo (solo soluciones válidas)
+};
+
+// Un patrón del top-K. El ID usa la convención de los demos: hora 0 = bit 23.
+struct PatronCandidato {
+    uint32_t combinacion_id;
+    double costo_total;
+    int horas_criticas;
+    int horas_eolicas;
+
+    PatronCandidato() : combinacion_id(0), costo_total(0.0), horas_criticas(0), horas_eolicas(0) {}
+};
+
+// Contadores de la búsqueda
+struct EstadisticasBusqueda {
+    uint64_t nodos_explorados;
+    uint64_t nodos_podados;
+    uint64_t hojas_evaluadas;
+    uint64_t subarboles_uniformes;    // Subárboles con cota optimista == pesimista
+    double tiempo_ms;
+
+    EstadisticasBusqueda() : nodos_explorados(0), nodos_podados(0), hojas_evaluadas(0),
+                             subarboles_uniformes(0), tiempo_ms(0.0) {}
+};
+
+// Búsqueda por ramificación y acotamiento de los K patrones eólicos más baratos
+// o más caros. El patrón se construye hora a hora (0..23) y cada nodo guarda el
+// prefijo de la DP hacia adelante; con él se calculan dos cotas del subárbol:
+//   - costo mínimo: prefijo + tabla de sufijos con la mejor elección de viento
+//     en cada hora restante (exacta para el mejor patrón del subárbol);
+//   - costo máximo: prefijo + resto de horas sin viento (las horas sin viento
+//     solo restringen más los estados), probando ambas opciones en la hora 23.
+// Según el criterio, una es la cota optimista y la otra la pesimista. Si ambas
+// coinciden todos los patrones del subárbol cuestan lo mismo: se recorren en
+// orden de ID y se corta en el primero que ya no entra al top-K.
+class BuscadorPatrones {
+private:
+    using CostosPorEstado = CalculadorTabular::CostosPorEstado;
+
+    // Orden (costo, id) que define el top-K; el elemento "mayor" es el peor
+    struct PeorPrimero {
+        bool buscar_caros;
+        bool operator()(const PatronCandidato& a, const PatronCandidato& b) const;
+    };
+
+    const CalculadorTabular& calculador_;
+    uint32_t criticas_sin_eolica_;
+    uint32_t criticas_con_eolica_;
+
+    // sufijo_minimo_[h][s]: costo mínimo de las horas h..23 si en h-1 se estaba en s
+    std::array<CostosPorEstado, CalculadorTabular::NUM_HORAS + 1> sufijo_minimo_;
+
+    // Restricción sobre la cantidad de horas con viento
+    int min_horas_eolicas_;
+    int max_horas_eolicas_;
+
+    // Estado de la búsqueda en curso
+    CriterioBusqueda criterio_;
+    size_t k_;
+    std::priority_queue<PatronCandidato, std::vector<PatronCandidato>, PeorPrimero> mejores_;
+    EstadisticasBusqueda stats_;
+
+    bool esCritica(int hora, bool con_eolica) const;
+    void calcularSufijos();
+    double cotaMinima(const CostosPorEstado& prefijo, int hora_siguiente) const;
+    double cotaMaxima(const CostosPorEstado& prefijo, int hora_siguiente) const;
+    double completarSinEolica(const CostosPorEstado& prefijo, int hora_siguiente, bool eolica_23) const;
+
+    bool puedeMejorar(double cota_optimista, uint32_t id_minimo) const;
+    bool admitir(const PatronCandidato& candidato);
+    bool cuentaEolicaFactible(int horas_eolicas, int horas_restantes) const;
+
+    void explorar(const CostosPorEstado& prefijo, int hora, uint32_t patron, int horas_eolicas);
+    bool enumerarUniforme(int hora, uint32_t patron, int horas_eolicas);
+    PatronCandidato crearCandidato(uint32_t patron, double costo) const;
+
+public:
+    // Constructor
+    explicit BuscadorPatrones(const CalculadorTabular& calculador);
+
+    // Configuración: solo patrones con [minimo, maximo] horas de viento
+    void configurarHorasEolicas(int minimo, int maximo);
+
+    // Búsqueda principal; devuelve hasta k patrones ordenados del mejor al peor
+    std::vector<PatronCandidato> buscar(CriterioBusqueda criterio, size_t k);
+
+    const EstadisticasBusqueda& getEstadisticas() const { return stats_; }
+};
+
+#endif // BUSCADOR_PATRONES_HPP
@@ -5,6 +5,8 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <limits>
+#include <string>
 
 // Enumeración para los estados de la máquina
 enum class EstadoMaquina {
@@ -45,6 +47,9 @@ private:
     // Memoización mejorada para reconstruir soluciones
     std::map<std::pair<int, EstadoMaquina>, ResultadoMemo> memo_;
     
+    // Si es true, resolver() no escribe en std::cout (necesario con varios hilos)
+    bool silencioso_;
+    
     // Métodos auxiliares
     std::vector<EstadoMaquina> obtenerTransicionesPosibles(EstadoMaquina estado_actual) const;
     std::vector<EstadoMaquina> obtenerEstadosQueVanA(EstadoMaquina estado_destino) const;
@@ -65,6 +70,9 @@ public:
     // Configurar costos de mantenimiento
     void configurarCostos(double costo_frio, double costo_tibio, double costo_caliente);
     
+    // Desactivar la traza de resolver()
+    void configurarSilencioso(bool silencioso);
+    
     // Resolver el problema principal
     Solucion resolver();
     
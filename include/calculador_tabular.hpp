@@ -0,0 +1,61 @@
+#ifndef CALCULADOR_TABULAR_HPP
+#define CALCULADOR_TABULAR_HPP
+
+#include "calculador_costos.hpp"
+#include "escenario.hpp"
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Motor de programación dinámica hacia adelante, sin salida por consola ni
+// asignaciones por patrón. Reproduce exactamente el costo y la secuencia que
+// devuelve CalculadorCostos::resolver (mismo orden de desempate), pero trabaja
+// sobre máscaras de 24 bits: bit h = 1 si la hora h requiere generación propia.
+class CalculadorTabular {
+public:
+    static constexpr int NUM_HORAS = 24;
+    static constexpr int NUM_ESTADOS = 6;
+    static constexpr double INFINITO = std::numeric_limits<double>::infinity();
+
+    using CostosPorEstado = std::array<double, NUM_ESTADOS>;
+
+private:
+    std::vector<double> demanda_;          // Demanda fija para las 24 horas
+    double potencia_eolica_;               // Energía eólica de una hora con viento
+    uint32_t criticas_sin_eolica_;         // Horas críticas cuando no hay viento
+    uint32_t criticas_con_eolica_;         // Horas críticas aun con viento
+    CostosPorEstado costos_;               // Costo de mantenimiento por estado
+
+public:
+    // Constructor (demanda por defecto de los análisis exhaustivos)
+    CalculadorTabular();
+
+    // Configuración
+    void configurarDemanda(const std::vector<double>& demanda, double potencia_eolica = 500.0);
+    void configurarCostos(double costo_frio, double costo_tibio, double costo_caliente);
+
+    // Conversión de patrones a máscaras de horas críticas
+    static uint32_t eolicaPorHora(uint32_t combinacion_id);   // hora 0 = bit 23 del ID
+    uint32_t mascaraCriticas(uint32_t eolica_por_hora) const;
+    static uint32_t mascaraCriticas(const Escenario& escenario);
+
+    // Resolver una máscara completa; devuelve INFINITO si no hay solución.
+    // Si `estados` no es nulo se escriben las 24 horas de la secuencia óptima.
+    double resolver(uint32_t mascara_criticas, EstadoMaquina* estados = nullptr) const;
+
+    // Pasos elementales de la DP, para búsquedas que construyen el patrón hora a hora.
+    // costos[s] = costo mínimo de las horas 0..hora terminando en el estado s.
+    void iniciar(CostosPorEstado& costos, bool critica) const;
+    void avanzar(const CostosPorEstado& previos, CostosPorEstado& actuales, int hora, bool critica) const;
+    static bool estadoPermitido(int estado, int hora, bool critica);
+    static const std::array<int, 2>& predecesores(int estado);
+
+    // Getters
+    double getCostoMantenimiento(EstadoMaquina estado) const;
+    double getCostoMaximoHora() const;
+    const std::vector<double>& getDemanda() const { return demanda_; }
+    double getPotenciaEolica() const { return potencia_eolica_; }
+};
+
+#endif // CALCULADOR_TABULAR_HPP
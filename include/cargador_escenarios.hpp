@@ -0,0 +1,69 @@
+#ifndef CARGADOR_ESCENARIOS_HPP
+#define CARGADOR_ESCENARIOS_HPP
+
+#include "escenario.hpp"
+#include "pool_bloques.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Carga de archivos con muchos días de pronósticos reales. Cada día son dos
+// líneas de 24 valores separados por espacios, como data/parametros.in:
+// demanda y energía de otras fuentes. Las líneas vacías y las que empiezan con
+// '#' se ignoran. El archivo se mapea en memoria y se interpreta en tramos
+// paralelos con leerValoresHora; los errores se informan por número de línea
+// y el día con error se saltea sin detener la carga.
+
+// Máscara de horas críticas (bit h = 1 si otras_fuentes[h] >= demanda[h] no se
+// cumple), la misma condición que Escenario::demandaCubiertaConEO
+uint32_t mascaraCriticas(const double demanda[24], const double otras_fuentes[24]);
+
+struct ErrorEscenario {
+    uint64_t linea;              // Número de línea (desde 1)
+    std::string mensaje;
+};
+
+struct ResultadoCarga {
+    uint64_t dias;               // Días leídos, incluidos los que tienen error
+    uint64_t dias_validos;
+    uint64_t bytes;
+    std::vector<ErrorEscenario> errores;   // En orden de línea
+};
+
+class CargadorEscenarios {
+public:
+    struct Dia {
+        uint64_t numero;                 // Posición del día en el archivo (desde 0)
+        uint64_t linea;                  // Línea de la demanda
+        double demanda[24];
+        double otras_fuentes[24];
+        uint32_t mascara_criticas;
+    };
+
+    // procesar(dia, hilo, salida): corre en un hilo del pool por cada día válido
+    using FuncionDia = std::function<void(const Dia&, unsigned, std::string&)>;
+    // emitir(salida): la salida de cada tramo, en orden de archivo
+    using FuncionEmision = std::function<void(std::string&)>;
+
+private:
+    std::string archivo_;
+    const char* datos_;
+    size_t tam_;
+
+public:
+    // Mapea el archivo; lanza std::runtime_error si no se puede abrir
+    explicit CargadorEscenarios(const std::string& archivo);
+    ~CargadorEscenarios();
+
+    CargadorEscenarios(const CargadorEscenarios&) = delete;
+    CargadorEscenarios& operator=(const CargadorEscenarios&) = delete;
+
+    // Recorre todos los días repartidos en `pool`
+    ResultadoCarga recorrer(PoolBloques& pool, const FuncionDia& procesar, const FuncionEmision& emitir) const;
+
+    size_t bytes() const { return tam_; }
+};
+
+#endif // CARGADOR_ESCENARIOS_HPP
@@ -0,0 +1,277 @@
+#ifndef CUBO_RESULTADOS_HPP
+#define CUBO_RESULTADOS_HPP
+
+#include "calculador_costos.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Cubo de resultados: formato binario denso indexado por patrón. La fila de un
+// ID es id - desde, así que no hay columna de ID ni búsqueda. Cada columna está
+// contigua (alineada a 64 bytes) para recorrerla con lazos vectorizables:
+//
+//   cabecera (4096 bytes)   CabeceraCubo: demanda, costos, versión, offsets
+//   validas                 bitmap, bit (fila % 64) de la palabra fila / 64
+//   costos                  uint32 en centésimas; COSTO_INVALIDO si no hay solución
+//   horas_criticas          uint8
+//   secuencias              9 bytes por fila: 24 estados de 3 bits (hora h en los bits 3h..3h+2)
+//   mascaras                uint32, bit h = hora h prendida (como ResumenAgregado)
+//
+// Son unos 18 bytes por fila: el barrido completo ocupa ~300 MB en lugar de
+// varios GB de CSV. El bitmap se arma al completar el cubo; uno incompleto no
+// se puede abrir para lectura.
+
+constexpr char MAGIA_CUBO[8] = {'M', 'A', 'Q', 'C', 'U', 'B', 'O', '1'};
+constexpr uint32_t VERSION_CUBO = 1;
+constexpr size_t BYTES_CABECERA_CUBO = 4096;
+constexpr size_t BYTES_SECUENCIA_CUBO = 9;
+constexpr uint32_t ESCALA_COSTO_CUBO = 100;
+constexpr uint32_t COSTO_INVALIDO = std::numeric_limits<uint32_t>::max();
+
+struct CabeceraCubo {
+    char magia[8];
+    uint32_t version;
+    uint32_t completo;               // 1 cuando todas las filas están escritas
+    uint32_t desde;                  // Rango de IDs [desde, hasta)
+    uint32_t hasta;
+    uint32_t num_estados;            // Versión de la máquina: 6 estados de 3 bits
+    uint32_t bits_estado;
+    uint32_t escala_costo;           // Costos enteros: costo * escala_costo
+    uint32_t relleno;
+    double demanda[24];
+    double energia_eolica;           // Energía de cada hora con viento
+    double costo_frio;               // Como CalculadorCostos::configurarCostos
+    double costo_tibio;
+    double costo_caliente;
+    char version_maquina[128];
+    uint64_t offset_validas;
+    uint64_t offset_costos;
+    uint64_t offset_horas;
+    uint64_t offset_secuencias;
+    uint64_t offset_mascaras;
+    uint64_t bytes_totales;
+};
+static_assert(sizeof(CabeceraCubo) <= BYTES_CABECERA_CUBO, "La cabecera del cubo no entra en su bloque");
+
+namespace cubo_detalle {
+inline uint64_t alinear64(uint64_t offset) {
+    return (offset + 63) & ~uint64_t(63);
+}
+}
+
+// Cabecera completa (con offsets) para un cubo de [desde, hasta); el resto en cero
+inline CabeceraCubo crearCabeceraCubo(uint32_t desde, uint32_t hasta, const std::vector<double>& demanda,
+                                      double energia_eolica, double costo_frio, double costo_tibio,
+                                      double costo_caliente) {
+    if (desde >= hasta || demanda.size() != 24) {
+        throw std::invalid_argument("Cubo de resultados: rango vacío o demanda sin 24 valores");
+    }
+    CabeceraCubo cabecera;
+    std::memset(&cabecera, 0, sizeof(cabecera));
+    std::memcpy(cabecera.magia, MAGIA_CUBO, sizeof(MAGIA_CUBO));
+    cabecera.version = VERSION_CUBO;
+    cabecera.desde = desde;
+    cabecera.hasta = hasta;
+    cabecera.num_estados = 6;
+    cabecera.bits_estado = 3;
+    cabecera.escala_costo = ESCALA_COSTO_CUBO;
+    for (int h = 0; h < 24; h++) {
+        cabecera.demanda[h] = demanda[h];
+    }
+    cabecera.energia_eolica = energia_eolica;
+    cabecera.costo_frio = costo_frio;
+    cabecera.costo_tibio = costo_tibio;
+    cabecera.costo_caliente = costo_caliente;
+    std::strncpy(cabecera.version_maquina,
+                 "maquina_estados v1: ON_CALIENTE,OFF_CALIENTE,ON_TIBIO,OFF_TIBIO,ON_FRIO,OFF_FRIO",
+                 sizeof(cabecera.version_maquina) - 1);
+
+    uint64_t filas = hasta - desde;
+    uint64_t offset = BYTES_CABECERA_CUBO;
+    cabecera.offset_validas = offset;
+    offset = cubo_detalle::alinear64(offset + (filas + 63) / 64 * 8);
+    cabecera.offset_costos = offset;
+    offset = cubo_detalle::alinear64(offset + filas * 4);
+    cabecera.offset_horas = offset;
+    offset = cubo_detalle::alinear64(offset + filas);
+    cabecera.offset_secuencias = offset;
+    offset = cubo_detalle::alinear64(offset + filas * BYTES_SECUENCIA_CUBO);
+    cabecera.offset_mascaras = offset;
+    cabecera.bytes_totales = cubo_detalle::alinear64(offset + filas * 4);
+    return cabecera;
+}
+
+// Los IDs del cubo son los del analizador exhaustivo (bit h = hora h con
+// viento); los demos y analizador_individual usan hora 0 = bit 23. Invertir los
+// 24 bits pasa de una convención a la otra.
+inline uint32_t invertirPatron24(uint32_t patron) {
+    uint32_t invertido = 0;
+    for (int bit = 0; bit < 24; bit++) {
+        invertido |= ((patron >> bit) & 1u) << (23 - bit);
+    }
+    return invertido;
+}
+
+// Estados de una fila <-> 9 bytes (24 x 3 bits); `destino` debe venir en cero
+inline void empaquetarSecuencia(const std::vector<EstadoMaquina>& estados, uint8_t* destino) {
+    for (size_t hora = 0; hora < estados.size() && hora < 24; hora++) {
+        unsigned valor = static_cast<unsigned>(estados[hora]);
+        size_t bit = hora * 3;
+        destino[bit / 8] |= static_cast<uint8_t>(valor << (bit % 8));
+        if (bit % 8 > 5) {
+            destino[bit / 8 + 1] |= static_cast<uint8_t>(valor >> (8 - bit % 8));
+        }
+    }
+}
+
+inline EstadoMaquina estadoEmpaquetado(const uint8_t* secuencia, int hora) {
+    size_t bit = static_cast<size_t>(hora) * 3;
+    unsigned valor = secuencia[bit / 8] >> (bit % 8);
+    if (bit % 8 > 5) {
+        valor |= static_cast<unsigned>(secuencia[bit / 8 + 1]) << (8 - bit % 8);
+    }
+    return static_cast<EstadoMaquina>(valor & 7u);
+}
+
+// Lector del cubo: mapea el archivo entero y da acceso O(1) por ID de patrón.
+// No copia nada; las columnas se pueden recorrer directamente.
+class CuboResultados {
+private:
+    std::string archivo_;
+    const uint8_t* datos_;
+    size_t tam_;
+    const CabeceraCubo* cabecera_;
+
+    size_t fila(uint32_t id) const { return id - cabecera_->desde; }
+
+public:
+    // Lanza std::runtime_error si no existe, no es un cubo, está incompleto o truncado
+    explicit CuboResultados(const std::string& archivo) : archivo_(archivo), datos_(nullptr), tam_(0), cabecera_(nullptr) {
+        int fd = open(archivo.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("No se pudo abrir el cubo: " + archivo);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < BYTES_CABECERA_CUBO) {
+            close(fd);
+            throw std::runtime_error("Cubo vacío o ilegible: " + archivo);
+        }
+        tam_ = static_cast<size_t>(info.st_size);
+        void* mapa = mmap(nullptr, tam_, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapa == MAP_FAILED) {
+            throw std::runtime_error("No se pudo mapear el cubo: " + archivo);
+        }
+        datos_ = static_cast<const uint8_t*>(mapa);
+        cabecera_ = reinterpret_cast<const CabeceraCubo*>(datos_);
+
+        const char* error = nullptr;
+        if (std::memcmp(cabecera_->magia, MAGIA_CUBO, sizeof(MAGIA_CUBO)) != 0) {
+            error = "No es un cubo de resultados: ";
+        } else if (cabecera_->version != VERSION_CUBO || cabecera_->num_estados != 6 || cabecera_->bits_estado != 3) {
+            error = "Cubo de una versión incompatible: ";
+        } else if (cabecera_->completo != 1) {
+            error = "El cubo está incompleto (su análisis no terminó): ";
+        } else if (cabecera_->desde >= cabecera_->hasta || cabecera_->bytes_totales != tam_ ||
+                   cabecera_->offset_mascaras + uint64_t(cabecera_->hasta - cabecera_->desde) * 4 > tam_) {
+            error = "Cubo truncado o con offsets inválidos: ";
+        }
+        if (error) {
+            munmap(const_cast<uint8_t*>(datos_), tam_);
+            throw std::runtime_error(error + archivo);
+        }
+    }
+
+    ~CuboResultados() {
+        munmap(const_cast<uint8_t*>(datos_), tam_);
+    }
+
+    CuboResultados(const CuboResultados&) = delete;
+    CuboResultados& operator=(const CuboResultados&) = delete;
+
+    const std::string& archivo() const { return archivo_; }
+    const CabeceraCubo& cabecera() const { return *cabecera_; }
+    uint32_t desde() const { return cabecera_->desde; }
+    uint32_t hasta() const { return cabecera_->hasta; }
+    uint32_t filas() const { return cabecera_->hasta - cabecera_->desde; }
+    bool contiene(uint32_t id) const { return id >= cabecera_->desde && id < cabecera_->hasta; }
+
+    // true si el cubo se generó con esta demanda, energía eólica y costos; un
+    // cubo de otra configuración no sirve para responder consultas
+    bool mismaConfiguracion(const std::vector<double>& demanda, double energia_eolica, double costo_frio,
+                            double costo_tibio, double costo_caliente) const {
+        if (demanda.size() != 24) {
+            return false;
+        }
+        for (int h = 0; h < 24; h++) {
+            if (cabecera_->demanda[h] != demanda[h]) {
+                return false;
+            }
+        }
+        return cabecera_->energia_eolica == energia_eolica && cabecera_->costo_frio == costo_frio &&
+               cabecera_->costo_tibio == costo_tibio && cabecera_->costo_caliente == costo_caliente;
+    }
+
+    // Columnas completas, indexadas por id - desde()
+    const uint64_t* columnaValidas() const { return reinterpret_cast<const uint64_t*>(datos_ + cabecera_->offset_validas); }
+    const uint32_t* columnaCostos() const { return reinterpret_cast<const uint32_t*>(datos_ + cabecera_->offset_costos); }
+    const uint8_t* columnaHoras() const { return datos_ + cabecera_->offset_horas; }
+    const uint8_t* columnaSecuencias() const { return datos_ + cabecera_->offset_secuencias; }
+    const uint32_t* columnaMascaras() const { return reinterpret_cast<const uint32_t*>(datos_ + cabecera_->offset_mascaras); }
+
+    // Acceso por ID (contiene(id) debe ser verdadero)
+    bool valida(uint32_t id) const {
+        size_t f = fila(id);
+        return (columnaValidas()[f / 64] >> (f % 64)) & 1u;
+    }
+    uint32_t costoCentesimas(uint32_t id) const { return columnaCostos()[fila(id)]; }
+    double costo(uint32_t id) const {
+        uint32_t centesimas = costoCentesimas(id);
+        return centesimas == COSTO_INVALIDO ? std::numeric_limits<double>::infinity()
+                                            : static_cast<double>(centesimas) / cabecera_->escala_costo;
+    }
+    int horasCriticas(uint32_t id) const { return columnaHoras()[fila(id)]; }
+    uint32_t mascaraEncendido(uint32_t id) const { return columnaMascaras()[fila(id)]; }
+    EstadoMaquina estado(uint32_t id, int hora) const {
+        return estadoEmpaquetado(columnaSecuencias() + fila(id) * BYTES_SECUENCIA_CUBO, hora);
+    }
+    std::vector<EstadoMaquina> secuencia(uint32_t id) const {
+        std::vector<EstadoMaquina> estados(24);
+        const uint8_t* empaquetada = columnaSecuencias() + fila(id) * BYTES_SECUENCIA_CUBO;
+        for (int hora = 0; hora < 24; hora++) {
+            estados[hora] = estadoEmpaquetado(empaquetada, hora);
+        }
+        return estados;
+    }
+
+    // Recorridos de columna completa
+    uint64_t contarValidas() const {
+        const uint64_t* palabras = columnaValidas();
+        size_t num_palabras = (static_cast<size_t>(filas()) + 63) / 64;
+        uint64_t total = 0;
+        for (size_t i = 0; i < num_palabras; i++) {
+            total += static_cast<uint64_t>(__builtin_popcountll(palabras[i]));
+        }
+        return total;
+    }
+    // Mínimo en centésimas (COSTO_INVALIDO si no hay ninguna válida): el
+    // centinela es el máximo de uint32, así que no hace falta mirar el bitmap
+    uint32_t costoMinimo() const {
+        const uint32_t* columna = columnaCostos();
+        uint32_t minimo = COSTO_INVALIDO;
+        for (size_t i = 0, n = filas(); i < n; i++) {
+            minimo = columna[i] < minimo ? columna[i] : minimo;
+        }
+        return minimo;
+    }
+};
+
+#endif // CUBO_RESULTADOS_HPP
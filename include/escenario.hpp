@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 
 class Escenario {
 private:
@@ -32,4 +33,12 @@ public:
     void setEnergiaOtrasFuentes(int hora, double valor);
 };
 
+// Separador entre valores de una línea de parámetros (el '\n' separa líneas)
+bool esEspacio(char c);
+
+// Lee los 24 valores de una línea separados por espacios; si falta o sobra
+// alguno, no es un número o es negativo, devuelve false y describe el
+// problema en `error`
+bool leerValoresHora(std::string_view linea, double valores[24], std::string& error);
+
 #endif // ESCENARIO_HPP
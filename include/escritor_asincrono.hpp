@@ -0,0 +1,79 @@
+#ifndef ESCRITOR_ASINCRONO_HPP
+#define ESCRITOR_ASINCRONO_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Escritor de resultados con un hilo de E/S propio. El productor llena buffers
+// grandes en memoria y el hilo los escribe en orden con una sola llamada cada
+// uno, así formatear y resolver no esperan al disco. La cantidad de buffers en
+// vuelo está acotada: si el disco no da abasto, el productor espera
+// (contrapresión). El flush del stream se hace cada tantos bytes o segundos, y
+// vaciar() deja todo escrito antes de tocar el stream (checkpoint, fin).
+class EscritorAsincrono {
+public:
+    struct Config {
+        size_t tam_buffer;                          // Bytes por buffer antes de pasarlo al hilo
+        size_t max_buffers;                         // Buffers en vuelo, incluido el que se llena (>= 2)
+        size_t bytes_flush;                         // Hacer flush cada tantos bytes escritos
+        std::chrono::milliseconds intervalo_flush;  // ... o cada tanto tiempo con datos pendientes
+
+        Config() : tam_buffer(4u << 20), max_buffers(4), bytes_flush(64u << 20),
+                   intervalo_flush(std::chrono::seconds(2)) {}
+    };
+
+private:
+    std::ostream& salida_;
+    Config config_;
+
+    std::string actual_;                       // Buffer que llena el productor
+    std::chrono::steady_clock::time_point ultima_entrega_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_trabajo_;       // Avisa al hilo de E/S
+    std::condition_variable cv_espacio_;       // Avisa al productor
+    std::deque<std::string> pendientes_;       // Llenos, en orden de escritura
+    std::vector<std::string> libres_;          // Ya escritos, para reutilizar su capacidad
+    bool escribiendo_;
+    bool pedido_flush_;
+    bool terminar_;
+    std::exception_ptr error_;
+    uint64_t bytes_entregados_;
+    std::thread hilo_;
+
+    void hiloEscritura();
+    void entregarActual();
+    void encolar(std::string&& buffer);
+    void relanzarError();
+
+public:
+    explicit EscritorAsincrono(std::ostream& salida, const Config& config = Config());
+    ~EscritorAsincrono();   // Escribe lo pendiente; los errores a esta altura se pierden
+
+    EscritorAsincrono(const EscritorAsincrono&) = delete;
+    EscritorAsincrono& operator=(const EscritorAsincrono&) = delete;
+
+    // Agregar datos al buffer en curso
+    void escribir(const char* datos, size_t bytes);
+    void escribir(const std::string& datos) { escribir(datos.data(), datos.size()); }
+
+    // Pasar un buffer ya formateado sin copiarlo (p. ej. la salida de un bloque)
+    void entregar(std::string&& buffer);
+
+    // Esperar a que todo lo entregado esté escrito y hacer flush del stream.
+    // Lanza std::runtime_error si alguna escritura falló.
+    void vaciar();
+
+    uint64_t bytesEntregados() const { return bytes_entregados_; }
+};
+
+#endif // ESCRITOR_ASINCRONO_HPP
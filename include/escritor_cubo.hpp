@@ -0,0 +1,43 @@
+#ifndef ESCRITOR_CUBO_HPP
+#define ESCRITOR_CUBO_HPP
+
+#include "cubo_resultados.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Escribe un cubo de resultados (ver cubo_resultados.hpp). El archivo se crea
+// con su tamaño final y se mapea: cada fila va directo a su posición, así que
+// varios hilos pueden registrar IDs distintos sin coordinarse y sin orden.
+class EscritorCubo {
+private:
+    std::string archivo_;
+    uint8_t* datos_;
+    size_t tam_;
+    CabeceraCubo* cabecera_;
+
+public:
+    // Crea (o trunca) el archivo para la cabecera dada. Con `reanudar` abre
+    // uno incompleto ya existente y verifica que tenga la misma cabecera.
+    // Lanza std::runtime_error si no se puede.
+    EscritorCubo(const std::string& archivo, const CabeceraCubo& cabecera, bool reanudar = false);
+    ~EscritorCubo();
+
+    EscritorCubo(const EscritorCubo&) = delete;
+    EscritorCubo& operator=(const EscritorCubo&) = delete;
+
+    const std::string& archivo() const { return archivo_; }
+
+    // Escribir la fila de `id`; seguro desde varios hilos para IDs distintos
+    void registrar(uint32_t id, bool solucion_valida, double costo_total, int horas_criticas,
+                   const std::vector<EstadoMaquina>& estados, uint32_t mascara_encendido);
+
+    // Bajar a disco lo escrito hasta ahora (checkpoints)
+    void sincronizar();
+
+    // Armar el bitmap de válidas, marcar el cubo completo y sincronizar
+    void completar();
+};
+
+#endif // ESCRITOR_CUBO_HPP
@@ -0,0 +1,133 @@
+#ifndef FORMATO_COLUMNAR_HPP
+#define FORMATO_COLUMNAR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Formato columnar comprimido para archivar resultados de barridos. Acepta los
+// CSV de los demos masivos (columna Transiciones) y del analizador exhaustivo
+// (SecuenciaEstados) y los reconstruye byte a byte.
+//
+//   CabeceraColumnar + cabecera CSV original
+//   bloques de N filas, comprimidos cada uno por separado
+//   directorio: un EstadisticasBloque por bloque
+//
+// Dentro de un bloque los IDs son implícitos si son consecutivos (si no, van
+// como deltas), PatronEolica no se guarda (se deriva del ID), costos y
+// transiciones/secuencias usan un diccionario propio del bloque con códigos
+// empaquetados en los bits justos, y SolucionValida y HorasCriticas van
+// empaquetadas en 1 y 5 bits. Los bloques se codifican y comprimen en
+// paralelo; el directorio tiene mínimos y máximos para saltear bloques al
+// filtrar sin descomprimirlos.
+
+constexpr char MAGIA_COLUMNAR[8] = {'M', 'A', 'Q', 'C', 'O', 'L', '0', '1'};
+constexpr uint32_t VERSION_COLUMNAR = 1;
+
+enum class CompresionColumnar : uint32_t {
+    NINGUNA = 0,
+    ZLIB = 1,     // Compilado con -DUSAR_ZLIB (-lz)
+    ZSTD = 2      // Compilado con -DUSAR_ZSTD (-lzstd)
+};
+
+struct CabeceraColumnar {
+    char magia[8];
+    uint32_t version;
+    uint32_t compresion;           // CompresionColumnar
+    uint32_t filas_por_bloque;
+    uint32_t num_bloques;
+    uint64_t filas;
+    uint64_t offset_directorio;    // 0 mientras se escribe: archivo incompleto
+    uint32_t bytes_columnas;       // Largo de la cabecera CSV que sigue
+    uint32_t relleno;
+};
+
+// Entrada del directorio. Los extremos de costo son solo de filas válidas
+// (+inf / -inf si no hay ninguna).
+struct EstadisticasBloque {
+    uint64_t offset;
+    uint32_t bytes_comprimidos;
+    uint32_t bytes_datos;          // Largo descomprimido
+    uint32_t filas;
+    uint32_t validas;
+    uint32_t id_min;
+    uint32_t id_max;
+    double costo_min;
+    double costo_max;
+    uint8_t horas_min;
+    uint8_t horas_max;
+    uint8_t relleno[6];
+};
+
+// Un bloque decodificado; cada fila se reconstruye con sus diccionarios
+struct BloqueColumnar {
+    std::vector<uint32_t> ids;
+    std::vector<std::string> costos;           // Diccionario, en orden numérico
+    std::vector<uint32_t> codigos_costo;
+    std::vector<uint8_t> validas;
+    std::vector<uint8_t> horas_criticas;
+    std::vector<std::string> textos;           // Transiciones o secuencias
+    std::vector<uint32_t> codigos_texto;
+
+    size_t filas() const { return ids.size(); }
+    double costo(size_t fila) const;
+    // Fila tal como estaba en el CSV, agregada al final de `salida`
+    void agregarFilaCsv(size_t fila, std::string& salida) const;
+};
+
+struct OpcionesColumnar {
+    unsigned num_hilos;            // 0 = todos los núcleos
+    uint32_t filas_por_bloque;
+    CompresionColumnar compresion;
+
+    OpcionesColumnar();            // La mejor compresión compilada
+};
+
+struct ResultadoColumnar {
+    uint64_t filas;
+    uint32_t bloques;
+    uint64_t bytes_entrada;
+    uint64_t bytes_salida;
+};
+
+// La mejor compresión disponible en este binario y su nombre
+CompresionColumnar compresionDisponible();
+const char* nombreCompresion(CompresionColumnar compresion);
+
+// CSV de resultados -> archivo columnar. Lanza std::runtime_error si el CSV
+// no tiene el formato esperado o no se puede escribir la salida.
+ResultadoColumnar comprimirResultados(const std::string& csv, const std::string& salida,
+                                      const OpcionesColumnar& opciones);
+
+// Archivo columnar -> el CSV original
+ResultadoColumnar descomprimirResultados(const std::string& archivo, const std::string& csv, unsigned num_hilos);
+
+// Archivo columnar abierto con mmap; los bloques se decodifican a pedido
+class ArchivoColumnar {
+private:
+    std::string archivo_;
+    const uint8_t* datos_;
+    size_t tam_;
+    CabeceraColumnar cabecera_;
+    std::string columnas_;
+    std::vector<EstadisticasBloque> bloques_;
+
+public:
+    // Lanza std::runtime_error si no es un archivo columnar completo y válido
+    explicit ArchivoColumnar(const std::string& archivo);
+    ~ArchivoColumnar();
+
+    ArchivoColumnar(const ArchivoColumnar&) = delete;
+    ArchivoColumnar& operator=(const ArchivoColumnar&) = delete;
+
+    const CabeceraColumnar& cabecera() const { return cabecera_; }
+    const std::string& columnas() const { return columnas_; }
+    const std::vector<EstadisticasBloque>& bloques() const { return bloques_; }
+    uint64_t bytes() const { return tam_; }
+
+    // Descomprime y decodifica el bloque `indice` (seguro desde varios hilos)
+    BloqueColumnar leerBloque(size_t indice) const;
+};
+
+#endif // FORMATO_COLUMNAR_HPP
@@ -0,0 +1,51 @@
+#ifndef FORMATO_CSV_HPP
+#define FORMATO_CSV_HPP
+
+#include "calculador_costos.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Formato de filas CSV sin asignaciones: cada función escribe en un buffer de
+// bytes a partir de `p` y devuelve el puntero al final. El resultado es byte a
+// byte el mismo que daban operator<< de std::bitset<24>, std::fixed con
+// setprecision(2), los nombres de estado y las cadenas de transiciones.
+
+// Espacio que alcanza para cualquier fila (costo de hasta 309 dígitos y 24
+// nombres de estado de 12 caracteres)
+constexpr size_t MAX_FILA_CSV = 1024;
+
+char* escribirEnteroCsv(char* p, uint64_t valor);
+
+// Los 24 bits de `combinacion`, del 23 al 0 (como std::bitset<24>)
+char* escribirPatronCsv(char* p, uint32_t combinacion);
+
+// Costo con dos decimales (como std::fixed << std::setprecision(2))
+char* escribirCostoCsv(char* p, double costo);
+
+// Nombre del estado ("ON_CALIENTE", ...) sin construir std::string
+const char* nombreEstado(EstadoMaquina estado);
+char* escribirEstadoCsv(char* p, EstadoMaquina estado);
+
+// Secuencia de estados separada por '-'
+char* escribirSecuenciaCsv(char* p, const std::vector<EstadoMaquina>& estados);
+
+// Horas de prender/apagar ("0-7-18-23") a partir de la máscara de horas
+// prendidas (bit h = hora h); vacío si nunca se prende
+char* escribirTransicionesCsv(char* p, uint32_t mascara_encendido);
+
+// Fila completa de los demos masivos:
+// CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,Transiciones
+char* escribirFilaTransicionesCsv(char* p, uint32_t combinacion, double costo_total, bool solucion_valida,
+                                  int horas_criticas, uint32_t mascara_encendido);
+
+// Igual que la anterior, agregada al final de `destino`
+void agregarFilaTransicionesCsv(std::string& destino, uint32_t combinacion, double costo_total,
+                                bool solucion_valida, int horas_criticas, uint32_t mascara_encendido);
+
+// Fila del analizador exhaustivo (la última columna es SecuenciaEstados)
+char* escribirFilaSecuenciaCsv(char* p, uint32_t combinacion, double costo_total, bool solucion_valida,
+                               int horas_criticas, const std::vector<EstadoMaquina>& estados);
+
+#endif // FORMATO_CSV_HPP
@@ -0,0 +1,229 @@
+#ifndef INDICE_RESULTADOS_HPP
+#define INDICE_RESULTADOS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Índices secundarios sobre un barrido terminado (CSV de resultados o cubo),
+// guardados junto a él como <archivo>.idx. Cada índice es una permutación de
+// las filas ordenada por clave, con la lista de filas de cada clave contigua:
+//
+//   cabecera (4096 bytes)   CabeceraIndice: origen, tablas, offsets
+//   por cada índice         claves (uint32, crecientes), inicios (uint64,
+//                           num_claves + 1) y filas (uint32, crecientes dentro de cada clave)
+//   ids                     uint32 por fila: CombinacionID
+//   posiciones              uint64 por fila: byte donde empieza la línea (solo CSV)
+//
+// Claves: costo en centésimas, firma de transiciones (mascaraCanonica de las
+// horas prendidas) y horas críticas. Las filas sin solución válida solo están en
+// el índice de horas críticas. Una búsqueda es una búsqueda binaria sobre las
+// claves; un rango de claves es un solo tramo contiguo de filas.
+
+constexpr char MAGIA_INDICE[8] = {'M', 'A', 'Q', 'I', 'D', 'X', '0', '1'};
+constexpr uint32_t VERSION_INDICE = 1;
+constexpr size_t BYTES_CABECERA_INDICE = 4096;
+constexpr uint32_t ESCALA_COSTO_INDICE = 100;
+
+enum class ClaveIndice : uint32_t {
+    COSTO = 0,
+    TRANSICIONES = 1,
+    HORAS_CRITICAS = 2
+};
+constexpr uint32_t NUM_CLAVES_INDICE = 3;
+
+enum class OrigenIndice : uint32_t {
+    CSV = 0,
+    CUBO = 1
+};
+
+struct TablaIndice {
+    uint64_t offset_claves;
+    uint64_t offset_inicios;
+    uint64_t offset_filas;
+    uint32_t num_claves;
+    uint32_t num_filas;
+};
+
+struct CabeceraIndice {
+    char magia[8];
+    uint32_t version;
+    uint32_t origen;                 // OrigenIndice
+    uint64_t filas;
+    uint64_t bytes_origen;           // Tamaño y fecha del origen al indexarlo,
+    int64_t modificacion_origen;     // para detectar índices desactualizados (ns)
+    uint32_t escala_costo;
+    uint32_t relleno;
+    char archivo_origen[256];        // Nombre (sin directorio) del origen
+    char columnas[256];              // Cabecera CSV de las filas
+    TablaIndice tablas[NUM_CLAVES_INDICE];
+    uint64_t offset_ids;
+    uint64_t offset_posiciones;      // 0 si el origen es un cubo
+    uint64_t bytes_totales;
+};
+static_assert(sizeof(CabeceraIndice) <= BYTES_CABECERA_INDICE, "La cabecera del índice no entra en su bloque");
+
+struct ResultadoIndice {
+    uint64_t filas;
+    uint64_t validas;
+    uint32_t claves[NUM_CLAVES_INDICE];
+    uint64_t bytes;
+};
+
+// Indexa `origen` (CSV de resultados o cubo) en `destino`; lanza
+// std::invalid_argument si el origen no se puede indexar y std::runtime_error
+// ante errores de E/S
+ResultadoIndice construirIndice(const std::string& origen, const std::string& destino, unsigned num_hilos = 0);
+
+// Clave de costo de un valor en pesos (redondeo a centésimas, como el cubo)
+inline uint32_t claveCosto(double costo) {
+    return static_cast<uint32_t>(std::llround(costo * ESCALA_COSTO_INDICE));
+}
+
+// Filas de una búsqueda: tramo del índice mapeado, en orden de archivo si es una sola clave
+struct ListaFilas {
+    const uint32_t* inicio;
+    const uint32_t* fin;
+
+    const uint32_t* begin() const { return inicio; }
+    const uint32_t* end() const { return fin; }
+    size_t size() const { return static_cast<size_t>(fin - inicio); }
+    bool empty() const { return inicio == fin; }
+};
+
+// Lector del índice: mapea el archivo y responde sin copiar nada
+class IndiceResultados {
+private:
+    std::string archivo_;
+    const uint8_t* datos_;
+    size_t tam_;
+    const CabeceraIndice* cabecera_;
+
+    const TablaIndice& tabla(ClaveIndice clave) const { return cabecera_->tablas[static_cast<uint32_t>(clave)]; }
+    const uint32_t* claves(ClaveIndice clave) const {
+        return reinterpret_cast<const uint32_t*>(datos_ + tabla(clave).offset_claves);
+    }
+    const uint64_t* inicios(ClaveIndice clave) const {
+        return reinterpret_cast<const uint64_t*>(datos_ + tabla(clave).offset_inicios);
+    }
+    ListaFilas tramo(ClaveIndice clave, size_t desde, size_t hasta) const {
+        const uint32_t* filas = reinterpret_cast<const uint32_t*>(datos_ + tabla(clave).offset_filas);
+        return ListaFilas{filas + inicios(clave)[desde], filas + inicios(clave)[hasta]};
+    }
+
+public:
+    // Lanza std::runtime_error si no existe, no es un índice o está truncado
+    explicit IndiceResultados(const std::string& archivo) : archivo_(archivo), datos_(nullptr), tam_(0), cabecera_(nullptr) {
+        int fd = open(archivo.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("No se pudo abrir el índice: " + archivo);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < BYTES_CABECERA_INDICE) {
+            close(fd);
+            throw std::runtime_error("Índice vacío o ilegible: " + archivo);
+        }
+        tam_ = static_cast<size_t>(info.st_size);
+        void* mapa = mmap(nullptr, tam_, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapa == MAP_FAILED) {
+            throw std::runtime_error("No se pudo mapear el índice: " + archivo);
+        }
+        datos_ = static_cast<const uint8_t*>(mapa);
+        cabecera_ = reinterpret_cast<const CabeceraIndice*>(datos_);
+
+        const char* error = nullptr;
+        if (std::memcmp(cabecera_->magia, MAGIA_INDICE, sizeof(MAGIA_INDICE)) != 0) {
+            error = "No es un índice de resultados: ";
+        } else if (cabecera_->version != VERSION_INDICE || cabecera_->escala_costo != ESCALA_COSTO_INDICE) {
+            error = "Índice de una versión incompatible: ";
+        } else if (cabecera_->bytes_totales != tam_ || cabecera_->offset_ids + cabecera_->filas * 4 > tam_ ||
+                   cabecera_->offset_posiciones + (cabecera_->offset_posiciones ? cabecera_->filas * 8 : 0) > tam_) {
+            error = "Índice truncado o con offsets inválidos: ";
+        }
+        for (uint32_t t = 0; t < NUM_CLAVES_INDICE && !error; t++) {
+            const TablaIndice& tabla = cabecera_->tablas[t];
+            if (tabla.offset_claves + uint64_t(tabla.num_claves) * 4 > tam_ ||
+                tabla.offset_inicios + (uint64_t(tabla.num_claves) + 1) * 8 > tam_ ||
+                tabla.offset_filas + uint64_t(tabla.num_filas) * 4 > tam_) {
+                error = "Índice truncado o con offsets inválidos: ";
+            }
+        }
+        if (error) {
+            munmap(const_cast<uint8_t*>(datos_), tam_);
+            throw std::runtime_error(error + archivo);
+        }
+    }
+
+    ~IndiceResultados() {
+        munmap(const_cast<uint8_t*>(datos_), tam_);
+    }
+
+    IndiceResultados(const IndiceResultados&) = delete;
+    IndiceResultados& operator=(const IndiceResultados&) = delete;
+
+    const CabeceraIndice& cabecera() const { return *cabecera_; }
+    uint64_t filas() const { return cabecera_->filas; }
+    OrigenIndice origen() const { return static_cast<OrigenIndice>(cabecera_->origen); }
+
+    // Ruta del origen: se busca en el mismo directorio que el índice
+    std::string rutaOrigen() const {
+        size_t barra = archivo_.rfind('/');
+        std::string directorio = barra == std::string::npos ? "" : archivo_.substr(0, barra + 1);
+        return directorio + cabecera_->archivo_origen;
+    }
+
+    // true si el origen cambió desde que se construyó el índice
+    bool desactualizado() const {
+        struct stat info;
+        if (stat(rutaOrigen().c_str(), &info) != 0) {
+            return true;
+        }
+        int64_t modificacion = int64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+        return static_cast<uint64_t>(info.st_size) != cabecera_->bytes_origen ||
+               modificacion != cabecera_->modificacion_origen;
+    }
+
+    // Claves distintas de un índice, en orden creciente
+    uint32_t numClaves(ClaveIndice clave) const { return tabla(clave).num_claves; }
+    uint32_t clave(ClaveIndice clave, uint32_t i) const { return claves(clave)[i]; }
+    ListaFilas filasDeClave(ClaveIndice clave, uint32_t i) const { return tramo(clave, i, i + 1); }
+
+    // Filas con clave == valor
+    ListaFilas buscar(ClaveIndice clave, uint32_t valor) const {
+        const uint32_t* primera = claves(clave);
+        const uint32_t* ultima = primera + numClaves(clave);
+        const uint32_t* encontrada = std::lower_bound(primera, ultima, valor);
+        if (encontrada == ultima || *encontrada != valor) {
+            return tramo(clave, 0, 0);
+        }
+        size_t i = static_cast<size_t>(encontrada - primera);
+        return tramo(clave, i, i + 1);
+    }
+
+    // Filas con desde <= clave <= hasta, agrupadas por clave creciente
+    ListaFilas rango(ClaveIndice clave, uint32_t desde, uint32_t hasta) const {
+        const uint32_t* primera = claves(clave);
+        const uint32_t* ultima = primera + numClaves(clave);
+        size_t i = static_cast<size_t>(std::lower_bound(primera, ultima, desde) - primera);
+        size_t j = static_cast<size_t>(std::upper_bound(primera, ultima, hasta) - primera);
+        return desde > hasta ? tramo(clave, 0, 0) : tramo(clave, i, std::max(i, j));
+    }
+
+    // Datos de una fila
+    uint32_t id(uint32_t fila) const { return reinterpret_cast<const uint32_t*>(datos_ + cabecera_->offset_ids)[fila]; }
+    bool tienePosiciones() const { return cabecera_->offset_posiciones != 0; }
+    uint64_t posicion(uint32_t fila) const {
+        return reinterpret_cast<const uint64_t*>(datos_ + cabecera_->offset_posiciones)[fila];
+    }
+};
+
+#endif // INDICE_RESULTADOS_HPP
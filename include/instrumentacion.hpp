@@ -0,0 +1,76 @@
+#ifndef INSTRUMENTACION_HPP
+#define INSTRUMENTACION_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// Medición de las fases del camino caliente de un barrido: armar el escenario,
+// resolver, reconstruir la secuencia, formatear la fila, acumular resúmenes y
+// escribir. Solo existe si se compila con -DUSAR_INSTRUMENTACION
+// (make ... INSTRUMENTAR=1); sin esa opción MEDIR_FASE no genera código y los
+// reportes no escriben nada.
+//
+// Cada hilo acumula en sus propios contadores el TSC y, si el kernel lo permite
+// (perf_event_open), ciclos, instrucciones, fallos de caché y de predicción de
+// saltos del propio hilo. Las fases anidadas se descuentan de la que las
+// contiene: cada fase suma solo su tiempo propio.
+
+enum class FaseInstrumentada {
+    ESCENARIO,        // Construir el Escenario de una combinación
+    RESOLVER,         // Programación dinámica del solver
+    RECONSTRUCCION,   // Recorrer la memoización para armar la secuencia
+    FORMATO,          // Convertir el resultado en una fila de texto
+    AGREGADO,         // Estadísticas, resumen agregado y cubo
+    ESCRITURA,        // Entregar filas al archivo o al escritor asíncrono
+    NUM_FASES
+};
+
+constexpr int NUM_FASES_INSTRUMENTADAS = static_cast<int>(FaseInstrumentada::NUM_FASES);
+constexpr int NUM_CONTADORES_HARDWARE = 4;   // Ciclos, instrucciones, fallos de caché y de saltos
+
+#ifdef USAR_INSTRUMENTACION
+constexpr bool INSTRUMENTACION_ACTIVA = true;
+#else
+constexpr bool INSTRUMENTACION_ACTIVA = false;
+#endif
+
+// Totales de una fase, sumados entre hilos (y entre procesos en el demo MPI)
+struct TotalesFase {
+    uint64_t llamadas = 0;
+    uint64_t ticks = 0;                                   // TSC (o ns si no hay TSC)
+    uint64_t contadores[NUM_CONTADORES_HARDWARE] = {};
+};
+
+#ifdef USAR_INSTRUMENTACION
+// Alcance que carga a `fase` el tiempo hasta su destrucción
+class AlcanceFase {
+private:
+    int fase_anterior_;
+
+public:
+    explicit AlcanceFase(FaseInstrumentada fase);
+    ~AlcanceFase();
+    AlcanceFase(const AlcanceFase&) = delete;
+    AlcanceFase& operator=(const AlcanceFase&) = delete;
+};
+
+#define MEDIR_FASE_UNIR_(a, b) a##b
+#define MEDIR_FASE_NOMBRE_(linea) MEDIR_FASE_UNIR_(alcance_fase_, linea)
+#define MEDIR_FASE(fase) AlcanceFase MEDIR_FASE_NOMBRE_(__LINE__)(FaseInstrumentada::fase)
+#else
+#define MEDIR_FASE(fase) ((void)0)
+#endif
+
+// Suma de los totales de todos los hilos; llamarla con los hilos de trabajo detenidos
+std::vector<TotalesFase> totalesFases();
+
+// Pone los totales en cero (al empezar un barrido nuevo en el mismo proceso)
+void reiniciarFases();
+
+// Tabla por fase: llamadas, segundos, ns y contadores por escenario. No escribe
+// nada si la instrumentación no se compiló.
+void escribirReporteFases(std::ostream& salida, uint64_t escenarios);
+void escribirReporteFases(std::ostream& salida, const std::vector<TotalesFase>& totales, uint64_t escenarios);
+
+#endif // INSTRUMENTACION_HPP
@@ -0,0 +1,66 @@
+#ifndef LECTOR_RESULTADOS_HPP
+#define LECTOR_RESULTADOS_HPP
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+// Lectura de filas de los CSV de resultados sin asignaciones (std::from_chars
+// sobre el texto mapeado). Entiende las dos variantes de la última columna:
+// Transiciones ("0-7-18-23", demos) y SecuenciaEstados (analizador exhaustivo).
+
+enum class ColumnaTexto {
+    TRANSICIONES,
+    SECUENCIA_ESTADOS
+};
+
+struct FilaResultado {
+    uint32_t combinacion_id;
+    double costo_total;
+    bool solucion_valida;
+    int horas_criticas;
+    uint32_t mascara_encendido;    // Bit h = hora h prendida (como ResumenAgregado)
+    std::string_view texto;        // Última columna tal cual
+};
+
+// Tipo de la última columna según la cabecera; lanza std::runtime_error si la
+// cabecera no es la de un CSV de resultados
+ColumnaTexto columnaTextoDeCabecera(std::string_view cabecera);
+
+// Interpreta una línea (sin '\n'); devuelve false si no tiene el formato esperado
+bool interpretarFilaResultado(std::string_view linea, ColumnaTexto columna, FilaResultado& fila);
+
+// Máscara de horas prendidas a partir de la cadena de transiciones o de la
+// secuencia de estados. transicionesDeMascara(resultado) reproduce la cadena.
+bool mascaraDeTransiciones(std::string_view transiciones, uint32_t& mascara);
+bool mascaraDeSecuencia(std::string_view secuencia, uint32_t& mascara);
+
+// La cadena de transiciones no distingue "prendida hasta la 23" de "se apaga a
+// la 23": devuelve la máscara representativa de la cadena de `mascara`, igual
+// para todas las máscaras que se escriben con la misma cadena
+uint32_t mascaraCanonica(uint32_t mascara);
+
+// Predicados para filtrar filas; los campos sin configurar no filtran
+struct FiltroResultados {
+    double costo_min;
+    double costo_max;
+    int horas_min;
+    int horas_max;
+    bool solo_validas;
+    bool por_transiciones;
+    std::string transiciones;      // Cadena exacta ("" = nunca prendida)
+
+    FiltroResultados() : costo_min(-std::numeric_limits<double>::infinity()),
+                         costo_max(std::numeric_limits<double>::infinity()),
+                         horas_min(0), horas_max(24), solo_validas(false), por_transiciones(false) {}
+
+    // Si hay filtro de costo, las filas inválidas no pasan
+    bool filtraCosto() const {
+        return costo_min != -std::numeric_limits<double>::infinity() ||
+               costo_max != std::numeric_limits<double>::infinity();
+    }
+    bool acepta(bool solucion_valida, double costo_total, int horas_criticas, uint32_t mascara_encendido) const;
+};
+
+#endif // LECTOR_RESULTADOS_HPP
@@ -0,0 +1,131 @@
+#ifndef MAQUINA_H
+#define MAQUINA_H
+
+/*
+ * API en C de libmaquina: el optimizador de la máquina de estados para usar
+ * desde otros programas sin lanzar procesos ni interpretar texto. Todas las
+ * llamadas son por lotes y escriben en memoria del llamador.
+ *
+ * Convenciones:
+ *   - Horas 0..23; una máscara tiene el bit h en 1 para la hora h.
+ *   - Un patrón eólico es una máscara de horas con viento (la convención de
+ *     analisis_exhaustivo y del cubo de resultados).
+ *   - Las funciones que devuelven int dan MAQUINA_OK o un código negativo;
+ *     maquina_ultimo_error() describe el último error del hilo.
+ *   - Un maquina_solver no se modifica al resolver: varios hilos pueden
+ *     usarlo a la vez.
+ *
+ * Compilación: make libmaquina (libmaquina.a y libmaquina.so); enlazar con
+ * -lmaquina -lstdc++ -pthread si se usa la biblioteca estática desde C.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(MAQUINA_COMPILANDO)
+#define MAQUINA_API __attribute__((visibility("default")))
+#else
+#define MAQUINA_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MAQUINA_VERSION_API 1
+
+enum {
+    MAQUINA_OK = 0,
+    MAQUINA_ERROR_ARGUMENTO = -1,   /* Puntero nulo, rango invertido o fuera de 2^24, valores inválidos */
+    MAQUINA_ERROR_INTERNO = -2,     /* Falta de memoria u otra excepción interna */
+    MAQUINA_DETENIDO = 1            /* El callback pidió terminar el recorrido */
+};
+
+/* Estados por hora (mismo orden que EstadoMaquina) */
+enum {
+    MAQUINA_ON_CALIENTE = 0,
+    MAQUINA_OFF_CALIENTE = 1,
+    MAQUINA_ON_TIBIO = 2,
+    MAQUINA_OFF_TIBIO = 3,
+    MAQUINA_ON_FRIO = 4,
+    MAQUINA_OFF_FRIO = 5
+};
+
+typedef struct maquina_solver maquina_solver;
+
+typedef struct {
+    double costo_total;           /* INFINITY si no hay solución */
+    int32_t valida;
+    int32_t horas_criticas;
+    uint32_t mascara_criticas;    /* Horas que requieren generación propia */
+    uint32_t mascara_encendido;   /* Horas prendidas (ON_*) de la solución */
+    uint8_t estados[24];          /* MAQUINA_ON_CALIENTE, ... */
+} maquina_resultado;
+
+typedef struct {
+    double costo;
+    uint32_t patron;
+    uint32_t mascara_encendido;
+    int32_t horas_criticas;
+} maquina_extremo;
+
+#define MAQUINA_K_EXTREMOS 10
+
+typedef struct {
+    uint64_t combinaciones;
+    uint64_t validas;
+    double costo_minimo;          /* 0 si no hay soluciones válidas */
+    double costo_maximo;
+    double costo_promedio;
+    uint64_t por_horas_criticas[25];
+    uint32_t num_baratos;
+    uint32_t num_caros;
+    maquina_extremo baratos[MAQUINA_K_EXTREMOS];   /* Costo ascendente */
+    maquina_extremo caros[MAQUINA_K_EXTREMOS];     /* Costo descendente */
+    uint32_t num_firmas;          /* Firmas de transiciones distintas */
+} maquina_resumen;
+
+/* Devuelve nonzero para cortar el recorrido */
+typedef int (*maquina_funcion_patron)(uint32_t patron, const maquina_resultado* resultado, void* contexto);
+
+MAQUINA_API int maquina_version_api(void);
+
+/* Descripción del último error en este hilo ("" si no hubo) */
+MAQUINA_API const char* maquina_ultimo_error(void);
+
+/*
+ * Crea un solver. `demanda` (24 valores) es la de los patrones eólicos;
+ * NULL usa la demanda fija de los análisis exhaustivos. Costos por hora de
+ * ON/FRIO, ON/TIBIO y ON/CALIENTE. Devuelve NULL ante un error.
+ */
+MAQUINA_API maquina_solver* maquina_crear(const double* demanda, double potencia_eolica,
+                                          double costo_frio, double costo_tibio, double costo_caliente);
+MAQUINA_API void maquina_destruir(maquina_solver* solver);
+
+/* Escenarios reales: demanda y otras_fuentes son n * 24 valores, un día tras otro */
+MAQUINA_API int maquina_resolver_escenarios(const maquina_solver* solver, size_t n, const double* demanda,
+                                            const double* otras_fuentes, maquina_resultado* resultados);
+
+/* Máscaras de horas críticas ya calculadas */
+MAQUINA_API int maquina_resolver_mascaras(const maquina_solver* solver, size_t n, const uint32_t* mascaras_criticas,
+                                          maquina_resultado* resultados);
+
+/* Patrones eólicos [desde, hasta) en un buffer de hasta - desde resultados.
+ * En estas tres funciones un rango vacío (desde == hasta) es válido: no se
+ * resuelve ningún patrón y se devuelve MAQUINA_OK (el resumen queda en cero) */
+MAQUINA_API int maquina_resolver_patrones(const maquina_solver* solver, uint32_t desde, uint32_t hasta,
+                                          maquina_resultado* resultados);
+
+/* Patrones eólicos [desde, hasta) en orden, uno por llamada a `funcion` */
+MAQUINA_API int maquina_recorrer_patrones(const maquina_solver* solver, uint32_t desde, uint32_t hasta,
+                                          maquina_funcion_patron funcion, void* contexto);
+
+/* Resumen de los patrones [desde, hasta) con num_hilos hilos (0 = todos los núcleos) */
+MAQUINA_API int maquina_agregar_patrones(const maquina_solver* solver, uint32_t desde, uint32_t hasta,
+                                         unsigned num_hilos, maquina_resumen* resumen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAQUINA_H */
@@ -0,0 +1,91 @@
+#ifndef POOL_BLOQUES_HPP
+#define POOL_BLOQUES_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Pool de hilos que reparte un rango de IDs en bloques contiguos.
+// Cada hilo tiene su propia cola (reparto cíclico inicial) y, cuando se vacía,
+// roba bloques del final de la cola de otro hilo. Cada bloque escribe su salida
+// en un buffer propio y el hilo que llama a ejecutar() los emite en orden de ID,
+// así el archivo resultante es idéntico al de un recorrido secuencial. Los
+// hilos no se adelantan a la emisión más de una ventana de bloques, así la
+// memoria de las salidas no crece con el rango aunque emitir() sea lento.
+// Con dominios de memoria configurados (topologia.hpp), un hilo sin trabajo
+// vacía primero las colas de su dominio y solo después roba a otro dominio.
+class PoolBloques {
+public:
+    struct Bloque {
+        uint32_t indice;   // Posición del bloque dentro del rango (orden de emisión)
+        uint32_t desde;    // Primer ID del bloque
+        uint32_t hasta;    // Un ID más allá del último
+    };
+
+    // procesar(bloque, hilo, salida): corre en un hilo del pool; `hilo` va de 0 a N-1
+    using FuncionProceso = std::function<void(const Bloque&, unsigned, std::string&)>;
+    // emitir(bloque, salida): corre en el hilo que llamó a ejecutar(), en orden de índice;
+    // puede quedarse con el contenido de `salida` (std::move) para no copiarlo
+    using FuncionEmision = std::function<void(const Bloque&, std::string&)>;
+    // al_iniciar(hilo): corre en cada hilo del pool al arrancar, antes de tomar bloques
+    using FuncionInicio = std::function<void(unsigned)>;
+
+    // Trabajo hecho por los hilos de un dominio, acumulado entre llamadas a ejecutar()
+    struct EstadisticasDominio {
+        unsigned hilos = 0;
+        uint64_t bloques = 0;
+        uint64_t combinaciones = 0;
+        uint64_t robos_locales = 0;    // Bloques robados a otro hilo del mismo dominio
+        uint64_t robos_remotos = 0;    // Bloques robados a un hilo de otro dominio
+        double segundos = 0.0;         // Tiempo dentro de procesar, sumado entre hilos
+    };
+
+private:
+    // Cola de un hilo alineada a línea de caché para evitar falso compartido
+    struct alignas(64) ColaHilo {
+        std::mutex mutex;
+        std::deque<uint32_t> bloques;
+    };
+
+    enum class ResultadoToma { TOMADO, FUERA_DE_VENTANA, AGOTADO };
+
+    unsigned num_hilos_;
+    uint32_t tam_bloque_;
+    uint32_t ventana_;                              // Bloques por delante del próximo a emitir
+    std::vector<std::unique_ptr<ColaHilo>> colas_;
+    std::vector<unsigned> dominio_de_hilo_;
+    std::vector<std::vector<unsigned>> victimas_;   // Orden de robo de cada hilo
+    FuncionInicio al_iniciar_;
+    mutable std::mutex mutex_estadisticas_;
+    std::vector<EstadisticasDominio> estadisticas_;
+
+    // Toma un bloque con índice menor que `limite`
+    ResultadoToma tomarBloque(unsigned hilo, uint64_t limite, uint32_t& indice, unsigned& origen);
+
+public:
+    // Constructor (num_hilos = 0 usa std::thread::hardware_concurrency); la
+    // ventana empieza en 8 bloques por hilo
+    PoolBloques(unsigned num_hilos, uint32_t tam_bloque);
+
+    // Procesa [desde, hasta) y emite los bloques en orden; relanza la primera excepción
+    void ejecutar(uint32_t desde, uint32_t hasta, const FuncionProceso& procesar, const FuncionEmision& emitir);
+
+    // Dominio (0 a D-1) de cada hilo y función de arranque de los hilos (puede ser
+    // nula); lanza std::invalid_argument si no hay un dominio por hilo
+    // Un hilo no toma el bloque i mientras i - próximo_a_emitir >= bloques
+    void configurarVentana(uint32_t bloques);
+
+    void configurarDominios(const std::vector<unsigned>& dominio_de_hilo, FuncionInicio al_iniciar);
+
+    unsigned getNumHilos() const { return num_hilos_; }
+    uint32_t getTamBloque() const { return tam_bloque_; }
+    uint32_t getVentana() const { return ventana_; }
+    unsigned dominioDeHilo(unsigned hilo) const { return dominio_de_hilo_[hilo]; }
+    std::vector<EstadisticasDominio> estadisticasDominios() const;
+};
+
+#endif // POOL_BLOQUES_HPP
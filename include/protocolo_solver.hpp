@@ -0,0 +1,37 @@
+#ifndef PROTOCOLO_SOLVER_HPP
+#define PROTOCOLO_SOLVER_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <unistd.h>
+
+// Protocolo de líneas de servidor_solver. Cada línea de texto es una consulta
+// y recibe exactamente una línea de respuesta, en el mismo orden:
+//
+//   000000000000000011111111          patrón eólico con la demanda fija (hora 0 =
+//                                     bit izquierdo, como analizador_individual)
+//   d0 d1 ... d23 | o0 o1 ... o23     demanda y otras fuentes de un día
+//   ESTADISTICAS                      contadores y latencias del servidor
+//
+// Respuesta: CostoTotal,SolucionValida,HorasCriticas,SecuenciaEstados (las
+// columnas del analizador exhaustivo sin el ID ni el patrón), o "ERROR motivo".
+// Las líneas vacías y las que empiezan con '#' no tienen respuesta.
+
+constexpr const char* RUTA_SOCKET_SOLVER = "/tmp/maquina_estados.sock";
+constexpr const char* CONSULTA_ESTADISTICAS = "ESTADISTICAS";
+constexpr size_t MAX_LINEA_SOLVER = 4096;
+
+// Escribe todo el buffer aunque write() acepte menos; false si el otro extremo se cerró
+inline bool escribirCompleto(int fd, const char* datos, size_t tam) {
+    while (tam > 0) {
+        ssize_t escritos = write(fd, datos, tam);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos <= 0) return false;
+        datos += escritos;
+        tam -= static_cast<size_t>(escritos);
+    }
+    return true;
+}
+
+#endif // PROTOCOLO_SOLVER_HPP
@@ -0,0 +1,96 @@
+#ifndef RESUMEN_AGREGADO_HPP
+#define RESUMEN_AGREGADO_HPP
+
+#include "calculador_costos.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Un patrón de los extremos (más baratos / más caros). Se copia como bytes
+// junto con el resumen: el relleno explícito evita bytes sin inicializar
+struct PatronCosto {
+    double costo;
+    uint32_t combinacion_id;
+    uint32_t mascara_encendido;
+    int32_t horas_criticas;
+    uint32_t relleno = 0;
+};
+static_assert(sizeof(PatronCosto) == 24, "PatronCosto no debe tener relleno implícito");
+
+// Resumen combinable de un barrido de combinaciones: histograma exacto de
+// costos, K más baratos y K más caros, conteo por firma de transiciones y por
+// cantidad de horas críticas. Es de tamaño fijo y sin punteros, así que se
+// puede copiar como bytes (reducción MPI con un operador propio) y dos
+// resúmenes parciales se combinan en cualquier orden con el mismo resultado.
+// La tabla de firmas guarda a lo sumo MAX_FIRMAS máscaras distintas: si hay
+// más, se quedan las de menor prioridadFirma() y el resto cuenta como
+// descartada. Esas máscaras no dependen del orden de registro ni de
+// combinación, y sus cuentas son exactas.
+struct ResumenAgregado {
+    static constexpr int K_EXTREMOS = 10;
+    static constexpr uint32_t MAX_CENTESIMAS = 12000;    // 24 horas a 5.00
+    static constexpr uint32_t BITS_FIRMAS = 12;
+    static constexpr uint32_t CAPACIDAD_FIRMAS = 1u << BITS_FIRMAS;
+    static constexpr uint32_t MAX_FIRMAS = CAPACIDAD_FIRMAS / 4 * 3;   // Carga máxima de la tabla
+    static constexpr uint32_t FIRMA_VACIA = 0xFFFFFFFF;  // Las máscaras usan 24 bits
+
+    // Firma de transiciones: máscara de horas prendidas (bit h = hora h)
+    struct EntradaFirma {
+        uint32_t mascara_encendido;
+        uint32_t relleno;
+        uint64_t cuenta;
+    };
+
+    uint64_t combinaciones;
+    uint64_t soluciones_validas;
+    uint64_t suma_centesimas;          // Suma exacta de costos válidos, en centésimas
+    uint64_t costos_fuera_de_rango;    // Costos válidos por encima de MAX_CENTESIMAS
+
+    uint64_t histograma[MAX_CENTESIMAS + 1];   // Índice = costo en centésimas
+    uint64_t por_horas_criticas[25];
+
+    uint32_t num_baratos;
+    uint32_t num_caros;
+    PatronCosto baratos[K_EXTREMOS];   // Orden (costo, id) ascendente
+    PatronCosto caros[K_EXTREMOS];     // Costo descendente, id ascendente
+
+    EntradaFirma firmas[CAPACIDAD_FIRMAS];     // Tabla hash de direccionamiento abierto
+    uint32_t num_firmas;                       // Entradas ocupadas de `firmas`
+    uint32_t prioridad_maxima;                 // Mayor prioridadFirma() de la tabla
+    uint64_t firmas_descartadas;               // Soluciones cuya máscara no se guardó
+
+    ResumenAgregado() { reiniciar(); }
+
+    void reiniciar();
+
+    // Acumular una combinación; `mascara_encendido` solo se usa si es válida
+    void registrar(uint32_t combinacion_id, bool solucion_valida, double costo_total,
+                   int horas_criticas, uint32_t mascara_encendido);
+
+    // Combinar otro resumen parcial (conmutativo y asociativo)
+    void combinar(const ResumenAgregado& otro);
+
+    // Reporte de texto; `max_firmas` limita la tabla de transiciones
+    void imprimirReporte(std::ostream& salida, size_t max_firmas = 20) const;
+
+    // Máscara de horas prendidas de una secuencia de estados (la versión con
+    // puntero evita copiar a un vector los estados de un arreglo por hora)
+    static uint32_t mascaraEncendido(const std::vector<EstadoMaquina>& estados);
+    static uint32_t mascaraEncendido(const EstadoMaquina* estados, size_t num_horas);
+
+    // Cadena de transiciones prender/apagar ("0-7-18-23"), igual que en los demos
+    static std::string transicionesDeMascara(uint32_t mascara_encendido);
+
+    // Orden total entre máscaras (biyección de 32 bits, sin empates) que
+    // decide cuáles se guardan cuando la tabla se llena
+    static uint32_t prioridadFirma(uint32_t mascara_encendido);
+
+private:
+    static uint32_t posicionFirma(uint32_t mascara_encendido);
+    void agregarFirma(uint32_t mascara_encendido, uint64_t cuenta);
+    void quitarFirmaMaxima();
+    static void insertarExtremo(PatronCosto* lista, uint32_t& cantidad, PatronCosto patron, bool caros);
+};
+
+#endif // RESUMEN_AGREGADO_HPP
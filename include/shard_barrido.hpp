@@ -0,0 +1,80 @@
+#ifndef SHARD_BARRIDO_HPP
+#define SHARD_BARRIDO_HPP
+
+#include "resumen_agregado.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Shard de un barrido: un tramo [desde, hasta) de IDs procesado por un trabajo
+// independiente (p. ej. un elemento de un job array), sin comunicación con los
+// demás. El archivo se describe a sí mismo:
+//
+//   #SHARD maquina_estados v1
+//   clave=valor                  (generador, rango, parámetros, columnas...)
+//   resumen_bytes=N
+//   <N bytes: ResumenAgregado del tramo>
+//   <filas CSV en orden de ID, sin cabecera>
+//
+// La cabecera se escribe al empezar con completo=0 y se reescribe al terminar
+// (mismo largo, filas_bytes tiene ancho fijo), así un shard cortado a la mitad
+// o truncado después se reconoce al fusionar.
+struct MetadatosShard {
+    std::string generador;                        // Programa que escribió las filas
+    std::string columnas;                         // Cabecera CSV de las filas
+    uint32_t indice;                              // i de --shard i/N
+    uint32_t total_shards;                        // N (1 con un rango explícito)
+    uint32_t desde;
+    uint32_t hasta;
+    std::map<std::string, std::string> parametros;   // Demanda, costos, filtros...
+
+    MetadatosShard() : indice(0), total_shards(1), desde(0), hasta(0) {}
+};
+
+// Interpreta "i/N" (0 <= i < N); lanza std::invalid_argument si no es válido
+void interpretarShard(const std::string& texto, uint32_t& indice, uint32_t& total_shards);
+
+// Tramo i de N partes casi iguales de [0, combinaciones)
+void rangoDeShard(uint32_t combinaciones, uint32_t indice, uint32_t total_shards,
+                  uint32_t& desde, uint32_t& hasta);
+
+// Lista "a,b,c" con los valores tal como los imprime un ostream
+std::string listaValores(const std::vector<double>& valores);
+
+// Escribe la cabecera y el resumen en la posición actual de `salida`;
+// `bytes_filas` es el largo de las filas que siguen (0 mientras no termina)
+void escribirCabeceraShard(std::ostream& salida, const MetadatosShard& metadatos,
+                           const ResumenAgregado& resumen, bool completo, uint64_t bytes_filas);
+
+// Shard abierto con mmap para fusionarlo; las filas se leen sin copiarlas
+class ShardMapeado {
+private:
+    std::string archivo_;
+    const char* datos_;
+    size_t tam_;
+    MetadatosShard metadatos_;
+    bool completo_;
+    std::unique_ptr<ResumenAgregado> resumen_;
+    size_t inicio_filas_;
+
+public:
+    // Lanza std::runtime_error si el archivo no existe o no es un shard
+    explicit ShardMapeado(const std::string& archivo);
+    ~ShardMapeado();
+
+    ShardMapeado(const ShardMapeado&) = delete;
+    ShardMapeado& operator=(const ShardMapeado&) = delete;
+
+    const std::string& archivo() const { return archivo_; }
+    const MetadatosShard& metadatos() const { return metadatos_; }
+    bool completo() const { return completo_; }
+    const ResumenAgregado& resumen() const { return *resumen_; }
+    const char* filas() const { return datos_ + inicio_filas_; }
+    size_t bytesFilas() const { return tam_ - inicio_filas_; }
+};
+
+#endif // SHARD_BARRIDO_HPP
@@ -0,0 +1,125 @@
+#ifndef TELEMETRIA_HPP
+#define TELEMETRIA_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Progreso en vivo de un barrido largo: cada hilo publica sus contadores en su
+// propia ranura y cualquier otro hilo los lee sin bloquearlo. Las métricas se
+// exportan en el formato de texto de Prometheus para un scraper local.
+
+// Contadores de un hilo. Solo los escribe su dueño (carga y guardado relajados,
+// sin operaciones de lectura-modificación-escritura); cualquiera los lee.
+struct alignas(64) RanuraTelemetria {
+    std::atomic<uint64_t> procesadas{0};
+    std::atomic<uint64_t> validas{0};
+    std::atomic<double> mejor_costo{std::numeric_limits<double>::infinity()};
+
+    void registrar(bool valida, double costo) {
+        procesadas.store(procesadas.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (valida) {
+            validas.store(validas.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (costo < mejor_costo.load(std::memory_order_relaxed)) {
+                mejor_costo.store(costo, std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+// Lo que se sabe de una fuente (un hilo, un proceso o el total)
+struct LecturaTelemetria {
+    uint64_t procesadas = 0;
+    uint64_t validas = 0;
+    double mejor_costo = std::numeric_limits<double>::infinity();
+    double tasa = 0.0;                 // Combinaciones por segundo
+
+    void combinar(const LecturaTelemetria& otra);
+};
+
+// Una ranura por hilo de trabajo
+class TelemetriaHilos {
+private:
+    std::unique_ptr<RanuraTelemetria[]> ranuras_;
+    unsigned num_ranuras_;
+
+public:
+    explicit TelemetriaHilos(unsigned num_ranuras);
+
+    RanuraTelemetria& ranura(unsigned hilo) { return ranuras_[hilo]; }
+    unsigned getNumRanuras() const { return num_ranuras_; }
+
+    LecturaTelemetria leer(unsigned hilo) const;
+    LecturaTelemetria leerTotal() const;
+};
+
+// Tasa suavizada (media móvil exponencial) y tiempo restante a partir de
+// lecturas sucesivas del total procesado
+class EstimadorAvance {
+private:
+    using Reloj = std::chrono::steady_clock;
+    Reloj::time_point inicio_;
+    Reloj::time_point ultima_;
+    uint64_t ultimas_procesadas_;
+    double tasa_;
+
+public:
+    EstimadorAvance();
+
+    void reiniciar();
+    void actualizar(uint64_t procesadas);
+    double tasa() const { return tasa_; }
+    double segundos() const;
+    // Segundos hasta completar `total`; negativo mientras no haya tasa (no se
+    // usa infinito: el demo MPI se compila con -ffast-math)
+    double eta(uint64_t procesadas, uint64_t total) const;
+};
+
+// Estado de un barrido para exportar: el total y una serie por fuente
+struct MetricasBarrido {
+    std::string programa;                       // Valor de la etiqueta programa
+    std::string etiqueta_fuente;                // "hilo" o "proceso"
+    uint64_t total = 0;
+    double segundos = 0.0;
+    double eta = 0.0;                           // Negativo = todavía sin estimar
+    LecturaTelemetria global;
+    std::vector<LecturaTelemetria> fuentes;
+};
+
+// Reescribe `ruta` con las métricas en formato de texto de Prometheus. Escribe
+// un temporal en el mismo directorio y lo renombra, así un scraper nunca ve un
+// archivo a medias. Las series sin valor todavía (ETA, mejor costo sin
+// soluciones válidas) se omiten. Devuelve false si no pudo escribirlo.
+bool escribirMetricasPrometheus(const std::string& ruta, const MetricasBarrido& metricas);
+
+// Hilo que cada `intervalo` pide las métricas a `leer` y reescribe el archivo;
+// al destruirse hace una última escritura
+class PublicadorMetricas {
+private:
+    std::string ruta_;
+    std::chrono::milliseconds intervalo_;
+    std::function<MetricasBarrido()> leer_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool terminar_;
+    std::thread hilo_;
+
+    void ciclo();
+
+public:
+    PublicadorMetricas(const std::string& ruta, std::chrono::milliseconds intervalo,
+                       std::function<MetricasBarrido()> leer);
+    ~PublicadorMetricas();
+    PublicadorMetricas(const PublicadorMetricas&) = delete;
+    PublicadorMetricas& operator=(const PublicadorMetricas&) = delete;
+};
+
+#endif // TELEMETRIA_HPP
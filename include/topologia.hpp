@@ -0,0 +1,75 @@
+#ifndef TOPOLOGIA_HPP
+#define TOPOLOGIA_HPP
+
+#include "pool_bloques.hpp"
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Topología de la máquina leída de /sys: qué CPUs tiene cada dominio de
+// memoria (nodo NUMA o, si el kernel no expone nodos, socket físico). Solo
+// cuentan las CPUs de la máscara de afinidad del proceso, así un proceso que
+// el lanzador (mpirun, Slurm) ya ató a un socket ve solo ese socket.
+
+struct DominioMemoria {
+    int id;                      // Número de nodo o de socket según /sys
+    std::vector<int> cpus;       // CPUs permitidas, en orden ascendente
+};
+
+class Topologia {
+private:
+    std::vector<DominioMemoria> dominios_;
+    std::string origen_;         // "nodos NUMA", "sockets" o "sin topología"
+
+public:
+    // Lee `raiz` (normalmente /sys/devices/system); si no encuentra nodos ni
+    // sockets usa un único dominio con todas las CPUs permitidas
+    static Topologia detectar(const std::string& raiz = "/sys/devices/system");
+
+    // La parte `indice` de `total` procesos que comparten la máquina: las CPUs,
+    // ordenadas por dominio, se cortan en tramos contiguos, así con un proceso
+    // por socket cada uno se queda con su socket entero
+    Topologia repartir(unsigned indice, unsigned total) const;
+
+    // CPU y dominio (índice en dominios()) de cada uno de `num_hilos` hilos. Los
+    // hilos se intercalan entre dominios para usar la memoria de todos; con más
+    // hilos que CPUs se vuelve a empezar
+    void asignarHilos(unsigned num_hilos, std::vector<int>& cpus, std::vector<unsigned>& dominios) const;
+
+    const std::vector<DominioMemoria>& dominios() const { return dominios_; }
+    const std::string& origen() const { return origen_; }
+    std::vector<int> cpus() const;
+    // P. ej. "2 nodos NUMA: 0 [0-15] | 1 [16-31]"
+    std::string describir() const;
+};
+
+// "0-3,8" -> {0, 1, 2, 3, 8}; lanza std::invalid_argument si no es una lista válida
+std::vector<int> interpretarListaCpus(const std::string& texto);
+// Inversa de interpretarListaCpus (la lista debe estar ordenada)
+std::string formatearListaCpus(const std::vector<int>& cpus);
+
+// Ata el hilo que llama a `cpus`; devuelve false si el sistema no lo permite
+bool fijarHiloActual(const std::vector<int>& cpus);
+
+// Corre `funcion` en un hilo atado al dominio `dominio` y espera a que termine.
+// Es para la primera escritura: el kernel ubica cada página en el nodo del hilo
+// que la toca primero, así lo que se reserva ahí queda en la memoria del dominio
+void ejecutarEnDominio(const Topologia& topologia, unsigned dominio, const std::function<void()>& funcion);
+
+// Ata cada hilo de `pool` a una CPU de `topologia` y le da su dominio, así los
+// robos vacían primero las colas del mismo dominio
+void aplicarAfinidad(PoolBloques& pool, const Topologia& topologia);
+
+// Rendimiento de un dominio de un proceso (proceso < 0: sin MPI)
+struct RendimientoDominio {
+    int proceso;
+    int dominio;                 // Id del nodo o socket
+    PoolBloques::EstadisticasDominio estadisticas;
+};
+
+std::vector<RendimientoDominio> rendimientoPorDominio(const Topologia& topologia, const PoolBloques& pool,
+                                                      int proceso = -1);
+void imprimirRendimientoDominios(std::ostream& salida, const std::vector<RendimientoDominio>& filas);
+
+#endif // TOPOLOGIA_HPP
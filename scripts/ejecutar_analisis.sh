@@ -7,6 +7,20 @@ echo ""
 # Crear directorio de resultados si no existe
 mkdir -p resultados
 
+# Mover el CSV y su resumen agregado (si se generó) con el mismo nombre base
+guardar_resultados() {
+    mv resultados_demo.csv "resultados/$1.csv"
+    if [ -f resumen_demo.txt ]; then
+        mv resumen_demo.txt "resultados/$1_resumen.txt"
+    fi
+}
+export -f guardar_resultados
+
+# make recompila si cambió cualquier fuente o encabezado de cada programa
+compilar() {
+    make -s "$@" >/dev/null || { echo "❌ Error al compilar $*"; exit 1; }
+}
+
 echo "Opciones de análisis:"
 echo "1. Prueba rápida (1,000 combinaciones) - <1 segundo"
 echo "2. Análisis pequeño (10,000 combinaciones) - <1 segundo"  
@@ -19,6 +33,11 @@ echo ""
 
 read -p "Selecciona una opción (1-7): " opcion
 
+# Las opciones 1 a 6 usan el barrido secuencial (la 7 compila su versión MPI)
+if [ "$opcion" != "7" ]; then
+    compilar demo_analisis_con_transiciones
+fi
+
 case $opcion in
     1)
         echo ""
@@ -32,7 +51,7 @@ case $opcion in
         duracion=$((tiempo_fin - tiempo_inicio))
         echo ""
         echo "✅ Análisis completado en $duracion segundos"
-        mv resultados_demo.csv resultados/analisis_1k_$(date +%Y%m%d_%H%M%S).csv
+        guardar_resultados analisis_1k_$(date +%Y%m%d_%H%M%S)
         ;;
         
     2)
@@ -47,7 +66,7 @@ case $opcion in
         duracion=$((tiempo_fin - tiempo_inicio))
         echo ""
         echo "✅ Análisis completado en $duracion segundos ($((duracion/60))m ${duracion%60}s)"
-        mv resultados_demo.csv resultados/analisis_10k_$(date +%Y%m%d_%H%M%S).csv
+        guardar_resultados analisis_10k_$(date +%Y%m%d_%H%M%S)
         ;;
         
     3)
@@ -62,7 +81,7 @@ case $opcion in
         duracion=$((tiempo_fin - tiempo_inicio))
         echo ""
         echo "✅ Análisis completado en $duracion segundos ($((duracion/60))m ${duracion%60}s)"
-        mv resultados_demo.csv resultados/analisis_100k_$(date +%Y%m%d_%H%M%S).csv
+        guardar_resultados analisis_100k_$(date +%Y%m%d_%H%M%S)
         ;;
         
     4)
@@ -79,7 +98,7 @@ case $opcion in
             duracion=$((tiempo_fin - tiempo_inicio))
             echo ""
             echo "✅ Análisis completado en $duracion segundos ($((duracion/3600))h $((duracion%3600/60))m)"
-            mv resultados_demo.csv resultados/analisis_1M_$(date +%Y%m%d_%H%M%S).csv
+            guardar_resultados analisis_1M_$(date +%Y%m%d_%H%M%S)
         else
             echo "Análisis cancelado"
         fi
@@ -99,6 +118,12 @@ case $opcion in
         echo "- Combinaciones por lote: $chunk_size"
         echo ""
         
+        # Cada lote es un shard con su rango de IDs; al final se fusionan en un solo CSV
+        compilar fusionar_shards
+        
+        fecha=$(date +%Y%m%d_%H%M%S)
+        dir_shards="resultados/shards_$fecha"
+        mkdir -p "$dir_shards"
         tiempo_inicio_total=$(date +%s)
         
         for ((i=0; i<$num_lotes; i++)); do
@@ -110,20 +135,21 @@ case $opcion in
                 current_chunk=$chunk_size
             fi
             
-            echo "📦 LOTE $((i+1))/$num_lotes - Procesando $current_chunk combinaciones"
+            echo "📦 LOTE $((i+1))/$num_lotes - Combinaciones [$start, $((start + current_chunk)))"
             tiempo_lote_inicio=$(date +%s)
             
-            echo "$current_chunk" | ./demo_analisis_con_transiciones
+            ./demo_analisis_con_transiciones --rango $start $((start + current_chunk)) \
+                --salida "$dir_shards/lote_$i.shard" || exit 1
             
             tiempo_lote_fin=$(date +%s)
             duracion_lote=$((tiempo_lote_fin - tiempo_lote_inicio))
             
-            mv resultados_demo.csv resultados/lote_${i}_$(date +%Y%m%d_%H%M%S).csv
-            
             echo "✅ Lote $((i+1)) completado en $duracion_lote segundos"
             echo ""
         done
         
+        ./fusionar_shards "resultados/analisis_lotes_$fecha.csv" "$dir_shards"/lote_*.shard && rm -r "$dir_shards"
+        
         tiempo_fin_total=$(date +%s)
         duracion_total=$((tiempo_fin_total - tiempo_inicio_total))
         echo "🎉 TODOS LOS LOTES COMPLETADOS"
@@ -153,7 +179,7 @@ case $opcion in
                 echo ""
                 echo "ANÁLISIS COMPLETO FINALIZADO"
                 echo "Tiempo total: $duracion segundos ($((duracion/86400))d $((duracion%86400/3600))h)"
-                mv resultados_demo.csv resultados/analisis_completo_$(date +%Y%m%d_%H%M%S).csv
+                guardar_resultados analisis_completo_$(date +%Y%m%d_%H%M%S)
             ' > resultados/analisis_completo.log 2>&1 &
             
             pid=$!
@@ -209,8 +235,23 @@ case $opcion in
         read -p "Número de procesos MPI a usar [$procesos_recomendados]: " num_procesos
         num_procesos=${num_procesos:-$procesos_recomendados}
         
+        # Modo híbrido: un proceso por nodo/socket y varios hilos dentro de cada uno
+        read -p "Hilos por proceso MPI (modo híbrido) [1]: " hilos_por_proceso
+        hilos_por_proceso=${hilos_por_proceso:-1}
+        
+        # Modo resumen: histograma, extremos y firmas de transiciones sin escribir filas
+        read -p "¿Solo resumen agregado, sin CSV de 16.7M filas? (s/N): " solo_resumen
+        opciones_mpi="--hilos $hilos_por_proceso"
+        if [ "$solo_resumen" = "s" ] || [ "$solo_resumen" = "S" ]; then
+            opciones_mpi="$opciones_mpi --solo-resumen"
+        fi
+        # Con varios hilos, atarlos a núcleos por nodo NUMA (solo Linux)
+        if [ $hilos_por_proceso -gt 1 ] && [[ "$OSTYPE" != "darwin"* ]]; then
+            opciones_mpi="$opciones_mpi --afinidad"
+        fi
+        
         # Verificar si vale la pena usar MPI
-        if [ $num_procesos -le 1 ]; then
+        if [ $num_procesos -le 1 ] && [ $hilos_por_proceso -le 1 ]; then
             echo ""
             echo "⚠️  ADVERTENCIA: Con 1 proceso, MPI será más lento que la versión secuencial"
             echo "Se recomienda usar al menos 2 procesos para obtener beneficios de MPI"
@@ -219,13 +260,14 @@ case $opcion in
             if [ "$usar_secuencial" != "n" ] && [ "$usar_secuencial" != "N" ]; then
                 echo ""
                 echo "🚀 EJECUTANDO VERSIÓN SECUENCIAL..."
+                compilar demo_analisis_con_transiciones
                 tiempo_inicio=$(date +%s)
                 echo "16777216" | ./demo_analisis_con_transiciones
                 tiempo_fin=$(date +%s)
                 duracion=$((tiempo_fin - tiempo_inicio))
                 echo ""
                 echo "✅ Análisis secuencial completado en $duracion segundos"
-                mv resultados_demo.csv resultados/analisis_secuencial_$(date +%Y%m%d_%H%M%S).csv
+                guardar_resultados analisis_secuencial_$(date +%Y%m%d_%H%M%S)
                 exit 0
             fi
         fi
@@ -234,40 +276,18 @@ case $opcion in
         read -p "¿Estás COMPLETAMENTE seguro? (escribir 'CONFIRMO'): " confirm
         
         if [ "$confirm" = "CONFIRMO" ]; then
-            # Compilar versión MPI si no existe o está desactualizada
-            if [ ! -f demo_analisis_con_transiciones_mpi ] || [ src/demo_analisis_con_transiciones_mpi.cpp -nt demo_analisis_con_transiciones_mpi ]; then
-                echo ""
-                echo "🔨 Compilando versión MPI optimizada..."
-                mpicxx -std=c++17 -Wall -Wextra -Iinclude -O3 -march=native \
-                       -DNDEBUG -ffast-math \
-                       src/demo_analisis_con_transiciones_mpi.cpp \
-                       src/escenario.cpp \
-                       src/calculador_costos.cpp \
-                       -o demo_analisis_con_transiciones_mpi
-                
-                if [ $? -ne 0 ]; then
-                    echo "❌ Error en la compilación MPI"
-                    exit 1
-                fi
-                echo "✅ Compilación MPI optimizada exitosa"
-            fi
+            # make recompila la versión MPI si cambió cualquiera de sus fuentes o encabezados
+            compilar demo_analisis_con_transiciones_mpi
             
             echo ""
             echo "🚀 INICIANDO ANÁLISIS COMPLETO MPI..."
             echo "Procesos MPI: $num_procesos"
+            echo "Hilos por proceso: $hilos_por_proceso"
             
-            # Calcular distribución óptima de trabajo
-            combinaciones_totales=16777216
-            combinaciones_por_proceso=$((combinaciones_totales / num_procesos))
-            resto=$((combinaciones_totales % num_procesos))
-            
-            echo "Combinaciones por proceso: $combinaciones_por_proceso"
-            if [ $resto -ne 0 ]; then
-                echo "Combinaciones extras en último proceso: $resto"
-            fi
+            echo "Reparto de combinaciones: dinámico por lotes"
             
             # Configurar variables de entorno para optimizar MPI
-            export OMP_NUM_THREADS=1  # Evitar conflictos con OpenMP
+            export OMP_NUM_THREADS=1  # Evitar conflictos con OpenMP (los hilos son del pool propio)
             export MPI_BUFFER_SIZE=1024  # Buffer pequeño para reducir latencia
             
             echo ""
@@ -276,11 +296,14 @@ case $opcion in
             # Usar parámetros optimizados para MPI
             if [[ "$OSTYPE" == "darwin"* ]]; then
                 # macOS - usar configuración simple para mejor compatibilidad
-                echo "16777216" | mpirun -np $num_procesos ./demo_analisis_con_transiciones_mpi 2>/dev/null || \
-                echo "16777216" | mpirun -np $num_procesos ./demo_analisis_con_transiciones_mpi
+                echo "16777216" | mpirun -np $num_procesos ./demo_analisis_con_transiciones_mpi $opciones_mpi 2>/dev/null || \
+                echo "16777216" | mpirun -np $num_procesos ./demo_analisis_con_transiciones_mpi $opciones_mpi
+            elif [ $hilos_por_proceso -gt 1 ]; then
+                # Linux híbrido - reservar un núcleo por hilo para cada proceso
+                echo "16777216" | mpirun -np $num_procesos --map-by slot:PE=$hilos_por_proceso --bind-to core ./demo_analisis_con_transiciones_mpi $opciones_mpi
             else
                 # Linux - usar configuración optimizada
-                echo "16777216" | mpirun -np $num_procesos --bind-to core --map-by core ./demo_analisis_con_transiciones_mpi
+                echo "16777216" | mpirun -np $num_procesos --bind-to core --map-by core ./demo_analisis_con_transiciones_mpi $opciones_mpi
             fi
             
             tiempo_fin=$(date +%s)
@@ -300,7 +323,11 @@ case $opcion in
                 echo "NOTA: Ejecuta primero la opción 6 para obtener speedup real"
             fi
             
-            mv resultados_demo.csv resultados/analisis_mpi_completo_$(date +%Y%m%d_%H%M%S).csv
+            if [ -f resumen_demo.txt ] && [[ "$opciones_mpi" == *--solo-resumen* ]]; then
+                mv resumen_demo.txt resultados/resumen_mpi_completo_$(date +%Y%m%d_%H%M%S).txt
+            else
+                guardar_resultados analisis_mpi_completo_$(date +%Y%m%d_%H%M%S)
+            fi
         else
             echo "Análisis cancelado"
         fi
@@ -323,9 +350,13 @@ echo "   - '0-23': prendida todo el tiempo"
 echo "   - '2-5-8-15': prender h2, apagar h5, prender h8, apagar h15"
 echo ""
 echo "🔍 Comandos útiles para análisis:"
-echo "  # Ver mejores resultados:"
-echo "  sort -t, -k3 -n resultados/archivo.csv | head -10"
-echo ""
-echo "  # Analizar patrones de transiciones:"
+echo "  # Reporte completo (estadísticas, extremos, transiciones):"
 echo "  ./scripts/analizar_resultados.sh resultados/archivo.csv"
 echo ""
+echo "  # Filtrar y guardar filas (p. ej. baratas con 16 horas críticas):"
+echo "  ./analizar_resultados --costo-max 90 --horas-criticas 16-16 --filas baratas.csv resultados/archivo.csv"
+echo ""
+echo "  # Casos que nunca se prenden / con una transición concreta:"
+echo "  ./analizar_resultados --transiciones nunca resultados/archivo.csv"
+echo "  ./analizar_resultados --transiciones 2-5-8-15 resultados/archivo.csv"
+echo ""
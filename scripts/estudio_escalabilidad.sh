@@ -0,0 +1,171 @@
+#!/bin/bash
+
+# Estudio de escalabilidad de demo_analisis_con_transiciones_mpi en una máquina.
+#
+# Corre el barrido con cada combinación de procesos MPI (-p) e hilos por proceso (-t):
+#   - fuerte: el mismo total de combinaciones para todas las configuraciones
+#   - débil:  las mismas combinaciones por trabajador (proceso x hilo)
+# y junta el tiempo total, los tiempos por fase (máximo entre procesos) y la
+# eficiencia paralela respecto de la configuración con menos trabajadores.
+#
+# Uso: scripts/estudio_escalabilidad.sh [opciones]
+#   -p "1 2 4"      procesos MPI a probar (por defecto "1 2 4")
+#   -t "1"          hilos por proceso a probar (por defecto "1")
+#   -n N            combinaciones del modo fuerte (por defecto 1048576)
+#   -w N            combinaciones por trabajador del modo débil (por defecto 262144)
+#   -m modo         fuerte, debil o ambos (por defecto ambos)
+#   -r R            repeticiones por configuración; se queda con la más rápida (por defecto 1)
+#   -s              modo --solo-resumen (sin escribir filas)
+#   -o prefijo      archivos de salida prefijo.csv y prefijo.json
+#                   (por defecto resultados/escalabilidad_<fecha>)
+#
+# Opciones extra de mpirun en MPIRUN_OPCIONES, por ejemplo con Open MPI:
+#   MPIRUN_OPCIONES="--oversubscribe --bind-to none" scripts/estudio_escalabilidad.sh -p "1 2 4 8"
+
+procesos="1 2 4"
+hilos="1"
+combinaciones_fuerte=1048576
+por_trabajador=262144
+modo=ambos
+repeticiones=1
+solo_resumen=""
+prefijo="resultados/escalabilidad_$(date +%Y%m%d_%H%M%S)"
+
+while getopts "p:t:n:w:m:r:so:" opcion; do
+    case $opcion in
+        p) procesos="$OPTARG" ;;
+        t) hilos="$OPTARG" ;;
+        n) combinaciones_fuerte="$OPTARG" ;;
+        w) por_trabajador="$OPTARG" ;;
+        m) modo="$OPTARG" ;;
+        r) repeticiones="$OPTARG" ;;
+        s) solo_resumen="--solo-resumen" ;;
+        o) prefijo="$OPTARG" ;;
+        *) sed -n '3,23p' "$0" | sed 's/^# \{0,1\}//'; exit 1 ;;
+    esac
+done
+
+case $modo in
+    fuerte) modos="fuerte" ;;
+    debil) modos="debil" ;;
+    ambos) modos="fuerte debil" ;;
+    *) echo "❌ ERROR: modo desconocido '$modo' (fuerte, debil o ambos)"; exit 1 ;;
+esac
+
+if ! command -v mpirun &> /dev/null || ! command -v mpicxx &> /dev/null; then
+    echo "❌ ERROR: MPI no está instalado (se necesitan mpirun y mpicxx)"
+    exit 1
+fi
+
+raiz=$(cd "$(dirname "$0")/.." && pwd)
+programa="$raiz/demo_analisis_con_transiciones_mpi"
+
+# make recompila la versión MPI si cambió cualquiera de sus fuentes o encabezados
+(cd "$raiz" && make -s demo_analisis_con_transiciones_mpi >/dev/null) || { echo "❌ Error en la compilación MPI"; exit 1; }
+
+mkdir -p "$(dirname "$prefijo")"
+prefijo=$(cd "$(dirname "$prefijo")" && pwd)/$(basename "$prefijo")
+
+# Cada ejecución corre en un directorio temporal para no pisar resultados_demo.csv
+trabajo=$(mktemp -d)
+trap 'rm -rf "$trabajo"' EXIT
+crudo="$trabajo/tiempos.jsonl"
+
+echo "=== ESTUDIO DE ESCALABILIDAD ==="
+echo "Procesos: $procesos | Hilos por proceso: $hilos | Modos: $modos"
+echo ""
+
+for m in $modos; do
+    for p in $procesos; do
+        for t in $hilos; do
+            trabajadores=$((p * t))
+            if [ "$m" = "fuerte" ]; then
+                n=$combinaciones_fuerte
+            else
+                n=$((por_trabajador * trabajadores))
+            fi
+            if [ $n -gt 16777216 ]; then
+                echo "⚠️  $m p=$p t=$t: $n combinaciones supera 16,777,216, se omite"
+                continue
+            fi
+            for ((r = 1; r <= repeticiones; r++)); do
+                printf "▶ %-6s procesos=%-3s hilos=%-3s combinaciones=%-9s rep %s/%s\n" \
+                       "$m" "$p" "$t" "$n" "$r" "$repeticiones"
+                (cd "$trabajo" && echo "$n" | mpirun $MPIRUN_OPCIONES -np "$p" "$programa" \
+                     --hilos "$t" $solo_resumen --tiempos fase.json > salida.txt 2>&1) || {
+                    echo "❌ Falló la ejecución; últimas líneas:"
+                    tail -5 "$trabajo/salida.txt"
+                    exit 1
+                }
+                sed "s/^{/{\"modo\":\"$m\",\"trabajadores\":$trabajadores,/" "$trabajo/fase.json" >> "$crudo"
+                rm -f "$trabajo/fase.json" "$trabajo/resultados_demo.csv" "$trabajo/resumen_demo.txt"
+            done
+        done
+    done
+done
+
+if [ ! -s "$crudo" ]; then
+    echo "❌ ERROR: no se completó ninguna ejecución"
+    exit 1
+fi
+
+# La mejor repetición de cada configuración y su eficiencia respecto de la
+# configuración con menos trabajadores del mismo modo:
+#   fuerte: speedup = T_base / T,        eficiencia = speedup * w_base / w
+#   débil:  eficiencia = T_base / T,     speedup = eficiencia * w / w_base
+awk -v csv="$prefijo.csv" -v json="$prefijo.json" '
+function campo(linea, nombre,    patron) {
+    patron = "\"" nombre "\":[^,}]*"
+    if (!match(linea, patron)) return ""
+    return substr(linea, RSTART + length(nombre) + 3, RLENGTH - length(nombre) - 3)
+}
+{
+    clave = campo($0, "modo") SUBSEP campo($0, "procesos") SUBSEP campo($0, "hilos")
+    if (!(clave in mejor)) {
+        orden[++num_claves] = clave
+    }
+    if (!(clave in mejor) || campo($0, "total") + 0 < campo(mejor[clave], "total") + 0) {
+        mejor[clave] = $0
+    }
+}
+END {
+    split("calculo espera escritura combinacion reduccion", fases, " ")
+    for (i = 1; i <= num_claves; i++) {
+        linea = mejor[orden[i]]
+        m = campo(linea, "modo"); gsub(/"/, "", m)
+        w = campo(linea, "trabajadores") + 0
+        if (!(m in base_w) || w < base_w[m]) {
+            base_w[m] = w
+            base_t[m] = campo(linea, "total") + 0
+        }
+    }
+    printf "modo,procesos,hilos,trabajadores,combinaciones,total_s" > csv
+    for (f = 1; f <= 5; f++) printf ",%s_s", fases[f] > csv
+    printf ",speedup,eficiencia\n" > csv
+    printf "" > json
+    for (i = 1; i <= num_claves; i++) {
+        linea = mejor[orden[i]]
+        m = campo(linea, "modo"); gsub(/"/, "", m)
+        w = campo(linea, "trabajadores") + 0
+        t = campo(linea, "total") + 0
+        if (m == "fuerte") {
+            speedup = base_t[m] / t
+            eficiencia = speedup * base_w[m] / w
+        } else {
+            eficiencia = base_t[m] / t
+            speedup = eficiencia * w / base_w[m]
+        }
+        printf "%s,%s,%s,%d,%s,%.3f", m, campo(linea, "procesos"), campo(linea, "hilos"), w,
+               campo(linea, "combinaciones"), t > csv
+        for (f = 1; f <= 5; f++) printf ",%.3f", campo(linea, fases[f] "_max") > csv
+        printf ",%.2f,%.3f\n", speedup, eficiencia > csv
+        sub(/}$/, "", linea)
+        printf "%s,\"speedup\":%.4f,\"eficiencia\":%.4f}\n", linea, speedup, eficiencia > json
+    }
+}' "$crudo"
+
+echo ""
+column -s, -t < "$prefijo.csv" 2>/dev/null || cat "$prefijo.csv"
+echo ""
+echo "✅ Tabla guardada en: $prefijo.csv"
+echo "✅ Detalle por fase (máximo y promedio entre procesos) en: $prefijo.json"
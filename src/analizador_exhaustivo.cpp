@@ -1,14 +1,81 @@
 #include "analizador_exhaustivo.hpp"
+#include "formato_csv.hpp"
+#include "instrumentacion.hpp"
+#include "pool_bloques.hpp"
+#include "topologia.hpp"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <limits>
+#include <map>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+const char* const COLUMNAS_RESULTADOS = "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,SecuenciaEstados";
+
+// fsync por ruta (los ofstream no exponen su descriptor): con un archivo fuerza
+// sus datos a disco, con un directorio hace persistentes los rename hechos en él
+void sincronizarRuta(const std::string& ruta) {
+    int fd = ::open(ruta.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0 || ::fsync(fd) != 0) {
+        std::string error = std::strerror(errno);
+        if (fd >= 0) ::close(fd);
+        throw std::runtime_error("No se pudo sincronizar " + ruta + ": " + error);
+    }
+    ::close(fd);
+}
+}
+
+void EstadisticasProgreso::registrar(bool solucion_valida, double costo_total) {
+    combinaciones_procesadas++;
+    if (solucion_valida) {
+        soluciones_validas++;
+        suma_costos += costo_total;
+        
+        if (costo_total < costo_minimo_global) {
+            costo_minimo_global = costo_total;
+        }
+        if (costo_total > costo_maximo_global) {
+            costo_maximo_global = costo_total;
+        }
+        
+        costo_promedio = suma_costos / soluciones_validas;
+    }
+}
+
+void EstadisticasProgreso::combinar(const EstadisticasProgreso& otras) {
+    combinaciones_procesadas += otras.combinaciones_procesadas;
+    soluciones_validas += otras.soluciones_validas;
+    suma_costos += otras.suma_costos;
+    costo_minimo_global = std::min(costo_minimo_global, otras.costo_minimo_global);
+    costo_maximo_global = std::max(costo_maximo_global, otras.costo_maximo_global);
+    costo_promedio = soluciones_validas > 0 ? suma_costos / soluciones_validas : 0.0;
+}
 
 AnalizadorExhaustivo::AnalizadorExhaustivo() : 
+    resumen_(std::make_unique<ResumenAgregado>()),
     intervalo_reporte_(1000), 
     guardar_todas_soluciones_(false),
-    umbral_costo_interes_(std::numeric_limits<double>::infinity()) {
+    umbral_costo_interes_(std::numeric_limits<double>::infinity()),
+    num_hilos_(1),
+    tam_bloque_(4096),
+    afinidad_(false),
+    intervalo_checkpoint_(0),
+    rango_desde_(0),
+    rango_hasta_(0),
+    analisis_completo_(false),
+    modo_shard_(false),
+    indice_shard_(0),
+    total_shards_(1),
+    procesadas_previas_(0),
+    intervalo_metricas_ms_(1000) {
     
     // Configurar demanda por defecto
     demanda_fija_ = {300, 200, 100, 100, 100, 200, 300, 500, 800, 1000, 1000, 1000, 
@@ -23,7 +90,15 @@ void AnalizadorExhaustivo::configurarDemanda(const std::vector<double>& demanda)
 }
 
 void AnalizadorExhaustivo::configurarArchivos(const std::string& archivo_resultados, const std::string& archivo_log) {
-    archivo_resultados_.open(archivo_resultados);
+    // Terminar de escribir y cerrar los archivos de una corrida anterior
+    escritor_.reset();
+    if (archivo_resultados_.is_open()) archivo_resultados_.close();
+    if (archivo_log_.is_open()) archivo_log_.close();
+    archivo_resultados_.clear();
+    archivo_log_.clear();
+    
+    // En modo shard la cabecera se escribe al empezar el rango
+    archivo_resultados_.open(archivo_resultados, modo_shard_ ? std::ios::out | std::ios::binary : std::ios::out);
     archivo_log_.open(archivo_log);
     
     if (!archivo_resultados_.is_open()) {
@@ -34,8 +109,18 @@ void AnalizadorExhaustivo::configurarArchivos(const std::string& archivo_resulta
         throw std::runtime_error("No se pudo abrir el archivo de log: " + archivo_log);
     }
     
+    // Cada juego de archivos arranca estadísticas y resumen nuevos
+    stats_ = EstadisticasProgreso();
+    resumen_->reiniciar();
+    archivo_checkpoint_ = archivo_resultados + ".checkpoint";
+    ruta_resultados_ = archivo_resultados;
+    ruta_log_ = archivo_log;
+    
     // Escribir headers
-    archivo_resultados_ << "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,SecuenciaEstados\n";
+    escritor_ = std::make_unique<EscritorAsincrono>(archivo_resultados_, config_escritor_);
+    if (!modo_shard_) {
+        escritor_->escribir(std::string(COLUMNAS_RESULTADOS) + "\n");
+    }
     archivo_log_ << "=== ANÁLISIS EXHAUSTIVO DE MÁQUINA DE ESTADOS ===\n";
     archivo_log_ << "Inicio del análisis: " << std::chrono::duration_cast<std::chrono::seconds>(
         std::chrono::system_clock::now().time_since_epoch()).count() << "\n";
@@ -44,39 +129,93 @@ void AnalizadorExhaustivo::configurarArchivos(const std::string& archivo_resulta
 
 void AnalizadorExhaustivo::configurarReporte(uint32_t intervalo, bool guardar_todas, double umbral_costo) {
     intervalo_reporte_ = intervalo;
+    guardar_todas_soluciones_ = guardar_todas;
+    umbral_costo_interes_ = umbral_costo;
+}
+
+void AnalizadorExhaustivo::configurarCheckpoint(uint32_t intervalo) {
+    intervalo_checkpoint_ = intervalo;
+}
 
-std::string AnalizadorExhaustivo::estadoToString(EstadoMaquina estado) const {
-    switch (estado) {
-        case EstadoMaquina::ON_CALIENTE: return "ON_CALIENTE";
-        case EstadoMaquina::OFF_CALIENTE: return "OFF_CALIENTE";
-        case EstadoMaquina::ON_TIBIO: return "ON_TIBIO";
-        case EstadoMaquina::OFF_TIBIO: return "OFF_TIBIO";
-        case EstadoMaquina::ON_FRIO: return "ON_FRIO";
-        case EstadoMaquina::OFF_FRIO: return "OFF_FRIO";
-        default: return "DESCONOCIDO";
+void AnalizadorExhaustivo::configurarEscritura(size_t tam_buffer, size_t max_buffers, size_t bytes_flush, uint32_t ms_flush) {
+    if (tam_buffer == 0 || max_buffers < 2) {
+        throw std::invalid_argument("La escritura necesita buffers de tamaño > 0 y al menos 2 buffers");
     }
+    config_escritor_.tam_buffer = tam_buffer;
+    config_escritor_.max_buffers = max_buffers;
+    config_escritor_.bytes_flush = bytes_flush;
+    config_escritor_.intervalo_flush = std::chrono::milliseconds(ms_flush);
 }
 
-void AnalizadorExhaustivo::guardarResultado(const ResultadoCombinacion& resultado) {
-    // Solo guardar si cumple criterios
-    if (!guardar_todas_soluciones_ && resultado.costo_total > umbral_costo_interes_) {
-        return;
+void AnalizadorExhaustivo::configurarShard(uint32_t indice, uint32_t total_shards) {
+    if (total_shards == 0 || indice >= total_shards) {
+        throw std::invalid_argument("Shard inválido: se necesita 0 <= i < N");
     }
-    
-    archivo_resultados_ << resultado.combinacion_id << ","
-                       << resultado.patron_eolica << ","
-                       << std::fixed << std::setprecision(2) << resultado.costo_total << ","
-                       << (resultado.solucion_valida ? "SI" : "NO") << ","
-                       << resultado.horas_criticas << ",";
+    modo_shard_ = true;
+    indice_shard_ = indice;
+    total_shards_ = total_shards;
+}
+
+void AnalizadorExhaustivo::configurarCubo(const std::string& archivo_cubo) {
+    ruta_cubo_ = archivo_cubo;
+}
+
+void AnalizadorExhaustivo::configurarMetricas(const std::string& ruta, uint32_t intervalo_ms) {
+    if (intervalo_ms == 0) {
+        throw std::invalid_argument("El intervalo de las métricas debe ser mayor que cero");
+    }
+    ruta_metricas_ = ruta;
+    intervalo_metricas_ms_ = intervalo_ms;
+}
+
+void AnalizadorExhaustivo::configurarHilos(unsigned num_hilos, uint32_t tam_bloque) {
+    if (tam_bloque == 0) {
+        throw std::invalid_argument("El tamaño de bloque debe ser mayor que cero");
+    }
+    num_hilos_ = num_hilos;
+    tam_bloque_ = tam_bloque;
+}
+
+void AnalizadorExhaustivo::configurarAfinidad(bool activa) {
+    afinidad_ = activa;
+}
+
+bool AnalizadorExhaustivo::debeGuardarse(const ResultadoCombinacion& resultado) const {
+    // Solo guardar si cumple criterios
+    return guardar_todas_soluciones_ || !(resultado.costo_total > umbral_costo_interes_);
+}
+
+char* AnalizadorExhaustivo::formatearResultado(char* p, const ResultadoCombinacion& resultado) const {
+    p = escribirEnteroCsv(p, resultado.combinacion_id);
+    *p++ = ',';
+    p = escribirPatronCsv(p, static_cast<uint32_t>(resultado.patron_eolica.to_ulong()));
+    *p++ = ',';
+    p = escribirCostoCsv(p, resultado.costo_total);
+    *p++ = ',';
+    std::memcpy(p, resultado.solucion_valida ? "SI," : "NO,", 3);
+    p += 3;
+    p = escribirEnteroCsv(p, static_cast<uint64_t>(resultado.horas_criticas));
+    *p++ = ',';
     
     // Guardar secuencia de estados
-    for (size_t i = 0; i < resultado.secuencia_optima.size(); i++) {
-        if (i > 0) archivo_resultados_ << "-";
-        archivo_resultados_ << estadoToString(resultado.secuencia_optima[i]);
+    p = escribirSecuenciaCsv(p, resultado.secuencia_optima);
+    *p++ = '\n';
+    return p;
+}
+
+void AnalizadorExhaustivo::guardarResultado(const ResultadoCombinacion& resultado) {
+    if (!debeGuardarse(resultado)) {
+        return;
     }
-    archivo_resultados_ << "\n";
     
-    archivo_resultados_.flush(); // Asegurar escritura
+    char fila[MAX_FILA_CSV];
+    char* fin;
+    {
+        MEDIR_FASE(FORMATO);
+        fin = formatearResultado(fila, resultado);
+    }
+    MEDIR_FASE(ESCRITURA);
+    escritor_->escribir(fila, static_cast<size_t>(fin - fila));
 }
 
 std::string AnalizadorExhaustivo::tiempoTranscurrido() const {
@@ -94,28 +233,50 @@ std::string AnalizadorExhaustivo::tiempoTranscurrido() const {
     return oss.str();
 }
 
+uint64_t AnalizadorExhaustivo::procesadasEnVivo() const {
+    // En modo multihilo los hilos van por delante de lo ya emitido en stats_
+    return procesadas_previas_ + (telemetria_ ? telemetria_->leerTotal().procesadas : 0);
+}
+
 double AnalizadorExhaustivo::tiempoEstimadoRestante() const {
-    if (stats_.combinaciones_procesadas == 0) return 0.0;
-    
-    auto tiempo_transcurrido = std::chrono::steady_clock::now() - stats_.tiempo_inicio;
-    double segundos_transcurridos = std::chrono::duration<double>(tiempo_transcurrido).count();
-    
-    double tasa_procesamiento = stats_.combinaciones_procesadas / segundos_transcurridos;
-    uint32_t restantes = stats_.combinaciones_totales - stats_.combinaciones_procesadas;
-    
-    return restantes / tasa_procesamiento;
+    return avance_.eta(procesadasEnVivo(), stats_.combinaciones_totales);
 }
 
 void AnalizadorExhaustivo::mostrarProgreso() {
     double porcentaje = (double)stats_.combinaciones_procesadas / stats_.combinaciones_totales * 100.0;
+    avance_.actualizar(procesadasEnVivo());
     double tiempo_restante = tiempoEstimadoRestante();
     
     std::cout << "\r[" << std::fixed << std::setprecision(2) << porcentaje << "%] "
               << stats_.combinaciones_procesadas << "/" << stats_.combinaciones_totales
               << " | Válidas: " << stats_.soluciones_validas
               << " | Tiempo: " << tiempoTranscurrido()
-              << " | ETA: " << (int)(tiempo_restante/3600) << "h" << (int)((int)tiempo_restante%3600)/60 << "m"
-              << std::flush;
+              << " | ETA: ";
+    if (tiempo_restante < 0) {
+        std::cout << "--";
+    } else {
+        std::cout << (int)(tiempo_restante/3600) << "h" << (int)((int)tiempo_restante%3600)/60 << "m";
+    }
+    std::cout << std::flush;
+}
+
+MetricasBarrido AnalizadorExhaustivo::metricasEnVivo(EstimadorAvance& avance) const {
+    MetricasBarrido metricas;
+    metricas.programa = "analizador_exhaustivo";
+    metricas.etiqueta_fuente = "hilo";
+    metricas.total = stats_.combinaciones_totales;
+    metricas.segundos = avance.segundos();
+    for (unsigned h = 0; h < telemetria_->getNumRanuras(); h++) {
+        LecturaTelemetria lectura = telemetria_->leer(h);
+        lectura.tasa = metricas.segundos > 0 ? lectura.procesadas / metricas.segundos : 0.0;
+        metricas.global.combinar(lectura);
+        metricas.fuentes.push_back(lectura);
+    }
+    metricas.global.procesadas += procesadas_previas_;
+    avance.actualizar(metricas.global.procesadas);
+    metricas.global.tasa = avance.tasa();
+    metricas.eta = avance.eta(metricas.global.procesadas, metricas.total);
+    return metricas;
 }
 
 void AnalizadorExhaustivo::generarReporteProgreso() {
@@ -130,7 +291,38 @@ void AnalizadorExhaustivo::generarReporteProgreso() {
     archivo_log_.flush();
 }
 
-void AnalizadorExhaustivo::configurarEscenario(Escenario& escenario, const std::bitset<24>& patron_eolica) {
+void AnalizadorExhaustivo::registrarEnResumen(ResumenAgregado& resumen, const ResultadoCombinacion& resultado) const {
+    uint32_t mascara_encendido = resultado.solucion_valida ?
+        ResumenAgregado::mascaraEncendido(resultado.secuencia_optima) : 0;
+    resumen.registrar(resultado.combinacion_id, resultado.solucion_valida, resultado.costo_total,
+                      resultado.horas_criticas, mascara_encendido);
+}
+
+void AnalizadorExhaustivo::registrarEnCubo(const ResultadoCombinacion& resultado) {
+    if (!cubo_) {
+        return;
+    }
+    uint32_t mascara_encendido = resultado.solucion_valida ?
+        ResumenAgregado::mascaraEncendido(resultado.secuencia_optima) : 0;
+    cubo_->registrar(resultado.combinacion_id, resultado.solucion_valida, resultado.costo_total,
+                     resultado.horas_criticas, resultado.secuencia_optima, mascara_encendido);
+}
+
+CabeceraCubo AnalizadorExhaustivo::cabeceraCubo() const {
+    return crearCabeceraCubo(rango_desde_, rango_hasta_, demanda_fija_, 500.0, 1.0, 2.5, 5.0);
+}
+
+void AnalizadorExhaustivo::escribirResumenAgregado() {
+    // Tiempos por fase del barrido (solo si se compiló con USAR_INSTRUMENTACION)
+    escribirReporteFases(archivo_log_, stats_.combinaciones_procesadas);
+    
+    // Mismo reporte que scripts/analizar_resultados.sh, calculado durante el barrido
+    archivo_log_ << "\n";
+    resumen_->imprimirReporte(archivo_log_, std::numeric_limits<size_t>::max());
+    archivo_log_.flush();
+}
+
+void AnalizadorExhaustivo::configurarEscenario(Escenario& escenario, const std::bitset<24>& patron_eolica) const {
     // Crear vectores para la configuración
     std::vector<double> energia_eolica(24);
     
@@ -142,60 +334,80 @@ void AnalizadorExhaustivo::configurarEscenario(Escenario& escenario, const std::
     escenario.configurarDirecto(demanda_fija_, energia_eolica);
 }
 
-void AnalizadorExhaustivo::ejecutarAnalisisCompleto() {
-    std::cout << "\n=== INICIANDO ANÁLISIS EXHAUSTIVO ===\n";
-    std::cout << "Total de combinaciones: " << stats_.combinaciones_totales << "\n";
-    std::cout << "Esto puede tomar varios días de procesamiento...\n\n";
+ResultadoCombinacion AnalizadorExhaustivo::resolverCombinacion(uint32_t combinacion, bool silencioso) const {
+    // Armar el escenario y el calculador; resolver() mide aparte su propio tiempo
+    MEDIR_FASE(ESCENARIO);
     
-    stats_.tiempo_inicio = std::chrono::steady_clock::now();
-    stats_.ultimo_reporte = stats_.tiempo_inicio;
+    // Convertir número a patrón binario de 24 bits
+    std::bitset<24> patron_eolica(combinacion);
     
-    double suma_costos = 0.0;
+    // Configurar escenario para esta combinación
+    Escenario escenario;
+    configurarEscenario(escenario, patron_eolica);
     
-    for (uint32_t combinacion = 0; combinacion < stats_.combinaciones_totales; combinacion++) {
-        // Convertir número a patrón binario de 24 bits
-        std::bitset<24> patron_eolica(combinacion);
-        
-        // Configurar escenario para esta combinación
-        Escenario escenario;
-        configurarEscenario(escenario, patron_eolica);
-        
-        // Crear calculador y resolver
-        CalculadorCostos calculador(escenario);
-        calculador.configurarCostos(1.0, 2.5, 5.0);
-        
-        Solucion solucion = calculador.resolver();
-        
-        // Almacenar resultado
-        ResultadoCombinacion resultado;
-        resultado.combinacion_id = combinacion;
-        resultado.patron_eolica = patron_eolica;
-        resultado.costo_total = solucion.costo_total;
-        resultado.solucion_valida = solucion.es_valida;
-        resultado.secuencia_optima = solucion.estados_por_hora;
-        
-        // Calcular horas críticas
-        resultado.horas_criticas = 0;
-        for (int hora = 0; hora < 24; hora++) {
-            if (!escenario.demandaCubiertaConEO(hora)) {
-                resultado.horas_criticas++;
-            }
+    // Crear calculador y resolver
+    CalculadorCostos calculador(escenario);
+    calculador.configurarCostos(1.0, 2.5, 5.0);
+    calculador.configurarSilencioso(silencioso);
+    
+    Solucion solucion = calculador.resolver();
+    
+    // Almacenar resultado
+    ResultadoCombinacion resultado;
+    resultado.combinacion_id = combinacion;
+    resultado.patron_eolica = patron_eolica;
+    resultado.costo_total = solucion.costo_total;
+    resultado.solucion_valida = solucion.es_valida;
+    resultado.secuencia_optima = solucion.estados_por_hora;
+    
+    // Calcular horas críticas
+    resultado.horas_criticas = 0;
+    for (int hora = 0; hora < 24; hora++) {
+        if (!escenario.demandaCubiertaConEO(hora)) {
+            resultado.horas_criticas++;
         }
+    }
+    
+    return resultado;
+}
+
+void AnalizadorExhaustivo::procesarRango(uint32_t desde, uint32_t hasta) {
+    // Una ranura por hilo del pool (0 = todos los núcleos, como en PoolBloques)
+    unsigned ranuras = num_hilos_ > 0 ? num_hilos_ : std::max(1u, std::thread::hardware_concurrency());
+    telemetria_ = std::make_unique<TelemetriaHilos>(ranuras);
+    procesadas_previas_ = stats_.combinaciones_procesadas;
+    avance_.reiniciar();
+    avance_.actualizar(procesadas_previas_);
+    
+    // El publicador lleva su propio estimador: corre en otro hilo
+    std::unique_ptr<PublicadorMetricas> publicador;
+    EstimadorAvance avance_metricas;
+    avance_metricas.actualizar(procesadas_previas_);
+    if (!ruta_metricas_.empty()) {
+        publicador = std::make_unique<PublicadorMetricas>(
+            ruta_metricas_, std::chrono::milliseconds(intervalo_metricas_ms_),
+            [this, &avance_metricas] { return metricasEnVivo(avance_metricas); });
+    }
+    
+    if (num_hilos_ == 1) {
+        procesarRangoSecuencial(desde, hasta);
+    } else {
+        procesarRangoParalelo(desde, hasta);
+    }
+}
+
+void AnalizadorExhaustivo::procesarRangoSecuencial(uint32_t desde, uint32_t hasta) {
+    RanuraTelemetria& ranura = telemetria_->ranura(0);
+    for (uint32_t combinacion = desde; combinacion < hasta; combinacion++) {
+        ResultadoCombinacion resultado = resolverCombinacion(combinacion, false);
+        ranura.registrar(resultado.solucion_valida, resultado.costo_total);
         
         // Actualizar estadísticas
-        stats_.combinaciones_procesadas++;
-        if (solucion.es_valida) {
-            stats_.soluciones_validas++;
-            suma_costos += solucion.costo_total;
-            
-            if (solucion.costo_total < stats_.costo_minimo_global) {
-                stats_.costo_minimo_global = solucion.costo_total;
-            }
-            if (solucion.costo_total > stats_.costo_maximo_global) {
-                stats_.costo_maximo_global = solucion.costo_total;
-            }
-            
-            stats_.costo_promedio = suma_costos / stats_.soluciones_validas;
+        {
+            MEDIR_FASE(AGREGADO);
+            stats_.registrar(resultado.solucion_valida, resultado.costo_total);
+            registrarEnResumen(*resumen_, resultado);
+            registrarEnCubo(resultado);
         }
         
         // Guardar resultado
@@ -206,76 +418,161 @@ void AnalizadorExhaustivo::ejecutarAnalisisCompleto() {
             mostrarProgreso();
             generarReporteProgreso();
         }
+        
+        if (intervalo_checkpoint_ > 0 && (combinacion + 1 - rango_desde_) % intervalo_checkpoint_ == 0) {
+            escribirCheckpoint(combinacion + 1);
+        }
     }
-    
-    std::cout << "\n\n=== ANÁLISIS COMPLETADO ===\n";
-    mostrarEstadisticasFinales();
-    generarResumenEjecutivo();
 }
 
-void AnalizadorExhaustivo::ejecutarAnalisisParcial(uint32_t desde, uint32_t hasta) {
-    if (hasta > stats_.combinaciones_totales) {
-        hasta = stats_.combinaciones_totales;
+void AnalizadorExhaustivo::procesarRangoParalelo(uint32_t desde, uint32_t hasta) {
+    PoolBloques pool(num_hilos_, tam_bloque_);
+    Topologia topologia;
+    if (afinidad_) {
+        topologia = Topologia::detectar();
+        aplicarAfinidad(pool, topologia);
     }
     
-    std::cout << "\n=== ANÁLISIS PARCIAL [" << desde << " - " << hasta << "] ===\n";
-    
-    stats_.tiempo_inicio = std::chrono::steady_clock::now();
-    stats_.ultimo_reporte = stats_.tiempo_inicio;
-    stats_.combinaciones_totales = hasta - desde;
+    // Aporte de cada bloque, indexado por posición; se libera al emitirlo
+    uint32_t num_bloques = (hasta - desde + tam_bloque_ - 1) / tam_bloque_;
+    std::vector<ParcialBloque> parciales(num_bloques);
     
-    double suma_costos = 0.0;
-    
-    for (uint32_t combinacion = desde; combinacion < hasta; combinacion++) {
-        std::bitset<24> patron_eolica(combinacion);
-        
-        Escenario escenario;
-        configurarEscenario(escenario, patron_eolica);
+    auto procesar = [&](const PoolBloques::Bloque& bloque, unsigned hilo, std::string& salida) {
+        ParcialBloque& parcial = parciales[bloque.indice];
+        RanuraTelemetria& ranura = telemetria_->ranura(hilo);
+        parcial.registros.reserve(bloque.hasta - bloque.desde);
+        char fila[MAX_FILA_CSV];
         
-        CalculadorCostos calculador(escenario);
-        calculador.configurarCostos(1.0, 2.5, 5.0);
-        
-        Solucion solucion = calculador.resolver();
-        
-        ResultadoCombinacion resultado;
-        resultado.combinacion_id = combinacion;
-        resultado.patron_eolica = patron_eolica;
-        resultado.costo_total = solucion.costo_total;
-        resultado.solucion_valida = solucion.es_valida;
-        resultado.secuencia_optima = solucion.estados_por_hora;
-        
-        resultado.horas_criticas = 0;
-        for (int hora = 0; hora < 24; hora++) {
-            if (!escenario.demandaCubiertaConEO(hora)) {
-                resultado.horas_criticas++;
+        for (uint32_t combinacion = bloque.desde; combinacion < bloque.hasta; combinacion++) {
+            ResultadoCombinacion resultado = resolverCombinacion(combinacion, true);
+            ranura.registrar(resultado.solucion_valida, resultado.costo_total);
+            {
+                MEDIR_FASE(AGREGADO);
+                parcial.stats.registrar(resultado.solucion_valida, resultado.costo_total);
+                parcial.registros.push_back(RegistroResumen{
+                    resultado.combinacion_id,
+                    resultado.solucion_valida ? ResumenAgregado::mascaraEncendido(resultado.secuencia_optima) : 0,
+                    resultado.costo_total, resultado.horas_criticas, resultado.solucion_valida});
+                registrarEnCubo(resultado);   // Cada ID va a su posición: no necesita orden
             }
+            if (debeGuardarse(resultado)) {
+                MEDIR_FASE(FORMATO);
+                char* fin = formatearResultado(fila, resultado);
+                salida.append(fila, static_cast<size_t>(fin - fila));
+            }
+        }
+    };
+    
+    auto emitir = [&](const PoolBloques::Bloque& bloque, std::string& salida) {
+        {
+            MEDIR_FASE(ESCRITURA);
+            escritor_->entregar(std::move(salida));
         }
         
-        stats_.combinaciones_procesadas++;
-        if (solucion.es_valida) {
-            stats_.soluciones_validas++;
-            suma_costos += solucion.costo_total;
-            
-            if (solucion.costo_total < stats_.costo_minimo_global) {
-                stats_.costo_minimo_global = solucion.costo_total;
+        // Acumular en orden: stats_ y resumen_ corresponden siempre a lo ya escrito
+        ParcialBloque& parcial = parciales[bloque.indice];
+        uint32_t anteriores = stats_.combinaciones_procesadas;
+        {
+            MEDIR_FASE(AGREGADO);
+            stats_.combinar(parcial.stats);
+            for (const RegistroResumen& r : parcial.registros) {
+                resumen_->registrar(r.combinacion_id, r.solucion_valida, r.costo_total, r.horas_criticas, r.mascara_encendido);
             }
-            if (solucion.costo_total > stats_.costo_maximo_global) {
-                stats_.costo_maximo_global = solucion.costo_total;
-            }
-            
-            stats_.costo_promedio = suma_costos / stats_.soluciones_validas;
+            ParcialBloque().registros.swap(parcial.registros);
         }
         
-        guardarResultado(resultado);
-        
-        if (stats_.combinaciones_procesadas % intervalo_reporte_ == 0) {
+        // Reportar cada vez que se cruza un múltiplo del intervalo
+        if (stats_.combinaciones_procesadas / intervalo_reporte_ != anteriores / intervalo_reporte_) {
             mostrarProgreso();
             generarReporteProgreso();
         }
+        if (intervalo_checkpoint_ > 0 &&
+            (bloque.hasta - rango_desde_) / intervalo_checkpoint_ != (bloque.desde - rango_desde_) / intervalo_checkpoint_) {
+            escribirCheckpoint(bloque.hasta);
+        }
+    };
+    
+    std::cout << "Modo multihilo: " << pool.getNumHilos() << " hilos, bloques de "
+              << pool.getTamBloque() << " combinaciones\n";
+    if (afinidad_) {
+        std::cout << "Afinidad por " << topologia.describir() << "\n";
+    }
+    pool.ejecutar(desde, hasta, procesar, emitir);
+    if (afinidad_) {
+        imprimirRendimientoDominios(std::cout, rendimientoPorDominio(topologia, pool));
+    }
+}
+
+void AnalizadorExhaustivo::completarRango(uint32_t desde) {
+    if (!escritor_) {
+        throw std::runtime_error("Falta configurarArchivos antes de ejecutar el análisis");
+    }
+    // Al reanudar, la cabecera del shard ya está escrita
+    if (modo_shard_ && desde == rango_desde_) {
+        std::ostringstream cabecera;
+        escribirCabeceraShard(cabecera, metadatosShard(), *resumen_, false, 0);
+        escritor_->escribir(cabecera.str());
+    }
+    // Al reanudar, reanudarAnalisis ya reabrió el cubo
+    if (!ruta_cubo_.empty() && desde == rango_desde_) {
+        cubo_.reset();
+        cubo_ = std::make_unique<EscritorCubo>(ruta_cubo_, cabeceraCubo());
+    }
+    procesarRango(desde, rango_hasta_);
+    escritor_->vaciar();
+    if (cubo_) {
+        cubo_->completar();
+        std::cout << "\nCubo binario guardado en: " << cubo_->archivo() << "\n";
+        cubo_.reset();
+        ruta_cubo_.clear();
     }
+    if (modo_shard_) {
+        completarShard();
+    }
+    borrarCheckpoint();
+    
+    if (analisis_completo_) {
+        std::cout << "\n\n=== ANÁLISIS COMPLETADO ===\n";
+        mostrarEstadisticasFinales();
+        generarResumenEjecutivo();
+    } else {
+        std::cout << "\n\n=== ANÁLISIS PARCIAL COMPLETADO ===\n";
+        mostrarEstadisticasFinales();
+        escribirResumenAgregado();
+    }
+}
+
+void AnalizadorExhaustivo::ejecutarAnalisisCompleto() {
+    std::cout << "\n=== INICIANDO ANÁLISIS EXHAUSTIVO ===\n";
+    std::cout << "Total de combinaciones: " << stats_.combinaciones_totales << "\n";
+    std::cout << "Esto puede tomar varios días de procesamiento...\n\n";
+    
+    stats_.tiempo_inicio = std::chrono::steady_clock::now();
+    stats_.ultimo_reporte = stats_.tiempo_inicio;
+    reiniciarFases();
+    
+    rango_desde_ = 0;
+    rango_hasta_ = stats_.combinaciones_totales;
+    analisis_completo_ = true;
+    completarRango(rango_desde_);
+}
+
+void AnalizadorExhaustivo::ejecutarAnalisisParcial(uint32_t desde, uint32_t hasta) {
+    if (hasta > stats_.combinaciones_totales) {
+        hasta = stats_.combinaciones_totales;
+    }
+    
+    std::cout << "\n=== ANÁLISIS PARCIAL [" << desde << " - " << hasta << "] ===\n";
+    
+    stats_.tiempo_inicio = std::chrono::steady_clock::now();
+    stats_.ultimo_reporte = stats_.tiempo_inicio;
+    stats_.combinaciones_totales = hasta - desde;
+    reiniciarFases();
     
-    std::cout << "\n\n=== ANÁLISIS PARCIAL COMPLETADO ===\n";
-    mostrarEstadisticasFinales();
+    rango_desde_ = desde;
+    rango_hasta_ = hasta;
+    analisis_completo_ = false;
+    completarRango(rango_desde_);
 }
 
 void AnalizadorExhaustivo::mostrarEstadisticasFinales() {
@@ -312,8 +609,234 @@ void AnalizadorExhaustivo::generarResumenEjecutivo() {
     archivo_log_ << "  Costo máximo: " << stats_.costo_maximo_global << "\n";
     archivo_log_ << "  Costo promedio: " << stats_.costo_promedio << "\n";
     archivo_log_ << "  Rango: " << (stats_.costo_maximo_global - stats_.costo_minimo_global) << "\n";
-    archivo_log_.flush();
+    escribirResumenAgregado();
     
+    escritor_.reset();
     archivo_resultados_.close();
     archivo_log_.close();
 }
+
+MetadatosShard AnalizadorExhaustivo::metadatosShard() const {
+    MetadatosShard metadatos;
+    metadatos.generador = "analisis_exhaustivo";
+    metadatos.columnas = COLUMNAS_RESULTADOS;
+    metadatos.indice = indice_shard_;
+    metadatos.total_shards = total_shards_;
+    metadatos.desde = rango_desde_;
+    metadatos.hasta = rango_hasta_;
+    metadatos.parametros["demanda"] = listaValores(demanda_fija_);
+    metadatos.parametros["costos"] = listaValores({1.0, 2.5, 5.0});
+    metadatos.parametros["eolica"] = "500";
+    metadatos.parametros["guardar_todas"] = guardar_todas_soluciones_ ? "1" : "0";
+    metadatos.parametros["umbral_costo"] = listaValores({umbral_costo_interes_});
+    return metadatos;
+}
+
+void AnalizadorExhaustivo::completarShard() {
+    // Reescribir la cabecera (mismo largo) marcándola completa y con el resumen final
+    MetadatosShard metadatos = metadatosShard();
+    std::ostringstream cabecera;
+    escribirCabeceraShard(cabecera, metadatos, *resumen_, true, 0);
+    archivo_resultados_.flush();
+    uint64_t bytes_filas = static_cast<uint64_t>(archivo_resultados_.tellp()) - cabecera.str().size();
+    archivo_resultados_.seekp(0);
+    escribirCabeceraShard(archivo_resultados_, metadatos, *resumen_, true, bytes_filas);
+    archivo_resultados_.seekp(0, std::ios::end);
+    archivo_resultados_.flush();
+}
+
+void AnalizadorExhaustivo::escribirCheckpoint(uint32_t siguiente_id) {
+    // Todo lo anterior a siguiente_id ya está en el CSV (y en el cubo)
+    escritor_->vaciar();
+    if (cubo_) {
+        cubo_->sincronizar();
+    }
+    long long offset = static_cast<long long>(archivo_resultados_.tellp());
+    // Las filas hasta offset deben estar en disco antes de que el checkpoint las cite
+    sincronizarRuta(ruta_resultados_);
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - stats_.tiempo_inicio).count();
+    
+    // Se escribe aparte y se renombra: un corte a mitad de escritura deja intacto el anterior
+    std::string temporal = archivo_checkpoint_ + ".tmp";
+    std::ofstream checkpoint(temporal, std::ios::binary | std::ios::trunc);
+    if (!checkpoint.is_open()) {
+        throw std::runtime_error("No se pudo crear el checkpoint: " + temporal);
+    }
+    
+    checkpoint << "# Checkpoint de AnalizadorExhaustivo\n";
+    checkpoint << "version=1\n";
+    checkpoint << "tipo=" << (analisis_completo_ ? "completo" : "parcial") << "\n";
+    checkpoint << "archivo_log=" << ruta_log_ << "\n";
+    checkpoint << "desde=" << rango_desde_ << "\n";
+    checkpoint << "hasta=" << rango_hasta_ << "\n";
+    checkpoint << "siguiente=" << siguiente_id << "\n";
+    checkpoint << "offset_resultados=" << offset << "\n";
+    checkpoint << "combinaciones_procesadas=" << stats_.combinaciones_procesadas << "\n";
+    checkpoint << "combinaciones_totales=" << stats_.combinaciones_totales << "\n";
+    checkpoint << "soluciones_validas=" << stats_.soluciones_validas << "\n";
+    checkpoint << "intervalo_reporte=" << intervalo_reporte_ << "\n";
+    checkpoint << "guardar_todas=" << (guardar_todas_soluciones_ ? 1 : 0) << "\n";
+    checkpoint << "shard=" << (modo_shard_ ? std::to_string(indice_shard_) + "/" + std::to_string(total_shards_) : "no") << "\n";
+    checkpoint << "archivo_cubo=" << (cubo_ ? cubo_->archivo() : "") << "\n";
+    
+    // Doubles en hexadecimal para recuperarlos exactos
+    checkpoint << std::hexfloat;
+    checkpoint << "suma_costos=" << stats_.suma_costos << "\n";
+    checkpoint << "costo_minimo=" << stats_.costo_minimo_global << "\n";
+    checkpoint << "costo_maximo=" << stats_.costo_maximo_global << "\n";
+    checkpoint << "umbral_costo=" << umbral_costo_interes_ << "\n";
+    checkpoint << "segundos=" << segundos << "\n";
+    checkpoint << "demanda=";
+    for (size_t h = 0; h < demanda_fija_.size(); h++) {
+        if (h > 0) checkpoint << ",";
+        checkpoint << demanda_fija_[h];
+    }
+    checkpoint << "\n";
+    
+    // El resumen agregado es de tamaño fijo: se guarda tal cual al final
+    checkpoint << std::dec << "resumen_bytes=" << sizeof(ResumenAgregado) << "\n";
+    checkpoint.write(reinterpret_cast<const char*>(resumen_.get()), sizeof(ResumenAgregado));
+    checkpoint.close();
+    if (!checkpoint) {
+        throw std::runtime_error("No se pudo guardar el checkpoint: " + archivo_checkpoint_);
+    }
+    
+    // Sin el fsync del temporal, un corte tras el rename puede dejar un checkpoint
+    // vacío; sin el del directorio, el rename mismo puede perderse
+    sincronizarRuta(temporal);
+    if (std::rename(temporal.c_str(), archivo_checkpoint_.c_str()) != 0) {
+        throw std::runtime_error("No se pudo guardar el checkpoint: " + archivo_checkpoint_);
+    }
+    std::filesystem::path directorio = std::filesystem::path(archivo_checkpoint_).parent_path();
+    sincronizarRuta(directorio.empty() ? "." : directorio.string());
+    
+    archivo_log_ << "CHECKPOINT [" << tiempoTranscurrido() << "] siguiente combinación: " << siguiente_id << "\n";
+    archivo_log_.flush();
+}
+
+void AnalizadorExhaustivo::borrarCheckpoint() {
+    if (!archivo_checkpoint_.empty()) {
+        std::remove(archivo_checkpoint_.c_str());
+    }
+}
+
+bool AnalizadorExhaustivo::reanudarAnalisis(const std::string& archivo_resultados) {
+    std::string ruta_checkpoint = archivo_resultados + ".checkpoint";
+    std::ifstream checkpoint(ruta_checkpoint, std::ios::binary);
+    if (!checkpoint.is_open()) {
+        return false;
+    }
+    
+    // Líneas clave=valor hasta resumen_bytes; después vienen los bytes del resumen
+    std::map<std::string, std::string> campos;
+    std::string linea;
+    while (std::getline(checkpoint, linea)) {
+        if (linea.empty() || linea[0] == '#') continue;
+        size_t igual = linea.find('=');
+        if (igual == std::string::npos) {
+            throw std::runtime_error("Checkpoint corrupto: " + ruta_checkpoint);
+        }
+        std::string clave = linea.substr(0, igual);
+        campos[clave] = linea.substr(igual + 1);
+        if (clave == "resumen_bytes") break;
+    }
+    
+    auto campo = [&](const std::string& clave) -> const std::string& {
+        auto it = campos.find(clave);
+        if (it == campos.end()) {
+            throw std::runtime_error("Checkpoint incompleto, falta '" + clave + "': " + ruta_checkpoint);
+        }
+        return it->second;
+    };
+    auto decimal = [&](const std::string& clave) { return std::strtod(campo(clave).c_str(), nullptr); };
+    auto entero = [&](const std::string& clave) { return static_cast<uint32_t>(std::stoul(campo(clave))); };
+    
+    if (campo("version") != "1" || std::stoul(campo("resumen_bytes")) != sizeof(ResumenAgregado)) {
+        throw std::runtime_error("Checkpoint de una versión incompatible: " + ruta_checkpoint);
+    }
+    
+    std::vector<double> demanda;
+    std::istringstream valores(campo("demanda"));
+    std::string valor;
+    while (std::getline(valores, valor, ',')) {
+        demanda.push_back(std::strtod(valor.c_str(), nullptr));
+    }
+    if (demanda != demanda_fija_) {
+        throw std::runtime_error("El checkpoint se generó con otra demanda: " + ruta_checkpoint);
+    }
+    
+    auto resumen = std::make_unique<ResumenAgregado>();
+    checkpoint.read(reinterpret_cast<char*>(resumen.get()), sizeof(ResumenAgregado));
+    if (!checkpoint) {
+        throw std::runtime_error("Checkpoint truncado: " + ruta_checkpoint);
+    }
+    checkpoint.close();
+    
+    // Recortar el CSV: lo escrito después del checkpoint se vuelve a generar
+    std::uintmax_t offset = std::stoull(campo("offset_resultados"));
+    std::error_code error;
+    std::uintmax_t tam_actual = std::filesystem::file_size(archivo_resultados, error);
+    if (error || tam_actual < offset) {
+        throw std::runtime_error("El archivo de resultados no coincide con el checkpoint: " + archivo_resultados);
+    }
+    std::filesystem::resize_file(archivo_resultados, offset);
+    
+    escritor_.reset();
+    if (archivo_resultados_.is_open()) archivo_resultados_.close();
+    if (archivo_log_.is_open()) archivo_log_.close();
+    archivo_resultados_.clear();
+    archivo_log_.clear();
+    archivo_resultados_.open(archivo_resultados, std::ios::in | std::ios::out | std::ios::binary);
+    archivo_resultados_.seekp(0, std::ios::end);
+    escritor_ = std::make_unique<EscritorAsincrono>(archivo_resultados_, config_escritor_);
+    ruta_log_ = campo("archivo_log");
+    archivo_log_.open(ruta_log_, std::ios::app);
+    if (!archivo_resultados_.is_open() || !archivo_log_.is_open()) {
+        throw std::runtime_error("No se pudieron reabrir los archivos de la corrida: " + archivo_resultados);
+    }
+    archivo_checkpoint_ = ruta_checkpoint;
+    ruta_resultados_ = archivo_resultados;
+    
+    // Restaurar configuración, estadísticas y resumen
+    analisis_completo_ = campo("tipo") == "completo";
+    rango_desde_ = entero("desde");
+    rango_hasta_ = entero("hasta");
+    intervalo_reporte_ = entero("intervalo_reporte");
+    guardar_todas_soluciones_ = campo("guardar_todas") == "1";
+    modo_shard_ = campos.count("shard") > 0 && campo("shard") != "no";
+    if (modo_shard_) {
+        interpretarShard(campo("shard"), indice_shard_, total_shards_);
+    }
+    umbral_costo_interes_ = decimal("umbral_costo");
+    
+    // El cubo ya tiene las filas anteriores al checkpoint: se sigue escribiendo en el mismo
+    cubo_.reset();
+    ruta_cubo_ = campos.count("archivo_cubo") > 0 ? campo("archivo_cubo") : "";
+    if (!ruta_cubo_.empty()) {
+        cubo_ = std::make_unique<EscritorCubo>(ruta_cubo_, cabeceraCubo(), true);
+    }
+    
+    stats_ = EstadisticasProgreso();
+    stats_.combinaciones_procesadas = entero("combinaciones_procesadas");
+    stats_.combinaciones_totales = entero("combinaciones_totales");
+    stats_.soluciones_validas = entero("soluciones_validas");
+    stats_.suma_costos = decimal("suma_costos");
+    stats_.costo_minimo_global = decimal("costo_minimo");
+    stats_.costo_maximo_global = decimal("costo_maximo");
+    stats_.costo_promedio = stats_.soluciones_validas > 0 ? stats_.suma_costos / stats_.soluciones_validas : 0.0;
+    resumen_ = std::move(resumen);
+    
+    // El tiempo ya invertido cuenta para la tasa y el ETA
+    auto ahora = std::chrono::steady_clock::now();
+    stats_.tiempo_inicio = ahora - std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(decimal("segundos")));
+    stats_.ultimo_reporte = ahora;
+    
+    uint32_t siguiente = entero("siguiente");
+    std::cout << "\n=== REANUDANDO ANÁLISIS [" << siguiente << " - " << rango_hasta_ << "] ===\n";
+    std::cout << "Combinaciones ya procesadas: " << stats_.combinaciones_procesadas << "\n";
+    archivo_log_ << "\n=== REANUDACIÓN desde la combinación " << siguiente << " ===\n";
+    
+    completarRango(siguiente);
+    return true;
+}
@@ -1,8 +1,14 @@
 #include "calculador_costos.hpp"
+#include "calculador_tabular.hpp"
+#include "cubo_resultados.hpp"
 #include "escenario.hpp"
+#include "formato_csv.hpp"
+#include <algorithm>
 #include <iostream>
 #include <bitset>
+#include <fstream>
 #include <iomanip>
+#include <memory>
 
 // Función para convertir patrón binario string a bitset
 std::bitset<24> stringToBitset(const std::string& patron) {
@@ -259,22 +265,144 @@ void mostrarSolucionDetallada(const Solucion& solucion, const Escenario& escenar
     }
 }
 
-int main() {
-    std::cout << "=== ANALIZADOR DE CASOS INDIVIDUALES ===\n";
-    std::cout << "Permite analizar en detalle un patrón específico de energía eólica\n\n";
-    
+// Respuesta precalculada: si el cubo tiene el patrón, la solución sale de ahí
+// sin resolver nada (acceso O(1) por ID). `combinacion` usa la convención de
+// este programa (hora 0 = bit 23); el cubo, la del analizador exhaustivo.
+bool buscarEnCubo(const CuboResultados* cubo, uint32_t combinacion, Solucion& solucion) {
+    uint32_t id = invertirPatron24(combinacion);
+    if (cubo == nullptr || !cubo->contiene(id)) {
+        return false;
+    }
+    solucion.es_valida = cubo->valida(id);
+    solucion.costo_total = cubo->costo(id);
+    solucion.estados_por_hora = cubo->secuencia(id);
+    return true;
+}
+
+// El cubo solo sirve si se generó con la misma demanda, eólica y costos
+std::unique_ptr<CuboResultados> abrirCubo(const std::string& archivo, const std::vector<double>& demanda) {
+    auto cubo = std::make_unique<CuboResultados>(archivo);
+    if (!cubo->mismaConfiguracion(demanda, 500.0, 1.0, 2.5, 5.0)) {
+        throw std::runtime_error("El cubo " + archivo + " se generó con otra demanda o con otros costos");
+    }
+    return cubo;
+}
+
+// Modo lote: un patrón de 24 bits por línea, una fila CSV por patrón (las
+// columnas del analizador exhaustivo; el ID y el patrón, con la convención de
+// este programa, como en los demos). Los que no están en el cubo se
+// resuelven con CalculadorTabular, que da la misma solución sin salida por
+// consola. La salida se vacía cada vez que no quedan líneas pendientes en la
+// entrada, así un cliente que manda de a un patrón recibe la respuesta enseguida.
+int responderLote(std::istream& entrada, const CuboResultados* cubo, const std::vector<double>& demanda) {
+    CalculadorTabular tabular;
+    tabular.configurarDemanda(demanda, 500.0);
+    tabular.configurarCostos(1.0, 2.5, 5.0);
+
+    std::string salida = "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,SecuenciaEstados\n";
+    std::string linea;
+    Solucion solucion;
+    EstadoMaquina estados[24];
+    char fila[MAX_FILA_CSV];
+    uint64_t del_cubo = 0, resueltos = 0, invalidos = 0;
+    while (std::getline(entrada, linea)) {
+        while (!linea.empty() && (linea.back() == '\r' || linea.back() == ' ')) linea.pop_back();
+        if (!linea.empty() && linea[0] != '#') {
+            std::bitset<24> patron;
+            try {
+                patron = stringToBitset(linea);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << "Patrón inválido (" << e.what() << "): " << linea << "\n";
+                invalidos++;
+                continue;
+            }
+            uint32_t combinacion = static_cast<uint32_t>(patron.to_ulong());
+            uint32_t criticas = tabular.mascaraCriticas(CalculadorTabular::eolicaPorHora(combinacion));
+            if (buscarEnCubo(cubo, combinacion, solucion)) {
+                del_cubo++;
+            } else {
+                solucion.costo_total = tabular.resolver(criticas, estados);
+                solucion.es_valida = solucion.costo_total != CalculadorTabular::INFINITO;
+                solucion.estados_por_hora.assign(estados, estados + 24);
+                resueltos++;
+            }
+            char* fin = escribirFilaSecuenciaCsv(fila, combinacion, solucion.costo_total, solucion.es_valida,
+                                                 __builtin_popcount(criticas), solucion.estados_por_hora);
+            salida.append(fila, static_cast<size_t>(fin - fila));
+        }
+        if (salida.size() >= (64u << 10) || entrada.rdbuf()->in_avail() <= 0) {
+            std::cout << salida << std::flush;
+            salida.clear();
+        }
+    }
+    std::cout << salida << std::flush;
+    std::cerr << "Patrones respondidos: " << del_cubo + resueltos << " (" << del_cubo << " del cubo, "
+              << resueltos << " resueltos)";
+    if (invalidos > 0) std::cerr << ", " << invalidos << " inválidos";
+    std::cerr << "\n";
+    return invalidos > 0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[]) {
     // Configurar demanda fija
     std::vector<double> demanda_fija = {
         300, 200, 100, 100, 100, 200, 300, 500, 800, 1000, 1000, 1000,
         1000, 900, 800, 800, 800, 1000, 1000, 1000, 600, 600, 400, 300
     };
+
+    // Opciones: --cubo archivo.cubo responde desde un barrido precalculado;
+    // --lote lee patrones de stdin y --archivo de un archivo, uno por línea;
+    // --patron P analiza un patrón en detalle sin preguntarlo
+    std::string archivo_cubo, archivo_patrones, patron_input;
+    bool lote = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cubo" && i + 1 < argc) {
+            archivo_cubo = argv[++i];
+        } else if (arg == "--archivo" && i + 1 < argc) {
+            archivo_patrones = argv[++i];
+        } else if (arg == "--patron" && i + 1 < argc) {
+            patron_input = argv[++i];
+        } else if (arg == "--lote") {
+            lote = true;
+        } else {
+            std::cerr << "Uso: " << argv[0] << " [--cubo archivo.cubo] [--patron P | --lote | --archivo patrones.txt]\n";
+            return 1;
+        }
+    }
+
+    std::unique_ptr<CuboResultados> cubo;
+    if (!archivo_cubo.empty()) {
+        try {
+            cubo = abrirCubo(archivo_cubo, demanda_fija);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    if (lote || !archivo_patrones.empty()) {
+        if (archivo_patrones.empty()) {
+            return responderLote(std::cin, cubo.get(), demanda_fija);
+        }
+        std::ifstream entrada(archivo_patrones);
+        if (!entrada.is_open()) {
+            std::cerr << "Error: no se pudo abrir " << archivo_patrones << std::endl;
+            return 1;
+        }
+        return responderLote(entrada, cubo.get(), demanda_fija);
+    }
+
+    std::cout << "=== ANALIZADOR DE CASOS INDIVIDUALES ===\n";
+    std::cout << "Permite analizar en detalle un patrón específico de energía eólica\n\n";
     
-    std::string patron_input;
-    std::cout << "Ingresa el patrón de energía eólica (24 bits):\n";
-    std::cout << "Formato: hora 0 = bit izquierdo, 1 = hay eólica (500 MW), 0 = sin eólica\n";
-    std::cout << "Ejemplo: 000000000000000000001110 (eólica en horas 1,2,3)\n";
-    std::cout << "Patrón: ";
-    std::cin >> patron_input;
+    if (patron_input.empty()) {
+        std::cout << "Ingresa el patrón de energía eólica (24 bits):\n";
+        std::cout << "Formato: hora 0 = bit izquierdo, 1 = hay eólica (500 MW), 0 = sin eólica\n";
+        std::cout << "Ejemplo: 000000000000000000001110 (eólica en horas 1,2,3)\n";
+        std::cout << "Patrón: ";
+        std::cin >> patron_input;
+    }
     
     try {
         // Convertir string a bitset
@@ -291,13 +419,18 @@ int main() {
         // Mostrar análisis detallado del escenario
         mostrarAnalisisDetallado(escenario, patron_eolica);
         
-        // Mostrar proceso de optimización
-        mostrarProcesoOptimizacion(escenario);
-        
-        // Resolver con el calculador normal
-        CalculadorCostos calculador(escenario);
-        calculador.configurarCostos(1.0, 2.5, 5.0);
-        Solucion solucion = calculador.resolver();
+        Solucion solucion;
+        if (buscarEnCubo(cubo.get(), static_cast<uint32_t>(patron_eolica.to_ulong()), solucion)) {
+            std::cout << "\n📦 Solución tomada del cubo " << archivo_cubo << " (sin resolver)\n";
+        } else {
+            // Mostrar proceso de optimización
+            mostrarProcesoOptimizacion(escenario);
+            
+            // Resolver con el calculador normal
+            CalculadorCostos calculador(escenario);
+            calculador.configurarCostos(1.0, 2.5, 5.0);
+            solucion = calculador.resolver();
+        }
         
         // Mostrar solución detallada
         mostrarSolucionDetallada(solucion, escenario);
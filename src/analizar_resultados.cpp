@@ -0,0 +1,363 @@
+#include "cubo_resultados.hpp"
+#include "formato_columnar.hpp"
+#include "formato_csv.hpp"
+#include "lector_resultados.hpp"
+#include "pool_bloques.hpp"
+#include "resumen_agregado.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Reporte de un archivo de resultados en una sola pasada y en paralelo: el
+// mismo resumen que los demos calculan durante el barrido (estadísticas,
+// extremos, horas críticas y frecuencia de transiciones). Lee el CSV mapeado
+// en tramos (uno por bloque del pool), o directamente un cubo (.cubo) o un
+// archivo columnar (comprimir_resultados).
+//
+// Uso: analizar_resultados [opciones] archivo
+//   --hilos N                 hilos (0 = todos los núcleos)
+//   --costo-min X / --costo-max X
+//   --horas-criticas A-B      rango de horas críticas
+//   --transiciones P          cadena exacta ("nunca" = nunca prendida)
+//   --solo-validas
+//   --filas salida.csv        escribir también las filas que cumplen el filtro
+//   --max-firmas N            firmas de transiciones a listar (20)
+
+namespace {
+// Columnas de las filas que se reconstruyen desde un cubo
+const char* const COLUMNAS_CUBO = "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,SecuenciaEstados";
+
+struct Opciones {
+    unsigned num_hilos;
+    FiltroResultados filtro;
+    std::string archivo;
+    std::string archivo_filas;
+    size_t max_firmas;
+
+    Opciones() : num_hilos(0), max_firmas(20) {}
+};
+
+// Estado de un recorrido: un resumen por hilo y las filas elegidas por bloque
+struct Recorrido {
+    std::vector<std::unique_ptr<ResumenAgregado>> resumenes;
+    std::vector<uint64_t> filas_leidas;
+    std::vector<uint64_t> filas_descartadas;   // Formato inválido
+    std::unique_ptr<std::ofstream> salida_filas;
+
+    Recorrido(unsigned num_hilos) : filas_leidas(num_hilos, 0), filas_descartadas(num_hilos, 0) {
+        for (unsigned h = 0; h < num_hilos; h++) {
+            resumenes.push_back(std::make_unique<ResumenAgregado>());
+        }
+    }
+};
+
+PoolBloques::FuncionEmision emisionDeFilas(Recorrido& recorrido) {
+    return [&recorrido](const PoolBloques::Bloque&, std::string& filas) {
+        if (recorrido.salida_filas && !filas.empty()) {
+            recorrido.salida_filas->write(filas.data(), static_cast<std::streamsize>(filas.size()));
+        }
+    };
+}
+
+// --- CSV ---
+
+std::string recorrerCsv(const Opciones& opciones, PoolBloques& pool, Recorrido& recorrido) {
+    int fd = open(opciones.archivo.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("No se pudo abrir " + opciones.archivo);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("Archivo vacío o ilegible: " + opciones.archivo);
+    }
+    size_t tam = static_cast<size_t>(info.st_size);
+    void* mapa = mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        throw std::runtime_error("No se pudo mapear " + opciones.archivo);
+    }
+    madvise(mapa, tam, MADV_SEQUENTIAL);
+    const char* datos = static_cast<const char*>(mapa);
+    const char* fin = datos + tam;
+
+    try {
+        const char* fin_cabecera = static_cast<const char*>(std::memchr(datos, '\n', tam));
+        if (fin_cabecera == nullptr) fin_cabecera = fin;
+        std::string cabecera(datos, fin_cabecera);
+        ColumnaTexto columna = columnaTextoDeCabecera(cabecera);
+
+        // Tramos de ~8 MB cortados en fin de línea
+        const size_t TAM_TRAMO = 8u << 20;
+        std::vector<const char*> cortes{std::min(fin_cabecera + 1, fin)};
+        while (cortes.back() < fin) {
+            const char* corte = cortes.back() + std::min(TAM_TRAMO, static_cast<size_t>(fin - cortes.back()));
+            const char* salto = corte < fin ? static_cast<const char*>(std::memchr(corte, '\n', fin - corte)) : nullptr;
+            cortes.push_back(salto ? salto + 1 : fin);
+        }
+
+        auto procesar = [&](const PoolBloques::Bloque& bloque, unsigned hilo, std::string& filas) {
+            ResumenAgregado& resumen = *recorrido.resumenes[hilo];
+            FilaResultado fila;
+            for (const char* p = cortes[bloque.indice], *hasta = cortes[bloque.indice + 1]; p < hasta;) {
+                const char* salto = static_cast<const char*>(std::memchr(p, '\n', hasta - p));
+                const char* fin_linea = salto ? salto : hasta;
+                std::string_view linea(p, static_cast<size_t>(fin_linea - p));
+                p = fin_linea + 1;
+                if (linea.empty()) continue;
+
+                recorrido.filas_leidas[hilo]++;
+                if (!interpretarFilaResultado(linea, columna, fila)) {
+                    recorrido.filas_descartadas[hilo]++;
+                    continue;
+                }
+                if (!opciones.filtro.acepta(fila.solucion_valida, fila.costo_total, fila.horas_criticas,
+                                            fila.mascara_encendido)) {
+                    continue;
+                }
+                resumen.registrar(fila.combinacion_id, fila.solucion_valida, fila.costo_total,
+                                  fila.horas_criticas, fila.mascara_encendido);
+                if (recorrido.salida_filas) {
+                    filas.append(linea.data(), linea.size());
+                    filas += '\n';
+                }
+            }
+        };
+        pool.ejecutar(0, static_cast<uint32_t>(cortes.size() - 1), procesar, emisionDeFilas(recorrido));
+        munmap(mapa, tam);
+        return cabecera;
+    } catch (...) {
+        munmap(mapa, tam);
+        throw;
+    }
+}
+
+// --- Cubo binario ---
+
+std::string recorrerCubo(const Opciones& opciones, PoolBloques& pool, Recorrido& recorrido) {
+    CuboResultados cubo(opciones.archivo);
+    const uint32_t TAM_TRAMO = 1u << 16;
+    uint32_t num_tramos = (cubo.filas() + TAM_TRAMO - 1) / TAM_TRAMO;
+
+    auto procesar = [&](const PoolBloques::Bloque& bloque, unsigned hilo, std::string& filas) {
+        ResumenAgregado& resumen = *recorrido.resumenes[hilo];
+        uint32_t desde = cubo.desde() + bloque.indice * TAM_TRAMO;
+        uint32_t hasta = std::min(cubo.hasta(), desde + TAM_TRAMO);
+        char linea[MAX_FILA_CSV];
+        for (uint32_t id = desde; id < hasta; id++) {
+            recorrido.filas_leidas[hilo]++;
+            bool valida = cubo.valida(id);
+            double costo = cubo.costo(id);
+            int horas = cubo.horasCriticas(id);
+            uint32_t mascara = cubo.mascaraEncendido(id);
+            if (!opciones.filtro.acepta(valida, costo, horas, mascara)) {
+                continue;
+            }
+            resumen.registrar(id, valida, costo, horas, mascara);
+            if (recorrido.salida_filas) {
+                // Misma fila que escribe el analizador exhaustivo
+                char* p = escribirFilaSecuenciaCsv(linea, id, costo, valida, horas, cubo.secuencia(id));
+                filas.append(linea, static_cast<size_t>(p - linea));
+            }
+        }
+    };
+    pool.ejecutar(0, num_tramos, procesar, emisionDeFilas(recorrido));
+    return COLUMNAS_CUBO;
+}
+
+// --- Formato columnar ---
+
+std::string recorrerColumnar(const Opciones& opciones, PoolBloques& pool, Recorrido& recorrido) {
+    ArchivoColumnar columnar(opciones.archivo);
+    ColumnaTexto columna = columnaTextoDeCabecera(columnar.columnas());
+
+    auto procesar = [&](const PoolBloques::Bloque& bloque, unsigned hilo, std::string& filas) {
+        const EstadisticasBloque& estadisticas = columnar.bloques()[bloque.indice];
+        recorrido.filas_leidas[hilo] += estadisticas.filas;
+        // Bloques que el filtro descarta sin descomprimirlos
+        const FiltroResultados& filtro = opciones.filtro;
+        if (estadisticas.horas_max < filtro.horas_min || estadisticas.horas_min > filtro.horas_max ||
+            ((filtro.solo_validas || filtro.por_transiciones || filtro.filtraCosto()) &&
+             (estadisticas.validas == 0 || estadisticas.costo_max < filtro.costo_min ||
+              estadisticas.costo_min > filtro.costo_max))) {
+            return;
+        }
+
+        ResumenAgregado& resumen = *recorrido.resumenes[hilo];
+        BloqueColumnar datos = columnar.leerBloque(bloque.indice);
+        // Costos y máscaras se interpretan una vez por entrada de diccionario
+        std::vector<double> costos(datos.costos.size());
+        for (size_t i = 0; i < costos.size(); i++) costos[i] = std::strtod(datos.costos[i].c_str(), nullptr);
+        std::vector<uint32_t> mascaras(datos.textos.size(), 0);
+        std::vector<char> textos_validos(datos.textos.size(), 1);
+        for (size_t i = 0; i < mascaras.size(); i++) {
+            textos_validos[i] = columna == ColumnaTexto::TRANSICIONES ? mascaraDeTransiciones(datos.textos[i], mascaras[i])
+                                                                      : mascaraDeSecuencia(datos.textos[i], mascaras[i]);
+        }
+        for (size_t fila = 0; fila < datos.filas(); fila++) {
+            bool valida = datos.validas[fila] != 0;
+            uint32_t codigo = datos.codigos_texto[fila];
+            if (valida && !textos_validos[codigo]) {
+                recorrido.filas_descartadas[hilo]++;
+                continue;
+            }
+            double costo = costos[datos.codigos_costo[fila]];
+            uint32_t mascara = valida ? mascaras[codigo] : 0;
+            if (!filtro.acepta(valida, costo, datos.horas_criticas[fila], mascara)) {
+                continue;
+            }
+            resumen.registrar(datos.ids[fila], valida, costo, datos.horas_criticas[fila], mascara);
+            if (recorrido.salida_filas) {
+                datos.agregarFilaCsv(fila, filas);
+            }
+        }
+    };
+    pool.ejecutar(0, static_cast<uint32_t>(columnar.bloques().size()), procesar, emisionDeFilas(recorrido));
+    return columnar.columnas();
+}
+
+enum class TipoArchivo { CSV, CUBO, COLUMNAR };
+
+TipoArchivo tipoDeArchivo(const std::string& archivo) {
+    char magia[8] = {};
+    std::ifstream entrada(archivo, std::ios::binary);
+    if (!entrada.is_open()) {
+        throw std::runtime_error("No se pudo abrir " + archivo);
+    }
+    entrada.read(magia, sizeof(magia));
+    if (std::memcmp(magia, MAGIA_CUBO, sizeof(magia)) == 0) return TipoArchivo::CUBO;
+    if (std::memcmp(magia, MAGIA_COLUMNAR, sizeof(magia)) == 0) return TipoArchivo::COLUMNAR;
+    return TipoArchivo::CSV;
+}
+
+bool interpretarOpciones(int argc, char* argv[], Opciones& opciones) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hay_valor = i + 1 < argc;
+        if (arg == "--hilos" && hay_valor) {
+            opciones.num_hilos = std::stoul(argv[++i]);
+        } else if (arg == "--costo-min" && hay_valor) {
+            opciones.filtro.costo_min = std::stod(argv[++i]);
+        } else if (arg == "--costo-max" && hay_valor) {
+            opciones.filtro.costo_max = std::stod(argv[++i]);
+        } else if (arg == "--horas-criticas" && hay_valor) {
+            std::string rango = argv[++i];
+            size_t guion = rango.find('-');
+            opciones.filtro.horas_min = std::stoi(rango.substr(0, guion));
+            opciones.filtro.horas_max = guion == std::string::npos ? opciones.filtro.horas_min
+                                                                   : std::stoi(rango.substr(guion + 1));
+        } else if (arg == "--transiciones" && hay_valor) {
+            std::string patron = argv[++i];
+            uint32_t mascara;
+            if (patron != "nunca" && !mascaraDeTransiciones(patron, mascara)) {
+                throw std::invalid_argument("cadena de transiciones inválida: " + patron);
+            }
+            opciones.filtro.por_transiciones = true;
+            opciones.filtro.transiciones = patron == "nunca" ? "" : patron;
+        } else if (arg == "--solo-validas") {
+            opciones.filtro.solo_validas = true;
+        } else if (arg == "--filas" && hay_valor) {
+            opciones.archivo_filas = argv[++i];
+        } else if (arg == "--max-firmas" && hay_valor) {
+            opciones.max_firmas = std::stoul(argv[++i]);
+        } else if (opciones.archivo.empty() && arg.compare(0, 2, "--") != 0) {
+            opciones.archivo = arg;
+        } else {
+            throw std::invalid_argument("opción desconocida o incompleta: " + arg);
+        }
+    }
+    return !opciones.archivo.empty();
+}
+}
+
+int main(int argc, char* argv[]) {
+    Opciones opciones;
+    try {
+        if (!interpretarOpciones(argc, argv, opciones)) {
+            std::cerr << "Uso: " << argv[0] << " [--hilos N] [--costo-min X] [--costo-max X] [--horas-criticas A-B]\n"
+                      << "       [--transiciones P|nunca] [--solo-validas] [--filas salida.csv] [--max-firmas N] archivo\n"
+                      << "archivo: CSV de resultados, cubo binario (.cubo) o archivo columnar (.col)\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    try {
+        auto inicio = std::chrono::steady_clock::now();
+        PoolBloques pool(opciones.num_hilos, 1);
+        Recorrido recorrido(pool.getNumHilos());
+        if (!opciones.archivo_filas.empty()) {
+            recorrido.salida_filas = std::make_unique<std::ofstream>(opciones.archivo_filas, std::ios::binary);
+            if (!recorrido.salida_filas->is_open()) {
+                throw std::runtime_error("No se pudo crear " + opciones.archivo_filas);
+            }
+        }
+
+        // Las filas filtradas llevan la cabecera del formato de origen
+        std::string cabecera;
+        TipoArchivo tipo = tipoDeArchivo(opciones.archivo);
+        if (recorrido.salida_filas) {
+            std::string columnas = COLUMNAS_CUBO;
+            if (tipo == TipoArchivo::CSV) {
+                std::ifstream entrada(opciones.archivo);
+                std::getline(entrada, columnas);
+            } else if (tipo == TipoArchivo::COLUMNAR) {
+                columnas = ArchivoColumnar(opciones.archivo).columnas();
+            }
+            *recorrido.salida_filas << columnas << "\n";
+        }
+        switch (tipo) {
+            case TipoArchivo::CSV: cabecera = recorrerCsv(opciones, pool, recorrido); break;
+            case TipoArchivo::CUBO: cabecera = recorrerCubo(opciones, pool, recorrido); break;
+            case TipoArchivo::COLUMNAR: cabecera = recorrerColumnar(opciones, pool, recorrido); break;
+        }
+        if (recorrido.salida_filas) {
+            recorrido.salida_filas->close();
+            if (!*recorrido.salida_filas) {
+                throw std::runtime_error("Error al escribir " + opciones.archivo_filas);
+            }
+        }
+
+        // Los resúmenes parciales se combinan en cualquier orden con el mismo resultado
+        ResumenAgregado& resumen = *recorrido.resumenes[0];
+        uint64_t filas_leidas = recorrido.filas_leidas[0];
+        uint64_t filas_descartadas = recorrido.filas_descartadas[0];
+        for (size_t h = 1; h < recorrido.resumenes.size(); h++) {
+            resumen.combinar(*recorrido.resumenes[h]);
+            filas_leidas += recorrido.filas_leidas[h];
+            filas_descartadas += recorrido.filas_descartadas[h];
+        }
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+        std::cout << "📊 === ANÁLISIS DE RESULTADOS ===\n";
+        std::cout << "Archivo: " << opciones.archivo << "\n";
+        std::cout << "Columnas: " << cabecera << "\n";
+        std::cout << "Filas leídas: " << filas_leidas << " (" << pool.getNumHilos() << " hilo(s), "
+                  << std::fixed << std::setprecision(2) << segundos << " s)\n";
+        if (filas_descartadas > 0) {
+            std::cout << "⚠️  Filas con formato inválido (ignoradas): " << filas_descartadas << "\n";
+        }
+        std::cout << "Filas que cumplen el filtro: " << resumen.combinaciones << "\n\n";
+        resumen.imprimirReporte(std::cout, opciones.max_firmas);
+        if (!opciones.archivo_filas.empty()) {
+            std::cout << "\nFilas filtradas guardadas en: " << opciones.archivo_filas << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
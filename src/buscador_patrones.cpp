@@ -0,0 +1,266 @@
+#include "buscador_patrones.hpp"
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+// Margen para comparar cotas calculadas con un orden de sumas distinto
+constexpr double TOLERANCIA = 1e-9;
+constexpr int NUM_HORAS = CalculadorTabular::NUM_HORAS;
+constexpr int NUM_ESTADOS = CalculadorTabular::NUM_ESTADOS;
+constexpr double INFINITO = CalculadorTabular::INFINITO;
+}
+
+bool BuscadorPatrones::PeorPrimero::operator()(const PatronCandidato& a, const PatronCandidato& b) const {
+    // true si `a` va antes que `b` en el ranking (el peor queda en el tope del heap)
+    if (a.costo_total != b.costo_total) {
+        return buscar_caros ? a.costo_total > b.costo_total : a.costo_total < b.costo_total;
+    }
+    return a.combinacion_id < b.combinacion_id;
+}
+
+BuscadorPatrones::BuscadorPatrones(const CalculadorTabular& calculador) :
+    calculador_(calculador),
+    criticas_sin_eolica_(calculador.mascaraCriticas(0)),
+    criticas_con_eolica_(calculador.mascaraCriticas(0xFFFFFF)),
+    min_horas_eolicas_(0),
+    max_horas_eolicas_(NUM_HORAS),
+    criterio_(CriterioBusqueda::MAS_BARATOS),
+    k_(0),
+    mejores_(PeorPrimero{false}) {
+    calcularSufijos();
+}
+
+void BuscadorPatrones::configurarHorasEolicas(int minimo, int maximo) {
+    if (minimo < 0 || maximo > NUM_HORAS || minimo > maximo) {
+        throw std::invalid_argument("Rango de horas eólicas inválido");
+    }
+    min_horas_eolicas_ = minimo;
+    max_horas_eolicas_ = maximo;
+}
+
+bool BuscadorPatrones::esCritica(int hora, bool con_eolica) const {
+    uint32_t mascara = con_eolica ? criticas_con_eolica_ : criticas_sin_eolica_;
+    return (mascara >> hora) & 1u;
+}
+
+void BuscadorPatrones::calcularSufijos() {
+    sufijo_minimo_[NUM_HORAS].fill(0.0);
+
+    for (int hora = NUM_HORAS - 1; hora >= 1; hora--) {
+        CostosPorEstado& fila = sufijo_minimo_[hora];
+        fila.fill(INFINITO);
+
+        for (int estado = 0; estado < NUM_ESTADOS; estado++) {
+            bool permitido = CalculadorTabular::estadoPermitido(estado, hora, esCritica(hora, false)) ||
+                             CalculadorTabular::estadoPermitido(estado, hora, esCritica(hora, true));
+            if (!permitido) continue;
+
+            double costo = calculador_.getCostoMantenimiento(static_cast<EstadoMaquina>(estado)) +
+                           sufijo_minimo_[hora + 1][estado];
+            for (int anterior : CalculadorTabular::predecesores(estado)) {
+                fila[anterior] = std::min(fila[anterior], costo);
+            }
+        }
+    }
+}
+
+double BuscadorPatrones::cotaMinima(const CostosPorEstado& prefijo, int hora_siguiente) const {
+    double cota = INFINITO;
+    for (int estado = 0; estado < NUM_ESTADOS; estado++) {
+        cota = std::min(cota, prefijo[estado] + sufijo_minimo_[hora_siguiente][estado]);
+    }
+    return cota;
+}
+
+double BuscadorPatrones::completarSinEolica(const CostosPorEstado& prefijo, int hora_siguiente, bool eolica_23) const {
+    CostosPorEstado actual = prefijo;
+    CostosPorEstado siguiente;
+    for (int hora = hora_siguiente; hora < NUM_HORAS; hora++) {
+        bool con_eolica = (hora == NUM_HORAS - 1) && eolica_23;
+        calculador_.avanzar(actual, siguiente, hora, esCritica(hora, con_eolica));
+        actual = siguiente;
+    }
+    return *std::min_element(actual.begin(), actual.end());
+}
+
+double BuscadorPatrones::cotaMaxima(const CostosPorEstado& prefijo, int hora_siguiente) const {
+    if (hora_siguiente == NUM_HORAS) {
+        return *std::min_element(prefijo.begin(), prefijo.end());
+    }
+
+    // Quitar viento en las horas 0..22 solo agrega horas críticas, así que el
+    // patrón sin viento acota por arriba a todos los válidos del subárbol.
+    // La hora 23 no es monótona (cubierta obliga a OFF), se prueban ambas.
+    double cota = 0.0;
+    bool exacta = true;
+    for (int eolica_23 = 0; eolica_23 <= 1; eolica_23++) {
+        double costo = completarSinEolica(prefijo, hora_siguiente, eolica_23);
+        if (costo == INFINITO) {
+            exacta = false;
+            break;
+        }
+        cota = std::max(cota, costo);
+    }
+    if (exacta) {
+        return cota;
+    }
+
+    // Cota gruesa: peor prefijo factible más el costo máximo en cada hora restante
+    double peor_prefijo = 0.0;
+    for (double costo : prefijo) {
+        if (costo != INFINITO) peor_prefijo = std::max(peor_prefijo, costo);
+    }
+    return peor_prefijo + (NUM_HORAS - hora_siguiente) * calculador_.getCostoMaximoHora();
+}
+
+bool BuscadorPatrones::cuentaEolicaFactible(int horas_eolicas, int horas_restantes) const {
+    return horas_eolicas <= max_horas_eolicas_ && horas_eolicas + horas_restantes >= min_horas_eolicas_;
+}
+
+bool BuscadorPatrones::puedeMejorar(double cota_optimista, uint32_t id_minimo) const {
+    if (mejores_.size() < k_) {
+        return true;
+    }
+    const PatronCandidato& peor = mejores_.top();
+    double diferencia = criterio_ == CriterioBusqueda::MAS_CAROS ? cota_optimista - peor.costo_total
+                                                                 : peor.costo_total - cota_optimista;
+    if (diferencia > TOLERANCIA) return true;
+    if (diferencia < -TOLERANCIA) return false;
+    // Empate de costo: solo entra si el subárbol tiene IDs menores
+    return id_minimo < peor.combinacion_id;
+}
+
+bool BuscadorPatrones::admitir(const PatronCandidato& candidato) {
+    if (mejores_.size() < k_) {
+        mejores_.push(candidato);
+        return true;
+    }
+    if (PeorPrimero{criterio_ == CriterioBusqueda::MAS_CAROS}(candidato, mejores_.top())) {
+        mejores_.pop();
+        mejores_.push(candidato);
+        return true;
+    }
+    return false;
+}
+
+PatronCandidato BuscadorPatrones::crearCandidato(uint32_t patron, double costo) const {
+    PatronCandidato candidato;
+    candidato.combinacion_id = patron;
+    candidato.costo_total = costo;
+    candidato.horas_eolicas = static_cast<int>(std::bitset<24>(patron).count());
+    candidato.horas_criticas = static_cast<int>(std::bitset<24>(
+        calculador_.mascaraCriticas(CalculadorTabular::eolicaPorHora(patron))).count());
+    return candidato;
+}
+
+bool BuscadorPatrones::enumerarUniforme(int hora, uint32_t patron, int horas_eolicas) {
+    if (hora == NUM_HORAS) {
+        // Todos cuestan lo mismo: se resuelve solo para reportar el costo exacto
+        stats_.hojas_evaluadas++;
+        double exacto = calculador_.resolver(calculador_.mascaraCriticas(CalculadorTabular::eolicaPorHora(patron)));
+        if (exacto == INFINITO) {
+            return true;
+        }
+        return admitir(crearCandidato(patron, exacto));
+    }
+
+    int restantes = NUM_HORAS - hora - 1;
+    for (int eolica = 0; eolica <= 1; eolica++) {
+        if (!cuentaEolicaFactible(horas_eolicas + eolica, restantes)) continue;
+        uint32_t hijo = patron | (static_cast<uint32_t>(eolica) << (23 - hora));
+        // Los IDs crecen en este orden: al primer rechazo ya no entra ninguno más
+        if (!enumerarUniforme(hora + 1, hijo, horas_eolicas + eolica)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BuscadorPatrones::explorar(const CostosPorEstado& prefijo, int hora, uint32_t patron, int horas_eolicas) {
+    stats_.nodos_explorados++;
+
+    if (hora == NUM_HORAS) {
+        stats_.hojas_evaluadas++;
+        double costo = *std::min_element(prefijo.begin(), prefijo.end());
+        if (costo != INFINITO) {
+            admitir(crearCandidato(patron, costo));
+        }
+        return;
+    }
+
+    if (hora > 0) {
+        double cota_minima = cotaMinima(prefijo, hora);
+        if (cota_minima == INFINITO) {
+            stats_.nodos_podados++;   // Ningún patrón válido en el subárbol
+            return;
+        }
+        double cota_maxima = cotaMaxima(prefijo, hora);
+
+        bool caros = criterio_ == CriterioBusqueda::MAS_CAROS;
+        double optimista = caros ? cota_maxima : cota_minima;
+        double pesimista = caros ? cota_minima : cota_maxima;
+
+        if (!puedeMejorar(optimista, patron)) {
+            stats_.nodos_podados++;
+            return;
+        }
+        if (std::fabs(optimista - pesimista) <= TOLERANCIA) {
+            stats_.subarboles_uniformes++;
+            enumerarUniforme(hora, patron, horas_eolicas);
+            return;
+        }
+    }
+
+    // Expandir los dos hijos, primero el de mejor cota optimista
+    int restantes = NUM_HORAS - hora - 1;
+    CostosPorEstado hijos[2];
+    double orden[2];
+    for (int eolica = 0; eolica <= 1; eolica++) {
+        bool critica = esCritica(hora, eolica);
+        if (hora == 0) {
+            calculador_.iniciar(hijos[eolica], critica);
+        } else {
+            calculador_.avanzar(prefijo, hijos[eolica], hora, critica);
+        }
+        // Para los más caros conviene empezar sin viento (más horas críticas)
+        orden[eolica] = criterio_ == CriterioBusqueda::MAS_CAROS ? eolica
+                                                                : cotaMinima(hijos[eolica], hora + 1);
+    }
+
+    int primero = orden[1] < orden[0] ? 1 : 0;
+    for (int i = 0; i < 2; i++) {
+        int eolica = i == 0 ? primero : 1 - primero;
+        if (!cuentaEolicaFactible(horas_eolicas + eolica, restantes)) continue;
+        uint32_t hijo = patron | (static_cast<uint32_t>(eolica) << (23 - hora));
+        explorar(hijos[eolica], hora + 1, hijo, horas_eolicas + eolica);
+    }
+}
+
+std::vector<PatronCandidato> BuscadorPatrones::buscar(CriterioBusqueda criterio, size_t k) {
+    criterio_ = criterio;
+    k_ = k;
+    stats_ = EstadisticasBusqueda();
+    mejores_ = std::priority_queue<PatronCandidato, std::vector<PatronCandidato>, PeorPrimero>(
+        PeorPrimero{criterio == CriterioBusqueda::MAS_CAROS});
+
+    auto inicio = std::chrono::steady_clock::now();
+
+    if (k > 0 && cuentaEolicaFactible(0, NUM_HORAS)) {
+        CostosPorEstado raiz;
+        raiz.fill(0.0);
+        explorar(raiz, 0, 0, 0);
+    }
+
+    std::vector<PatronCandidato> resultado;
+    while (!mejores_.empty()) {
+        resultado.push_back(mejores_.top());
+        mejores_.pop();
+    }
+    std::reverse(resultado.begin(), resultado.end());
+
+    stats_.tiempo_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    return resultado;
+}
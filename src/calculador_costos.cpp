@@ -1,10 +1,11 @@
 #include "../include/calculador_costos.hpp"
+#include "../include/instrumentacion.hpp"
 #include <iostream>
 #include <algorithm>
 #include <climits>
 #include <limits>
 
-CalculadorCostos::CalculadorCostos(const Escenario& escenario) : escenario_(escenario) {
+CalculadorCostos::CalculadorCostos(const Escenario& escenario) : escenario_(escenario), silencioso_(false) {
     // Inicializar costos por defecto
     costos_mantenimiento_[EstadoMaquina::ON_FRIO] = 1.0;
     costos_mantenimiento_[EstadoMaquina::ON_TIBIO] = 2.0;
@@ -22,6 +23,10 @@ void CalculadorCostos::configurarCostos(double costo_frio, double costo_tibio, d
     costos_mantenimiento_[EstadoMaquina::ON_CALIENTE] = costo_caliente;
 }
 
+void CalculadorCostos::configurarSilencioso(bool silencioso) {
+    silencioso_ = silencioso;
+}
+
 std::vector<EstadoMaquina> CalculadorCostos::obtenerTransicionesPosibles(EstadoMaquina estado_actual) const {
     std::vector<EstadoMaquina> transiciones;
     
@@ -216,31 +221,32 @@ void CalculadorCostos::reconstruirSolucion(Solucion& solucion, EstadoMaquina est
 }
 
 Solucion CalculadorCostos::resolver() {
+    MEDIR_FASE(RESOLVER);
     Solucion mejor_solucion;
     mejor_solucion.costo_total = std::numeric_limits<double>::infinity();
     
-    std::cout << "\n=== INICIANDO RESOLUCIÓN DESDE HORA 23 ===" << std::endl;
+    if (!silencioso_) std::cout << "\n=== INICIANDO RESOLUCIÓN DESDE HORA 23 ===" << std::endl;
     
     // Verificar si la demanda de la hora 23 se cubre con EO
     bool demanda_23_cubierta = escenario_.demandaCubiertaConEO(23);
-    std::cout << "Demanda hora 23 cubierta con EO: " << (demanda_23_cubierta ? "Sí" : "No") << std::endl;
+    if (!silencioso_) std::cout << "Demanda hora 23 cubierta con EO: " << (demanda_23_cubierta ? "Sí" : "No") << std::endl;
     
     std::vector<EstadoMaquina> estados_iniciales;
     
     if (demanda_23_cubierta) {
         // Puede estar en cualquier estado OFF
         estados_iniciales = {EstadoMaquina::OFF_FRIO, EstadoMaquina::OFF_TIBIO, EstadoMaquina::OFF_CALIENTE};
-        std::cout << "Explorando estados OFF posibles para hora 23..." << std::endl;
+        if (!silencioso_) std::cout << "Explorando estados OFF posibles para hora 23..." << std::endl;
     } else {
         // Debe estar en ON/CALIENTE
         estados_iniciales = {EstadoMaquina::ON_CALIENTE};
-        std::cout << "Hora 23 debe estar en ON/CALIENTE" << std::endl;
+        if (!silencioso_) std::cout << "Hora 23 debe estar en ON/CALIENTE" << std::endl;
     }
     
     EstadoMaquina mejor_estado_inicial = EstadoMaquina::OFF_FRIO;
     
     for (EstadoMaquina estado_23 : estados_iniciales) {
-        std::cout << "\nProbando estado inicial: " << estadoToString(estado_23) << std::endl;
+        if (!silencioso_) std::cout << "\nProbando estado inicial: " << estadoToString(estado_23) << std::endl;
         
         // Limpiar memoización para cada intento
         limpiarMemoizacion();
@@ -250,22 +256,23 @@ Solucion CalculadorCostos::resolver() {
         
         if (resultado.es_valido) {  // si hay solución válida
             double costo_total = costo_23 + resultado.costo;
-            std::cout << "Costo encontrado: " << costo_total << std::endl;
+            if (!silencioso_) std::cout << "Costo encontrado: " << costo_total << std::endl;
             
             if (costo_total < mejor_solucion.costo_total) {
                 mejor_solucion.costo_total = costo_total;
                 mejor_solucion.es_valida = true;
                 mejor_estado_inicial = estado_23;
                 
-                std::cout << "¡Nueva mejor solución encontrada!" << std::endl;
+                if (!silencioso_) std::cout << "¡Nueva mejor solución encontrada!" << std::endl;
             }
         } else {
-            std::cout << "No se encontró solución válida desde este estado" << std::endl;
+            if (!silencioso_) std::cout << "No se encontró solución válida desde este estado" << std::endl;
         }
     }
     
     // Reconstruir la solución completa usando el mejor estado inicial encontrado
     if (mejor_solucion.es_valida) {
+        MEDIR_FASE(RECONSTRUCCION);
         // Volver a ejecutar la recursión con el mejor estado para tener la memoización correcta
         limpiarMemoizacion();
         resolver_recursivo(22, mejor_estado_inicial);
@@ -0,0 +1,189 @@
+#include "calculador_tabular.hpp"
+#include <stdexcept>
+
+namespace {
+
+constexpr int ON_CALIENTE = static_cast<int>(EstadoMaquina::ON_CALIENTE);
+constexpr int OFF_CALIENTE = static_cast<int>(EstadoMaquina::OFF_CALIENTE);
+constexpr int ON_TIBIO = static_cast<int>(EstadoMaquina::ON_TIBIO);
+constexpr int OFF_TIBIO = static_cast<int>(EstadoMaquina::OFF_TIBIO);
+constexpr int ON_FRIO = static_cast<int>(EstadoMaquina::ON_FRIO);
+constexpr int OFF_FRIO = static_cast<int>(EstadoMaquina::OFF_FRIO);
+
+// Estados que pueden llegar a cada estado, en el mismo orden que
+// CalculadorCostos::obtenerEstadosQueVanA (define el desempate).
+const std::array<std::array<int, 2>, CalculadorTabular::NUM_ESTADOS> PREDECESORES = {{
+    {{ON_CALIENTE, ON_TIBIO}},   // -> ON_CALIENTE
+    {{ON_CALIENTE, ON_TIBIO}},   // -> OFF_CALIENTE
+    {{OFF_CALIENTE, ON_FRIO}},   // -> ON_TIBIO
+    {{OFF_CALIENTE, ON_FRIO}},   // -> OFF_TIBIO
+    {{OFF_TIBIO, OFF_FRIO}},     // -> ON_FRIO
+    {{OFF_TIBIO, OFF_FRIO}},     // -> OFF_FRIO
+}};
+
+// Estados candidatos para la hora 23 en el orden en que los prueba resolver()
+const int ESTADOS_FINALES_CUBIERTA[] = {OFF_FRIO, OFF_TIBIO, OFF_CALIENTE};
+
+} // namespace
+
+CalculadorTabular::CalculadorTabular() : potencia_eolica_(500.0), criticas_sin_eolica_(0), criticas_con_eolica_(0) {
+    configurarDemanda({300, 200, 100, 100, 100, 200, 300, 500, 800, 1000, 1000, 1000,
+                       1000, 900, 800, 800, 800, 1000, 1000, 1000, 600, 600, 400, 300});
+    configurarCostos(1.0, 2.5, 5.0);
+}
+
+void CalculadorTabular::configurarDemanda(const std::vector<double>& demanda, double potencia_eolica) {
+    if (demanda.size() != NUM_HORAS) {
+        throw std::invalid_argument("La demanda debe tener exactamente 24 valores");
+    }
+    demanda_ = demanda;
+    potencia_eolica_ = potencia_eolica;
+
+    // Misma condición que Escenario::demandaCubiertaConEO (eo >= demanda)
+    criticas_sin_eolica_ = 0;
+    criticas_con_eolica_ = 0;
+    for (int hora = 0; hora < NUM_HORAS; hora++) {
+        if (!(0.0 >= demanda_[hora])) {
+            criticas_sin_eolica_ |= 1u << hora;
+        }
+        if (!(potencia_eolica_ >= demanda_[hora])) {
+            criticas_con_eolica_ |= 1u << hora;
+        }
+    }
+}
+
+void CalculadorTabular::configurarCostos(double costo_frio, double costo_tibio, double costo_caliente) {
+    costos_[ON_CALIENTE] = costo_caliente;
+    costos_[ON_TIBIO] = costo_tibio;
+    costos_[ON_FRIO] = costo_frio;
+    costos_[OFF_CALIENTE] = 0.0;
+    costos_[OFF_TIBIO] = 0.0;
+    costos_[OFF_FRIO] = 0.0;
+}
+
+uint32_t CalculadorTabular::eolicaPorHora(uint32_t combinacion_id) {
+    // En los demos y en analizador_individual la hora 0 es el bit más significativo
+    uint32_t eolica = 0;
+    for (int hora = 0; hora < NUM_HORAS; hora++) {
+        if (combinacion_id & (1u << (23 - hora))) {
+            eolica |= 1u << hora;
+        }
+    }
+    return eolica;
+}
+
+uint32_t CalculadorTabular::mascaraCriticas(uint32_t eolica_por_hora) const {
+    return (criticas_con_eolica_ & eolica_por_hora) | (criticas_sin_eolica_ & ~eolica_por_hora);
+}
+
+uint32_t CalculadorTabular::mascaraCriticas(const Escenario& escenario) {
+    uint32_t mascara = 0;
+    for (int hora = 0; hora < NUM_HORAS; hora++) {
+        if (!escenario.demandaCubiertaConEO(hora)) {
+            mascara |= 1u << hora;
+        }
+    }
+    return mascara;
+}
+
+bool CalculadorTabular::estadoPermitido(int estado, int hora, bool critica) {
+    if (critica) {
+        return estado == ON_CALIENTE;  // Solo ON/CALIENTE genera energía
+    }
+    if (hora == NUM_HORAS - 1) {
+        // resolver() solo explora estados OFF en la hora 23 cuando está cubierta
+        return estado == OFF_FRIO || estado == OFF_TIBIO || estado == OFF_CALIENTE;
+    }
+    return true;
+}
+
+const std::array<int, 2>& CalculadorTabular::predecesores(int estado) {
+    return PREDECESORES[estado];
+}
+
+void CalculadorTabular::iniciar(CostosPorEstado& costos, bool critica) const {
+    for (int estado = 0; estado < NUM_ESTADOS; estado++) {
+        costos[estado] = estadoPermitido(estado, 0, critica) ? costos_[estado] + 0.0 : INFINITO;
+    }
+}
+
+void CalculadorTabular::avanzar(const CostosPorEstado& previos, CostosPorEstado& actuales, int hora, bool critica) const {
+    for (int estado = 0; estado < NUM_ESTADOS; estado++) {
+        if (!estadoPermitido(estado, hora, critica)) {
+            actuales[estado] = INFINITO;
+            continue;
+        }
+        double mejor = INFINITO;
+        for (int anterior : PREDECESORES[estado]) {
+            if (previos[anterior] < mejor) {
+                mejor = previos[anterior];
+            }
+        }
+        actuales[estado] = costos_[estado] + mejor;
+    }
+}
+
+double CalculadorTabular::resolver(uint32_t mascara_criticas, EstadoMaquina* estados) const {
+    CostosPorEstado tabla[NUM_HORAS];
+
+    iniciar(tabla[0], mascara_criticas & 1u);
+    for (int hora = 1; hora < NUM_HORAS; hora++) {
+        avanzar(tabla[hora - 1], tabla[hora], hora, (mascara_criticas >> hora) & 1u);
+    }
+
+    // Elegir el estado de la hora 23 en el mismo orden que resolver()
+    const CostosPorEstado& ultima = tabla[NUM_HORAS - 1];
+    bool critica_23 = (mascara_criticas >> (NUM_HORAS - 1)) & 1u;
+    int estado_final = ON_CALIENTE;
+    double mejor_costo = ultima[ON_CALIENTE];
+    if (!critica_23) {
+        mejor_costo = INFINITO;
+        for (int estado : ESTADOS_FINALES_CUBIERTA) {
+            if (ultima[estado] < mejor_costo) {
+                mejor_costo = ultima[estado];
+                estado_final = estado;
+            }
+        }
+    }
+
+    if (estados == nullptr) {
+        return mejor_costo;
+    }
+
+    if (mejor_costo == INFINITO) {
+        for (int hora = 0; hora < NUM_HORAS; hora++) {
+            estados[hora] = EstadoMaquina::OFF_FRIO;
+        }
+        return mejor_costo;
+    }
+
+    // Backtracking: el mejor predecesor es el primero con costo estrictamente menor
+    estados[NUM_HORAS - 1] = static_cast<EstadoMaquina>(estado_final);
+    int siguiente = estado_final;
+    for (int hora = NUM_HORAS - 2; hora >= 0; hora--) {
+        int mejor_estado = OFF_FRIO;
+        double mejor = INFINITO;
+        for (int anterior : PREDECESORES[siguiente]) {
+            if (tabla[hora][anterior] < mejor) {
+                mejor = tabla[hora][anterior];
+                mejor_estado = anterior;
+            }
+        }
+        estados[hora] = static_cast<EstadoMaquina>(mejor_estado);
+        siguiente = mejor_estado;
+    }
+
+    return mejor_costo;
+}
+
+double CalculadorTabular::getCostoMantenimiento(EstadoMaquina estado) const {
+    return costos_[static_cast<int>(estado)];
+}
+
+double CalculadorTabular::getCostoMaximoHora() const {
+    double maximo = 0.0;
+    for (double costo : costos_) {
+        if (costo > maximo) maximo = costo;
+    }
+    return maximo;
+}
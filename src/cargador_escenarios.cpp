@@ -0,0 +1,183 @@
+#include "cargador_escenarios.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+// Línea sin el '\n'; `p` queda al principio de la siguiente
+std::string_view siguienteLinea(const char*& p, const char* fin) {
+    const char* salto = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(fin - p)));
+    const char* fin_linea = salto ? salto : fin;
+    std::string_view linea(p, static_cast<size_t>(fin_linea - p));
+    p = salto ? salto + 1 : fin;
+    return linea;
+}
+
+// Líneas vacías y comentarios no cuentan como datos
+bool esLineaDeDatos(std::string_view linea) {
+    size_t i = 0;
+    while (i < linea.size() && esEspacio(linea[i])) i++;
+    return i < linea.size() && linea[i] != '#';
+}
+
+// Cuántas líneas (todas y de datos) hay en un tramo
+struct CuentaTramo {
+    uint64_t lineas = 0;
+    uint64_t lineas_datos = 0;
+};
+}
+
+uint32_t mascaraCriticas(const double demanda[24], const double otras_fuentes[24]) {
+    uint32_t mascara = 0;
+#if defined(__AVX__)
+    // !(otras >= demanda), también verdadero si alguno es NaN (predicado NGE_UQ)
+    for (int hora = 0; hora < 24; hora += 4) {
+        __m256d criticas = _mm256_cmp_pd(_mm256_loadu_pd(otras_fuentes + hora), _mm256_loadu_pd(demanda + hora), _CMP_NGE_UQ);
+        mascara |= static_cast<uint32_t>(_mm256_movemask_pd(criticas)) << hora;
+    }
+#elif defined(__SSE2__)
+    for (int hora = 0; hora < 24; hora += 2) {
+        __m128d criticas = _mm_cmpnge_pd(_mm_loadu_pd(otras_fuentes + hora), _mm_loadu_pd(demanda + hora));
+        mascara |= static_cast<uint32_t>(_mm_movemask_pd(criticas)) << hora;
+    }
+#else
+    for (int hora = 0; hora < 24; hora++) {
+        mascara |= static_cast<uint32_t>(!(otras_fuentes[hora] >= demanda[hora])) << hora;
+    }
+#endif
+    return mascara;
+}
+
+CargadorEscenarios::CargadorEscenarios(const std::string& archivo) : archivo_(archivo), datos_(nullptr), tam_(0) {
+    int fd = open(archivo.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("No se pudo abrir " + archivo);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("No se pudo leer " + archivo);
+    }
+    tam_ = static_cast<size_t>(info.st_size);
+    if (tam_ > 0) {
+        void* mapa = mmap(nullptr, tam_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapa == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("No se pudo mapear " + archivo);
+        }
+        madvise(mapa, tam_, MADV_SEQUENTIAL);
+        datos_ = static_cast<const char*>(mapa);
+    }
+    close(fd);
+}
+
+CargadorEscenarios::~CargadorEscenarios() {
+    if (datos_) {
+        munmap(const_cast<char*>(datos_), tam_);
+    }
+}
+
+ResultadoCarga CargadorEscenarios::recorrer(PoolBloques& pool, const FuncionDia& procesar,
+                                            const FuncionEmision& emitir) const {
+    ResultadoCarga resultado{0, 0, tam_, {}};
+    if (tam_ == 0) {
+        return resultado;
+    }
+    const char* fin = datos_ + tam_;
+
+    // Tramos de ~8 MB cortados en fin de línea
+    const size_t TAM_TRAMO = 8u << 20;
+    std::vector<const char*> cortes{datos_};
+    while (cortes.back() < fin) {
+        const char* corte = cortes.back() + std::min(TAM_TRAMO, static_cast<size_t>(fin - cortes.back()));
+        const char* salto = corte < fin ? static_cast<const char*>(std::memchr(corte, '\n', fin - corte)) : nullptr;
+        cortes.push_back(salto ? salto + 1 : fin);
+    }
+    uint32_t num_tramos = static_cast<uint32_t>(cortes.size() - 1);
+
+    // Primera pasada: líneas por tramo, para saber en qué línea y en qué día
+    // empieza cada uno (un día puede quedar partido entre dos tramos)
+    std::vector<CuentaTramo> cuentas(num_tramos);
+    pool.ejecutar(0, num_tramos, [&](const PoolBloques::Bloque& bloque, unsigned, std::string&) {
+        for (uint32_t t = bloque.desde; t < bloque.hasta; t++) {
+            for (const char* p = cortes[t], *hasta = cortes[t + 1]; p < hasta;) {
+                cuentas[t].lineas++;
+                cuentas[t].lineas_datos += esLineaDeDatos(siguienteLinea(p, hasta));
+            }
+        }
+    }, [](const PoolBloques::Bloque&, std::string&) {});
+    std::vector<CuentaTramo> previas(num_tramos);
+    for (uint32_t t = 1; t < num_tramos; t++) {
+        previas[t].lineas = previas[t - 1].lineas + cuentas[t - 1].lineas;
+        previas[t].lineas_datos = previas[t - 1].lineas_datos + cuentas[t - 1].lineas_datos;
+    }
+    uint64_t lineas_datos = previas.back().lineas_datos + cuentas.back().lineas_datos;
+    resultado.dias = (lineas_datos + 1) / 2;
+
+    // Segunda pasada: cada tramo procesa los días cuya línea de demanda está en él
+    std::vector<std::vector<ErrorEscenario>> errores(num_tramos);
+    std::vector<uint64_t> validos(num_tramos, 0);
+    auto procesar_tramo = [&](uint32_t t, unsigned hilo, std::string& salida) {
+        uint64_t linea = previas[t].lineas;
+        uint64_t indice_dato = previas[t].lineas_datos;
+        std::string error;
+        Dia dia;
+        for (const char* p = cortes[t], *hasta = cortes[t + 1]; p < hasta;) {
+            std::string_view texto = siguienteLinea(p, hasta);
+            linea++;
+            if (!esLineaDeDatos(texto)) continue;
+            if (indice_dato++ % 2 == 1) continue;   // Otras fuentes de un día del tramo anterior
+
+            dia.numero = (indice_dato - 1) / 2;
+            dia.linea = linea;
+            bool valido = leerValoresHora(texto, dia.demanda, error);
+            if (!valido) {
+                errores[t].push_back({linea, "demanda: " + error});
+            }
+            // La línea de otras fuentes puede estar en el tramo siguiente
+            const char* q = p;
+            uint64_t linea_otras = linea;
+            std::string_view otras;
+            bool hay_otras = false;
+            while (q < fin && !hay_otras) {
+                otras = siguienteLinea(q, fin);
+                linea_otras++;
+                hay_otras = esLineaDeDatos(otras);
+            }
+            if (!hay_otras) {
+                errores[t].push_back({linea, "falta la línea de otras fuentes del día"});
+                continue;
+            }
+            if (!leerValoresHora(otras, dia.otras_fuentes, error)) {
+                errores[t].push_back({linea_otras, "otras fuentes: " + error});
+                valido = false;
+            }
+            if (!valido) continue;
+
+            dia.mascara_criticas = mascaraCriticas(dia.demanda, dia.otras_fuentes);
+            validos[t]++;
+            procesar(dia, hilo, salida);
+        }
+    };
+    pool.ejecutar(0, num_tramos, [&](const PoolBloques::Bloque& bloque, unsigned hilo, std::string& salida) {
+        for (uint32_t t = bloque.desde; t < bloque.hasta; t++) {
+            procesar_tramo(t, hilo, salida);
+        }
+    }, [&](const PoolBloques::Bloque& bloque, std::string& salida) {
+        for (uint32_t t = bloque.desde; t < bloque.hasta; t++) {
+            for (ErrorEscenario& error : errores[t]) {
+                resultado.errores.push_back(std::move(error));
+            }
+            resultado.dias_validos += validos[t];
+        }
+        emitir(salida);
+    });
+    return resultado;
+}
@@ -0,0 +1,195 @@
+#include "protocolo_solver.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <vector>
+
+// Cliente local de servidor_solver, para usarlo desde scripts y para medirlo.
+//
+// Uso: cliente_solver [--socket ruta]                  envía las líneas de stdin e imprime las respuestas
+//      cliente_solver [--socket ruta] --estadisticas   contadores y latencias del servidor
+//      cliente_solver [--socket ruta] --carga N [--conexiones C] [--semilla S]
+//                     N patrones al azar repartidos en C clientes que esperan cada respuesta
+//                     antes de mandar la siguiente; informa rendimiento y latencias
+
+namespace {
+using Reloj = std::chrono::steady_clock;
+
+int conectar(const std::string& ruta) {
+    sockaddr_un direccion{};
+    if (ruta.size() >= sizeof(direccion.sun_path)) {
+        throw std::invalid_argument("ruta de socket demasiado larga: " + ruta);
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    direccion.sun_family = AF_UNIX;
+    std::memcpy(direccion.sun_path, ruta.c_str(), ruta.size() + 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) != 0) {
+        if (fd >= 0) close(fd);
+        throw std::runtime_error("No se pudo conectar a " + ruta + ": " + std::strerror(errno));
+    }
+    return fd;
+}
+
+// Lectura de respuestas línea por línea
+class LectorLineas {
+private:
+    int fd_;
+    std::string buffer_;
+    size_t inicio_;
+
+public:
+    explicit LectorLineas(int fd) : fd_(fd), inicio_(0) {}
+
+    // Siguiente línea sin el '\n'; false si el servidor cerró la conexión
+    bool leer(std::string& linea) {
+        while (true) {
+            size_t salto = buffer_.find('\n', inicio_);
+            if (salto != std::string::npos) {
+                linea.assign(buffer_, inicio_, salto - inicio_);
+                inicio_ = salto + 1;
+                return true;
+            }
+            buffer_.erase(0, inicio_);
+            inicio_ = 0;
+            char datos[1 << 16];
+            ssize_t leidos = read(fd_, datos, sizeof(datos));
+            if (leidos < 0 && errno == EINTR) continue;
+            if (leidos <= 0) return false;
+            buffer_.append(datos, static_cast<size_t>(leidos));
+        }
+    }
+};
+
+// Reenvía stdin al servidor y las respuestas a stdout, en paralelo para no
+// esperar cada respuesta antes de mandar la siguiente consulta
+int reenviar(int fd) {
+    std::thread respuestas([fd] {
+        char datos[1 << 16];
+        ssize_t leidos;
+        while ((leidos = read(fd, datos, sizeof(datos))) > 0 || (leidos < 0 && errno == EINTR)) {
+            if (leidos > 0) escribirCompleto(STDOUT_FILENO, datos, static_cast<size_t>(leidos));
+        }
+    });
+    char datos[1 << 16];
+    ssize_t leidos;
+    bool enviado = true;
+    while (enviado && ((leidos = read(STDIN_FILENO, datos, sizeof(datos))) > 0 || (leidos < 0 && errno == EINTR))) {
+        if (leidos > 0) enviado = escribirCompleto(fd, datos, static_cast<size_t>(leidos));
+    }
+    shutdown(fd, SHUT_WR);
+    respuestas.join();
+    return enviado ? 0 : 1;
+}
+
+// Prueba de carga: cada cliente manda un patrón y espera su respuesta
+int medirCarga(const std::string& ruta, uint64_t consultas, unsigned conexiones, uint32_t semilla) {
+    std::vector<std::vector<double>> latencias(conexiones);
+    std::vector<uint64_t> errores(conexiones, 0);
+    std::vector<std::thread> clientes;
+    auto inicio = Reloj::now();
+    for (unsigned c = 0; c < conexiones; c++) {
+        uint64_t propias = consultas / conexiones + (c < consultas % conexiones);
+        int fd = conectar(ruta);
+        clientes.emplace_back([&, c, fd, propias] {
+            std::mt19937 generador(semilla + c);
+            LectorLineas lector(fd);
+            std::string consulta(25, '\n'), respuesta;
+            latencias[c].reserve(propias);
+            for (uint64_t i = 0; i < propias; i++) {
+                uint32_t patron = generador() & 0xFFFFFF;
+                for (int bit = 0; bit < 24; bit++) consulta[bit] = (patron >> (23 - bit)) & 1 ? '1' : '0';
+                auto envio = Reloj::now();
+                if (!escribirCompleto(fd, consulta.data(), consulta.size()) || !lector.leer(respuesta)) {
+                    errores[c]++;
+                    break;
+                }
+                latencias[c].push_back(std::chrono::duration<double, std::micro>(Reloj::now() - envio).count());
+                errores[c] += respuesta.compare(0, 6, "ERROR ") == 0;
+            }
+            close(fd);
+        });
+    }
+    for (std::thread& cliente : clientes) cliente.join();
+    double segundos = std::chrono::duration<double>(Reloj::now() - inicio).count();
+
+    std::vector<double> todas;
+    uint64_t total_errores = 0;
+    for (unsigned c = 0; c < conexiones; c++) {
+        todas.insert(todas.end(), latencias[c].begin(), latencias[c].end());
+        total_errores += errores[c];
+    }
+    std::sort(todas.begin(), todas.end());
+    auto percentil = [&](double p) {
+        return todas.empty() ? 0.0 : todas[std::min(todas.size() - 1, static_cast<size_t>(p / 100.0 * todas.size()))];
+    };
+    std::cout << "Consultas respondidas: " << todas.size() << " en " << conexiones << " conexión(es)"
+              << std::fixed << std::setprecision(2) << " (" << segundos << " s, "
+              << std::setprecision(0) << todas.size() / std::max(segundos, 1e-9) << " consultas/s)\n";
+    std::cout << std::setprecision(1) << "Latencia (µs): p50=" << percentil(50) << " p99=" << percentil(99)
+              << " max=" << (todas.empty() ? 0.0 : todas.back()) << "\n";
+    if (total_errores > 0) {
+        std::cout << "⚠️  Errores: " << total_errores << "\n";
+    }
+    return total_errores > 0 ? 1 : 0;
+}
+}
+
+int main(int argc, char* argv[]) {
+    std::string ruta = RUTA_SOCKET_SOLVER;
+    bool estadisticas = false;
+    uint64_t carga = 0;
+    unsigned conexiones = 1;
+    uint32_t semilla = 1;
+    signal(SIGPIPE, SIG_IGN);
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hay_valor = i + 1 < argc;
+            if (arg == "--socket" && hay_valor) {
+                ruta = argv[++i];
+            } else if (arg == "--estadisticas") {
+                estadisticas = true;
+            } else if (arg == "--carga" && hay_valor) {
+                carga = std::stoull(argv[++i]);
+            } else if (arg == "--conexiones" && hay_valor) {
+                conexiones = std::max(1ul, std::stoul(argv[++i]));
+            } else if (arg == "--semilla" && hay_valor) {
+                semilla = std::stoul(argv[++i]);
+            } else {
+                std::cerr << "Uso: " << argv[0] << " [--socket ruta] [--estadisticas | --carga N [--conexiones C] [--semilla S]]\n"
+                          << "Sin opciones envía las líneas de stdin e imprime las respuestas\n";
+                return 1;
+            }
+        }
+
+        if (carga > 0) {
+            return medirCarga(ruta, carga, conexiones, semilla);
+        }
+        int fd = conectar(ruta);
+        if (estadisticas) {
+            std::string consulta = std::string(CONSULTA_ESTADISTICAS) + "\n", respuesta;
+            LectorLineas lector(fd);
+            if (!escribirCompleto(fd, consulta.data(), consulta.size()) || !lector.leer(respuesta)) {
+                throw std::runtime_error("El servidor cerró la conexión");
+            }
+            close(fd);
+            std::cout << respuesta << "\n";
+            return 0;
+        }
+        int codigo = reenviar(fd);
+        close(fd);
+        return codigo;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
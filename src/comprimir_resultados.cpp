@@ -0,0 +1,147 @@
+#include "formato_columnar.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// Archiva los CSV de resultados en el formato columnar (ver formato_columnar.hpp)
+// y los recupera. Con --filtrar-costo solo se descomprimen los bloques cuyo
+// costo mínimo entra en el filtro.
+//
+// Uso: comprimir_resultados [--hilos N] [--filas-bloque N] [--sin-compresion] entrada.csv salida.col
+//      comprimir_resultados -d [--hilos N] entrada.col salida.csv
+//      comprimir_resultados --info entrada.col
+//      comprimir_resultados --filtrar-costo X entrada.col      (filas válidas con costo <= X)
+
+namespace {
+void mostrarUso(const char* programa) {
+    std::cerr << "Uso: " << programa << " [--hilos N] [--filas-bloque N] [--sin-compresion] entrada.csv salida.col\n"
+              << "     " << programa << " -d [--hilos N] entrada.col salida.csv\n"
+              << "     " << programa << " --info entrada.col\n"
+              << "     " << programa << " --filtrar-costo X entrada.col\n";
+}
+
+void mostrarInfo(const std::string& archivo) {
+    ArchivoColumnar columnar(archivo);
+    const CabeceraColumnar& cabecera = columnar.cabecera();
+    uint64_t validas = 0;
+    double costo_min = INFINITY, costo_max = -INFINITY;
+    int horas_min = 24, horas_max = 0;
+    for (const EstadisticasBloque& bloque : columnar.bloques()) {
+        validas += bloque.validas;
+        costo_min = std::min(costo_min, bloque.costo_min);
+        costo_max = std::max(costo_max, bloque.costo_max);
+        horas_min = std::min<int>(horas_min, bloque.horas_min);
+        horas_max = std::max<int>(horas_max, bloque.horas_max);
+    }
+    // Todo sale del directorio, sin descomprimir ningún bloque
+    std::cout << "Archivo: " << archivo << " (" << columnar.bytes() << " bytes)\n";
+    std::cout << "Columnas: " << columnar.columnas() << "\n";
+    std::cout << "Compresión: " << nombreCompresion(static_cast<CompresionColumnar>(cabecera.compresion)) << "\n";
+    std::cout << "Filas: " << cabecera.filas << " en " << cabecera.num_bloques << " bloques de hasta "
+              << cabecera.filas_por_bloque << "\n";
+    std::cout << "Soluciones válidas: " << validas << "\n";
+    if (validas > 0) {
+        std::cout << "Costo: " << std::fixed << std::setprecision(2) << costo_min << " - " << costo_max << "\n";
+    }
+    std::cout << "Horas críticas: " << horas_min << " - " << horas_max << "\n";
+}
+
+void filtrarCosto(const std::string& archivo, double costo_maximo) {
+    ArchivoColumnar columnar(archivo);
+    std::string salida = columnar.columnas() + "\n";
+    size_t leidos = 0;
+    for (size_t b = 0; b < columnar.bloques().size(); b++) {
+        if (!(columnar.bloques()[b].costo_min <= costo_maximo)) {
+            continue;
+        }
+        leidos++;
+        BloqueColumnar bloque = columnar.leerBloque(b);
+        for (size_t i = 0; i < bloque.filas(); i++) {
+            if (bloque.validas[i] && bloque.costo(i) <= costo_maximo) {
+                bloque.agregarFilaCsv(i, salida);
+            }
+        }
+        std::cout << salida;
+        salida.clear();
+    }
+    std::cerr << "Bloques descomprimidos: " << leidos << " de " << columnar.bloques().size() << "\n";
+}
+}
+
+int main(int argc, char* argv[]) {
+    OpcionesColumnar opciones;
+    bool descomprimir = false, info = false, filtrar = false;
+    double costo_maximo = 0.0;
+    std::string entrada, salida;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--hilos" && i + 1 < argc) {
+                opciones.num_hilos = std::stoul(argv[++i]);
+            } else if (arg == "--filas-bloque" && i + 1 < argc) {
+                opciones.filas_por_bloque = std::stoul(argv[++i]);
+            } else if (arg == "--sin-compresion") {
+                opciones.compresion = CompresionColumnar::NINGUNA;
+            } else if (arg == "-d") {
+                descomprimir = true;
+            } else if (arg == "--info") {
+                info = true;
+            } else if (arg == "--filtrar-costo" && i + 1 < argc) {
+                filtrar = true;
+                costo_maximo = std::stod(argv[++i]);
+            } else if (entrada.empty()) {
+                entrada = arg;
+            } else if (salida.empty()) {
+                salida = arg;
+            } else {
+                throw std::invalid_argument("argumento de más: " + arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        mostrarUso(argv[0]);
+        return 1;
+    }
+    if (entrada.empty() || (salida.empty() && !info && !filtrar)) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+
+    try {
+        if (info) {
+            mostrarInfo(entrada);
+            return 0;
+        }
+        if (filtrar) {
+            filtrarCosto(entrada, costo_maximo);
+            return 0;
+        }
+
+        auto inicio = std::chrono::steady_clock::now();
+        ResultadoColumnar resultado = descomprimir ? descomprimirResultados(entrada, salida, opciones.num_hilos)
+                                                   : comprimirResultados(entrada, salida, opciones);
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+        std::cout << (descomprimir ? "=== DESCOMPRESIÓN COLUMNAR ===\n" : "=== COMPRESIÓN COLUMNAR ===\n");
+        if (!descomprimir) {
+            std::cout << "Compresión: " << nombreCompresion(opciones.compresion) << "\n";
+        }
+        std::cout << "Filas: " << resultado.filas << " en " << resultado.bloques << " bloques\n";
+        std::cout << "Bytes: " << resultado.bytes_entrada << " -> " << resultado.bytes_salida;
+        if (!descomprimir && resultado.bytes_salida > 0) {
+            std::cout << " (" << std::fixed << std::setprecision(1)
+                      << double(resultado.bytes_entrada) / resultado.bytes_salida << "x)";
+        }
+        std::cout << "\n";
+        std::cout << "Tiempo: " << std::fixed << std::setprecision(2) << segundos << " s\n";
+        std::cout << "Guardado en: " << salida << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
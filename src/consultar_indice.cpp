@@ -0,0 +1,223 @@
+#include "cubo_resultados.hpp"
+#include "formato_csv.hpp"
+#include "indice_resultados.hpp"
+#include "lector_resultados.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Consultas sobre los índices de indexar_resultados. Cada criterio es una
+// búsqueda binaria sobre el índice mapeado; con varios criterios se intersectan
+// las listas de filas. Las filas se leen del origen (CSV o cubo) solo para
+// imprimirlas.
+//
+// Uso: consultar_indice archivo.idx [criterios] [--contar | --ids] [--limite N]
+//      consultar_indice archivo.idx --claves costo|transiciones|horas
+// Criterios: --costo X, --costo-rango A B, --transiciones P|nunca,
+//            --horas N, --horas-rango A B
+
+namespace {
+struct Criterio {
+    ClaveIndice clave;
+    uint32_t desde;
+    uint32_t hasta;
+};
+
+ClaveIndice claveDeNombre(const std::string& nombre) {
+    if (nombre == "costo") return ClaveIndice::COSTO;
+    if (nombre == "transiciones") return ClaveIndice::TRANSICIONES;
+    if (nombre == "horas") return ClaveIndice::HORAS_CRITICAS;
+    throw std::invalid_argument("índice desconocido: " + nombre + " (costo, transiciones u horas)");
+}
+
+uint32_t mascaraDeArgumento(const std::string& transiciones) {
+    uint32_t mascara = 0;
+    if (transiciones != "nunca" && !mascaraDeTransiciones(transiciones, mascara)) {
+        throw std::invalid_argument("cadena de transiciones inválida: " + transiciones);
+    }
+    return mascaraCanonica(mascara);
+}
+
+void imprimirClave(std::ostream& salida, ClaveIndice clave, uint32_t valor) {
+    if (clave == ClaveIndice::COSTO) {
+        salida << std::fixed << std::setprecision(2) << double(valor) / ESCALA_COSTO_INDICE;
+    } else if (clave == ClaveIndice::TRANSICIONES) {
+        char cadena[128];
+        char* fin = escribirTransicionesCsv(cadena, valor);
+        salida << (fin == cadena ? std::string("nunca") : std::string(cadena, fin));
+    } else {
+        salida << valor;
+    }
+}
+
+// Origen mapeado para copiar líneas del CSV
+class OrigenCsv {
+private:
+    const char* datos_;
+    size_t tam_;
+
+public:
+    explicit OrigenCsv(const std::string& archivo) : datos_(nullptr), tam_(0) {
+        int fd = open(archivo.c_str(), O_RDONLY);
+        struct stat info;
+        if (fd < 0 || fstat(fd, &info) != 0) {
+            if (fd >= 0) close(fd);
+            throw std::runtime_error("No se pudo abrir el origen del índice: " + archivo);
+        }
+        tam_ = static_cast<size_t>(info.st_size);
+        void* mapa = tam_ ? mmap(nullptr, tam_, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (mapa == MAP_FAILED) {
+            throw std::runtime_error("No se pudo mapear el origen del índice: " + archivo);
+        }
+        datos_ = static_cast<const char*>(mapa);
+    }
+    ~OrigenCsv() { munmap(const_cast<char*>(datos_), tam_); }
+    OrigenCsv(const OrigenCsv&) = delete;
+    OrigenCsv& operator=(const OrigenCsv&) = delete;
+
+    std::string_view linea(uint64_t posicion) const {
+        if (posicion >= tam_) return std::string_view();
+        const char* inicio = datos_ + posicion;
+        const char* salto = static_cast<const char*>(std::memchr(inicio, '\n', tam_ - posicion));
+        return std::string_view(inicio, static_cast<size_t>((salto ? salto : datos_ + tam_) - inicio));
+    }
+};
+
+void listarClaves(const IndiceResultados& indice, ClaveIndice clave) {
+    std::cout << "Clave,Filas\n";
+    for (uint32_t i = 0; i < indice.numClaves(clave); i++) {
+        imprimirClave(std::cout, clave, indice.clave(clave, i));
+        std::cout << "," << indice.filasDeClave(clave, i).size() << "\n";
+    }
+}
+}
+
+int main(int argc, char* argv[]) {
+    std::string archivo;
+    std::vector<Criterio> criterios;
+    bool contar = false, solo_ids = false, listar = false;
+    ClaveIndice clave_listada = ClaveIndice::COSTO;
+    uint64_t limite = std::numeric_limits<uint64_t>::max();
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hay_valor = i + 1 < argc, hay_dos = i + 2 < argc;
+            if (arg == "--costo" && hay_valor) {
+                uint32_t costo = claveCosto(std::stod(argv[++i]));
+                criterios.push_back({ClaveIndice::COSTO, costo, costo});
+            } else if (arg == "--costo-rango" && hay_dos) {
+                uint32_t desde = claveCosto(std::stod(argv[++i]));
+                criterios.push_back({ClaveIndice::COSTO, desde, claveCosto(std::stod(argv[++i]))});
+            } else if (arg == "--transiciones" && hay_valor) {
+                uint32_t mascara = mascaraDeArgumento(argv[++i]);
+                criterios.push_back({ClaveIndice::TRANSICIONES, mascara, mascara});
+            } else if (arg == "--horas" && hay_valor) {
+                uint32_t horas = std::stoul(argv[++i]);
+                criterios.push_back({ClaveIndice::HORAS_CRITICAS, horas, horas});
+            } else if (arg == "--horas-rango" && hay_dos) {
+                uint32_t desde = std::stoul(argv[++i]);
+                criterios.push_back({ClaveIndice::HORAS_CRITICAS, desde, static_cast<uint32_t>(std::stoul(argv[++i]))});
+            } else if (arg == "--claves" && hay_valor) {
+                listar = true;
+                clave_listada = claveDeNombre(argv[++i]);
+            } else if (arg == "--contar") {
+                contar = true;
+            } else if (arg == "--ids") {
+                solo_ids = true;
+            } else if (arg == "--limite" && hay_valor) {
+                limite = std::stoull(argv[++i]);
+            } else if (archivo.empty() && arg.compare(0, 2, "--") != 0) {
+                archivo = arg;
+            } else {
+                throw std::invalid_argument("opción desconocida o incompleta: " + arg);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    if (archivo.empty() || (criterios.empty() && !listar)) {
+        std::cerr << "Uso: " << argv[0] << " archivo.idx [criterios] [--contar | --ids] [--limite N]\n"
+                  << "     " << argv[0] << " archivo.idx --claves costo|transiciones|horas\n"
+                  << "Criterios: --costo X, --costo-rango A B, --transiciones P|nunca, --horas N, --horas-rango A B\n";
+        return 1;
+    }
+
+    try {
+        auto inicio = std::chrono::steady_clock::now();
+        IndiceResultados indice(archivo);
+        if (indice.desactualizado()) {
+            std::cerr << "⚠️  " << indice.rutaOrigen() << " cambió desde que se construyó el índice\n";
+        }
+        if (listar) {
+            listarClaves(indice, clave_listada);
+            return 0;
+        }
+
+        // Un solo criterio se responde con el tramo del índice tal cual (por
+        // clave creciente); con varios, se intersectan en orden de archivo
+        ListaFilas filas = indice.rango(criterios[0].clave, criterios[0].desde, criterios[0].hasta);
+        std::vector<uint32_t> interseccion;
+        if (criterios.size() > 1) {
+            interseccion.assign(filas.begin(), filas.end());
+            std::sort(interseccion.begin(), interseccion.end());
+            std::vector<uint32_t> otra, comunes;
+            for (size_t c = 1; c < criterios.size() && !interseccion.empty(); c++) {
+                ListaFilas lista = indice.rango(criterios[c].clave, criterios[c].desde, criterios[c].hasta);
+                otra.assign(lista.begin(), lista.end());
+                std::sort(otra.begin(), otra.end());
+                comunes.clear();
+                std::set_intersection(interseccion.begin(), interseccion.end(), otra.begin(), otra.end(),
+                                      std::back_inserter(comunes));
+                interseccion.swap(comunes);
+            }
+            filas = ListaFilas{interseccion.data(), interseccion.data() + interseccion.size()};
+        }
+        double microsegundos =
+            std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - inicio).count();
+
+        if (contar) {
+            std::cout << filas.size() << "\n";
+        } else if (solo_ids) {
+            uint64_t impresas = 0;
+            for (uint32_t fila : filas) {
+                if (impresas++ == limite) break;
+                std::cout << indice.id(fila) << "\n";
+            }
+        } else {
+            std::string salida = std::string(indice.cabecera().columnas) + "\n";
+            uint64_t impresas = 0;
+            if (indice.origen() == OrigenIndice::CSV) {
+                OrigenCsv origen(indice.rutaOrigen());
+                for (uint32_t fila : filas) {
+                    if (impresas++ == limite) break;
+                    std::string_view linea = origen.linea(indice.posicion(fila));
+                    salida.append(linea.data(), linea.size());
+                    salida += '\n';
+                }
+            } else {
+                CuboResultados cubo(indice.rutaOrigen());
+                char linea[MAX_FILA_CSV];
+                for (uint32_t fila : filas) {
+                    if (impresas++ == limite) break;
+                    uint32_t id = indice.id(fila);
+                    char* fin = escribirFilaSecuenciaCsv(linea, id, cubo.costo(id), cubo.valida(id),
+                                                         cubo.horasCriticas(id), cubo.secuencia(id));
+                    salida.append(linea, static_cast<size_t>(fin - linea));
+                }
+            }
+            std::cout << salida;
+        }
+        std::cerr << filas.size() << " fila(s) en " << std::fixed << std::setprecision(1) << microsegundos
+                  << " µs\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
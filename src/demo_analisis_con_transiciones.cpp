@@ -1,69 +1,62 @@
 #include "../include/calculador_costos.hpp"
 #include "../include/escenario.hpp"
+#include "../include/formato_csv.hpp"
+#include "../include/instrumentacion.hpp"
+#include "../include/resumen_agregado.hpp"
+#include "../include/shard_barrido.hpp"
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 #include <bitset>
 #include <chrono>
 #include <iomanip>
-#include <sstream>
+#include <memory>
+#include <stdexcept>
 
-// Función para verificar si un estado está "prendido" (ON)
-bool estaPrendido(EstadoMaquina estado) {
-    return estado == EstadoMaquina::ON_CALIENTE || 
-           estado == EstadoMaquina::ON_TIBIO || 
-           estado == EstadoMaquina::ON_FRIO;
-}
-
-// Función para generar la cadena de transiciones prender/apagar
-std::string generarTransiciones(const std::vector<EstadoMaquina>& estados) {
-    std::vector<int> transiciones;
-    bool estado_anterior_prendido = false;
-    
-    for (int hora = 0; hora < 24; hora++) {
-        bool estado_actual_prendido = estaPrendido(estados[hora]);
-        
-        if (hora == 0) {
-            // Primera hora: si está prendido, marcar hora 0
-            if (estado_actual_prendido) {
-                transiciones.push_back(0);
+int main(int argc, char* argv[]) {
+    // Opciones (sin opciones se lee la cantidad de combinaciones por stdin):
+    //   --shard i/N       procesar el tramo i (0 a N-1) de N, p. ej. un job array
+    //   --rango D H       procesar los IDs [D, H)
+    //   --total T         total que se reparte con --shard (por defecto 16777216)
+    //   --salida archivo  nombre del shard (por defecto resultados_demo_D_H.shard)
+    // Con --shard o --rango se escribe un shard autodescriptivo en lugar del CSV;
+    // fusionar_shards junta los shards en el CSV y el resumen completos.
+    bool modo_shard = false;
+    bool rango_explicito = false;
+    uint32_t indice_shard = 0;
+    uint32_t total_shards = 1;
+    uint32_t desde = 0;
+    uint32_t hasta = 0;
+    uint32_t total_repartir = 16777216;
+    std::string archivo_shard;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--shard" && i + 1 < argc) {
+                interpretarShard(argv[++i], indice_shard, total_shards);
+                modo_shard = true;
+            } else if (arg == "--rango" && i + 2 < argc) {
+                desde = std::stoul(argv[++i]);
+                hasta = std::stoul(argv[++i]);
+                rango_explicito = true;
+                modo_shard = true;
+            } else if (arg == "--total" && i + 1 < argc) {
+                total_repartir = std::min<uint32_t>(std::stoul(argv[++i]), 16777216);
+            } else if (arg == "--salida" && i + 1 < argc) {
+                archivo_shard = argv[++i];
+            } else {
+                throw std::invalid_argument("opción desconocida o incompleta: " + arg);
             }
-        } else {
-            // Detectar transiciones
-            if (!estado_anterior_prendido && estado_actual_prendido) {
-                // Transición OFF -> ON (prender)
-                transiciones.push_back(hora);
-            } else if (estado_anterior_prendido && !estado_actual_prendido) {
-                // Transición ON -> OFF (apagar)
-                transiciones.push_back(hora);
-            }
-        }
-        
-        estado_anterior_prendido = estado_actual_prendido;
-    }
-    
-    // Si termina prendido, agregar hora 23
-    if (estado_anterior_prendido && !transiciones.empty()) {
-        // Solo agregar 23 si no es la última transición ya registrada
-        if (transiciones.back() != 23) {
-            transiciones.push_back(23);
         }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
     }
-    
-    // Convertir a string
-    if (transiciones.empty()) {
-        return "";  // Nunca se prendió
-    }
-    
-    std::stringstream ss;
-    for (size_t i = 0; i < transiciones.size(); i++) {
-        if (i > 0) ss << "-";
-        ss << transiciones[i];
+    if (rango_explicito && (desde > hasta || hasta > 16777216)) {
+        std::cerr << "Error: --rango espera 0 <= D <= H <= 16777216\n";
+        return 1;
     }
     
-    return ss.str();
-}
-
-int main() {
     // Configuración silenciosa para procesamiento masivo
     std::cout << "=== ANALIZADOR MASIVO CON TRANSICIONES ===\n";
     
@@ -74,15 +67,56 @@ int main() {
     };
     
     uint32_t num_combinaciones;
-    std::cin >> num_combinaciones;
-    
-    if (num_combinaciones > 16777216) {
-        num_combinaciones = 16777216;
+    if (modo_shard) {
+        if (!rango_explicito) {
+            rangoDeShard(total_repartir, indice_shard, total_shards, desde, hasta);
+        }
+    } else {
+        std::cin >> num_combinaciones;
+        
+        if (num_combinaciones > 16777216) {
+            num_combinaciones = 16777216;
+        }
+        hasta = num_combinaciones;
     }
+    num_combinaciones = hasta - desde;
+    
+    // Resumen agregado calculado durante el barrido (memoria constante): reemplaza
+    // las pasadas de awk/sort de scripts/analizar_resultados.sh
+    auto resumen = std::make_unique<ResumenAgregado>();
     
     // Abrir archivo de resultados con nueva columna
-    std::ofstream archivo_resultados("resultados_demo.csv");
-    archivo_resultados << "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,Transiciones\n";
+    const std::string columnas = "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,Transiciones";
+    std::ofstream archivo_resultados;
+    MetadatosShard metadatos;
+    std::streamoff inicio_filas = 0;
+    if (modo_shard) {
+        metadatos.generador = "demo_analisis_con_transiciones";
+        metadatos.columnas = columnas;
+        metadatos.indice = indice_shard;
+        metadatos.total_shards = total_shards;
+        metadatos.desde = desde;
+        metadatos.hasta = hasta;
+        metadatos.parametros["demanda"] = listaValores(demanda_fija);
+        metadatos.parametros["costos"] = listaValores({1.0, 2.5, 5.0});
+        metadatos.parametros["eolica"] = "500";
+        
+        if (archivo_shard.empty()) {
+            archivo_shard = "resultados_demo_" + std::to_string(desde) + "_" + std::to_string(hasta) + ".shard";
+        }
+        archivo_resultados.open(archivo_shard, std::ios::binary);
+        if (!archivo_resultados.is_open()) {
+            std::cerr << "Error: no se pudo crear el shard " << archivo_shard << "\n";
+            return 1;
+        }
+        escribirCabeceraShard(archivo_resultados, metadatos, *resumen, false, 0);
+        inicio_filas = archivo_resultados.tellp();
+        std::cout << "Shard " << indice_shard << "/" << total_shards
+                  << ": combinaciones [" << desde << ", " << hasta << ")\n";
+    } else {
+        archivo_resultados.open("resultados_demo.csv");
+        archivo_resultados << columnas << "\n";
+    }
     
     auto inicio = std::chrono::steady_clock::now();
     double mejor_costo = std::numeric_limits<double>::infinity();
@@ -96,7 +130,11 @@ int main() {
     std::cout << "Procesando " << num_combinaciones << " combinaciones...\n";
     std::cout << "Progreso: [----------] 0%\n";
     
-    for (uint32_t combinacion = 0; combinacion < num_combinaciones; combinacion++) {
+    char fila[MAX_FILA_CSV];
+    for (uint32_t combinacion = desde; combinacion < hasta; combinacion++) {
+        // Todo lo que no cae en otra fase cuenta como armar el escenario
+        MEDIR_FASE(ESCENARIO);
+        
         // Convertir número a patrón binario
         std::bitset<24> patron_eolica(combinacion);
         
@@ -125,37 +163,43 @@ int main() {
             }
         }
         
-        // Generar cadena de transiciones
-        std::string transiciones = "";
-        if (solucion.es_valida) {
-            transiciones = generarTransiciones(solucion.estados_por_hora);
+        // Guardar resultado con la cadena de transiciones (desde la máscara de horas prendidas)
+        uint32_t mascara_encendido;
+        char* fin_fila;
+        {
+            MEDIR_FASE(FORMATO);
+            mascara_encendido = solucion.es_valida ? ResumenAgregado::mascaraEncendido(solucion.estados_por_hora) : 0;
+            fin_fila = escribirFilaTransicionesCsv(fila, combinacion, solucion.costo_total, solucion.es_valida,
+                                                   horas_criticas, mascara_encendido);
+        }
+        {
+            MEDIR_FASE(ESCRITURA);
+            archivo_resultados.write(fila, fin_fila - fila);
         }
         
-        // Guardar resultado con nueva columna
-        archivo_resultados << combinacion << "," 
-                          << patron_eolica << ","
-                          << std::fixed << std::setprecision(2) << solucion.costo_total << ","
-                          << (solucion.es_valida ? "SI" : "NO") << ","
-                          << horas_criticas << ","
-                          << transiciones << "\n";
-        
-        if (solucion.es_valida) {
-            soluciones_validas++;
-            suma_costos += solucion.costo_total;
-            if (solucion.costo_total < mejor_costo) {
-                mejor_costo = solucion.costo_total;
-                combinacion_optima = combinacion;
+        {
+            MEDIR_FASE(AGREGADO);
+            resumen->registrar(combinacion, solucion.es_valida, solucion.costo_total, horas_criticas, mascara_encendido);
+            
+            if (solucion.es_valida) {
+                soluciones_validas++;
+                suma_costos += solucion.costo_total;
+                if (solucion.costo_total < mejor_costo) {
+                    mejor_costo = solucion.costo_total;
+                    combinacion_optima = combinacion;
+                }
             }
         }
         
         // Mostrar progreso condensado
-        if ((combinacion + 1) % INTERVALO_REPORTE == 0 || combinacion + 1 == num_combinaciones) {
+        uint32_t procesadas = combinacion - desde + 1;
+        if (procesadas % INTERVALO_REPORTE == 0 || procesadas == num_combinaciones) {
             auto ahora = std::chrono::steady_clock::now();
             auto duracion = std::chrono::duration_cast<std::chrono::seconds>(ahora - inicio);
             
-            double porcentaje = (double)(combinacion + 1) / num_combinaciones * 100.0;
-            double tasa = (double)(combinacion + 1) / duracion.count();
-            double eta_segundos = (num_combinaciones - combinacion - 1) / tasa;
+            double porcentaje = (double)procesadas / num_combinaciones * 100.0;
+            double tasa = (double)procesadas / duracion.count();
+            double eta_segundos = (num_combinaciones - procesadas) / tasa;
             
             // Barra de progreso visual
             int barras_completas = (int)(porcentaje / 10);
@@ -167,7 +211,7 @@ int main() {
             
             std::cout << "\rProgreso: " << barra << " " 
                       << std::fixed << std::setprecision(1) << porcentaje << "% | "
-                      << "Casos: " << (combinacion + 1) << "/" << num_combinaciones << " | "
+                      << "Casos: " << procesadas << "/" << num_combinaciones << " | "
                       << "Válidos: " << soluciones_validas << " | "
                       << "Mejor: " << std::fixed << std::setprecision(1) << mejor_costo << " | "
                       << "Tasa: " << std::fixed << std::setprecision(0) << tasa << " c/s | "
@@ -194,9 +238,29 @@ int main() {
         double costo_promedio = suma_costos / soluciones_validas;
         std::cout << "Costo promedio: " << std::fixed << std::setprecision(2) << costo_promedio << "\n";
     }
+    escribirReporteFases(std::cout, num_combinaciones);
+    
+    if (modo_shard) {
+        // Reescribir la cabecera, ahora completa y con el resumen del tramo
+        uint64_t bytes_filas = static_cast<uint64_t>(archivo_resultados.tellp() - inicio_filas);
+        archivo_resultados.seekp(0);
+        escribirCabeceraShard(archivo_resultados, metadatos, *resumen, true, bytes_filas);
+        archivo_resultados.close();
+        if (!archivo_resultados) {
+            std::cerr << "Error: no se pudo completar el shard " << archivo_shard << "\n";
+            return 1;
+        }
+        std::cout << "Shard guardado en: " << archivo_shard << "\n";
+        return 0;
+    }
     
     archivo_resultados.close();
     std::cout << "Resultados con transiciones guardados en: resultados_demo.csv\n";
     
+    std::ofstream archivo_resumen("resumen_demo.txt");
+    resumen->imprimirReporte(archivo_resumen, std::numeric_limits<size_t>::max());
+    archivo_resumen.close();
+    std::cout << "Resumen agregado guardado en: resumen_demo.txt\n";
+    
     return 0;
 }
@@ -1,86 +1,558 @@
 #include "../include/calculador_costos.hpp"
 #include "../include/escenario.hpp"
+#include "../include/formato_csv.hpp"
+#include "../include/instrumentacion.hpp"
+#include "../include/pool_bloques.hpp"
+#include "../include/resumen_agregado.hpp"
+#include "../include/telemetria.hpp"
+#include "../include/topologia.hpp"
 #include <algorithm>
 #include <bitset>
 #include <chrono>
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <mpi.h>
-#include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
-// Función para verificar si un estado está "prendido" (ON)
-bool estaPrendido(EstadoMaquina estado) {
-  return estado == EstadoMaquina::ON_CALIENTE ||
-         estado == EstadoMaquina::ON_TIBIO || estado == EstadoMaquina::ON_FRIO;
-}
+// Estadísticas locales de un hilo, alineadas a línea de caché
+struct alignas(64) EstadisticasHilo {
+  double mejor_costo = std::numeric_limits<double>::infinity();
+  uint32_t combinacion_optima = 0;
+  uint32_t soluciones_validas = 0;
+  double suma_costos = 0.0;
+};
+
+// Resuelve una combinación y agrega su fila CSV a `salida` (si no es nula)
+// y/o la acumula en `resumen` (si no es nulo). `ranura` es el progreso en vivo
+// del hilo, que el hilo principal lee sin detenerlo.
+// Solo lee `demanda_fija`, así que la comparten todos los hilos de un mismo
+// dominio de memoria.
+void procesarCombinacion(uint32_t combinacion,
+                         const std::vector<double> &demanda_fija,
+                         std::string *salida, EstadisticasHilo &stats,
+                         RanuraTelemetria &ranura, ResumenAgregado *resumen) {
+  // Todo lo que no cae en otra fase cuenta como armar el escenario
+  MEDIR_FASE(ESCENARIO);
+
+  // Convertir número a patrón binario
+  std::bitset<24> patron_eolica(combinacion);
+
+  // Configurar escenario (SIN salida de debug)
+  Escenario escenario;
+  for (int hora = 0; hora < 24; hora++) {
+    escenario.setDemanda(hora, demanda_fija[hora]);
+    double energia_eolica = patron_eolica[23 - hora] ? 500.0 : 0.0;
+    escenario.setEnergiaOtrasFuentes(hora, energia_eolica);
+  }
 
-// Función para generar la cadena de transiciones prender/apagar
-std::string generarTransiciones(const std::vector<EstadoMaquina> &estados) {
-  std::vector<int> transiciones;
-  bool estado_anterior_prendido = false;
+  // Resolver sin escribir en std::cout (seguro con varios hilos)
+  CalculadorCostos calculador(escenario);
+  calculador.configurarCostos(1.0, 2.5, 5.0);
+  calculador.configurarSilencioso(true);
+  Solucion solucion = calculador.resolver();
 
+  // Contar horas críticas
+  int horas_criticas = 0;
   for (int hora = 0; hora < 24; hora++) {
-    bool estado_actual_prendido = estaPrendido(estados[hora]);
+    if (!escenario.demandaCubiertaConEO(hora)) {
+      horas_criticas++;
+    }
+  }
 
-    if (hora == 0) {
-      // Primera hora: si está prendido, marcar hora 0
-      if (estado_actual_prendido) {
-        transiciones.push_back(0);
-      }
-    } else {
-      // Detectar transiciones
-      if (!estado_anterior_prendido && estado_actual_prendido) {
-        // Transición OFF -> ON (prender)
-        transiciones.push_back(hora);
-      } else if (estado_anterior_prendido && !estado_actual_prendido) {
-        // Transición ON -> OFF (apagar)
-        transiciones.push_back(hora);
+  uint32_t mascara =
+      solucion.es_valida
+          ? ResumenAgregado::mascaraEncendido(solucion.estados_por_hora)
+          : 0;
+
+  if (salida) {
+    // Fila con la cadena de transiciones, escrita sin pasar por streams
+    MEDIR_FASE(FORMATO);
+    agregarFilaTransicionesCsv(*salida, combinacion, solucion.costo_total,
+                               solucion.es_valida, horas_criticas, mascara);
+  }
+
+  MEDIR_FASE(AGREGADO);
+  ranura.registrar(solucion.es_valida, solucion.costo_total);
+  if (resumen) {
+    resumen->registrar(combinacion, solucion.es_valida, solucion.costo_total,
+                       horas_criticas, mascara);
+  }
+
+  // Actualizar estadísticas locales
+  if (solucion.es_valida) {
+    stats.soluciones_validas++;
+    stats.suma_costos += solucion.costo_total;
+    // Los bloques no llegan en orden de ID: desempatar por el ID menor
+    if (solucion.costo_total < stats.mejor_costo ||
+        (solucion.costo_total == stats.mejor_costo &&
+         combinacion < stats.combinacion_optima)) {
+      stats.mejor_costo = solucion.costo_total;
+      stats.combinacion_optima = combinacion;
+    }
+  }
+}
+
+// Fases que se cronometran en cada proceso; el estudio de escalabilidad
+// (scripts/estudio_escalabilidad.sh) las compara entre configuraciones
+enum Fase { CALCULO, ESPERA, ESCRITURA, COMBINACION, REDUCCION, NUM_FASES };
+const char *const NOMBRES_FASES[NUM_FASES] = {"calculo", "espera", "escritura",
+                                              "combinacion", "reduccion"};
+
+using Reloj = std::chrono::steady_clock;
+
+double segundosDesde(Reloj::time_point inicio) {
+  return std::chrono::duration<double>(Reloj::now() - inicio).count();
+}
+
+// Lote de combinaciones procesado por un proceso y su ubicación dentro del
+// buffer de la ronda en curso
+struct Lote {
+  uint64_t desde;
+  uint64_t hasta;
+  uint64_t offset;
+  uint64_t bytes;
+};
+
+// Contadores de combinaciones repartidas, alojados en el proceso 0 (uno por
+// ronda, así no hace falta reiniciarlos). Cada proceso toma lotes con
+// MPI_Fetch_and_op; el tamaño se guía por lo que queda sin repartir en la
+// ronda (lotes grandes al principio, chicos al final)
+class RepartidorLotes {
+  MPI_Win ventana_;
+  uint32_t *contadores_;
+  uint32_t lote_minimo_;
+  int num_procesos_;
+
+  // Ronda en curso: [inicio_, fin_) y contador en la posición ronda_
+  uint32_t ronda_;
+  uint32_t inicio_;
+  uint32_t fin_;
+  uint32_t ultimo_visto_;
+
+public:
+  RepartidorLotes(uint32_t num_rondas, uint32_t lote_minimo, int rank,
+                  int num_procesos)
+      : contadores_(nullptr), lote_minimo_(lote_minimo),
+        num_procesos_(num_procesos), ronda_(0), inicio_(0), fin_(0),
+        ultimo_visto_(0) {
+    MPI_Aint tam = rank == 0 ? num_rondas * sizeof(uint32_t) : 0;
+    MPI_Win_allocate(tam, sizeof(uint32_t), MPI_INFO_NULL, MPI_COMM_WORLD,
+                     &contadores_, &ventana_);
+    if (rank == 0) {
+      std::fill(contadores_, contadores_ + num_rondas, 0);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Win_lock_all(0, ventana_);
+  }
+
+  ~RepartidorLotes() {
+    MPI_Win_unlock_all(ventana_);
+    MPI_Win_free(&ventana_);
+  }
+
+  void iniciarRonda(uint32_t ronda, uint32_t desde, uint32_t hasta) {
+    ronda_ = ronda;
+    inicio_ = desde;
+    fin_ = hasta;
+    ultimo_visto_ = 0;
+  }
+
+  // Toma el siguiente lote [desde, hasta); devuelve false si la ronda se agotó
+  bool siguiente(uint32_t &desde, uint32_t &hasta) {
+    uint32_t total = fin_ - inicio_;
+    if (ultimo_visto_ >= total) {
+      return false;
+    }
+    // El tamaño se calcula con el último valor visto del contador; aunque esté
+    // desactualizado, la suma atómica garantiza lotes disjuntos
+    uint32_t restante = total - ultimo_visto_;
+    uint32_t tam = std::max(lote_minimo_, restante / (2 * num_procesos_));
+
+    uint32_t anterior;
+    MPI_Fetch_and_op(&tam, &anterior, MPI_UINT32_T, 0, ronda_, MPI_SUM,
+                     ventana_);
+    MPI_Win_flush(0, ventana_);
+
+    // Al final varios procesos pueden pasarse del total: se recorta el lote
+    if (anterior >= total) {
+      ultimo_visto_ = total;
+      return false;
+    }
+    ultimo_visto_ = (uint32_t)std::min<uint64_t>((uint64_t)anterior + tam, total);
+    desde = inicio_ + anterior;
+    hasta = inicio_ + ultimo_visto_;
+    return true;
+  }
+};
+
+// Progreso de todos los procesos, alojado en el proceso 0: una fila por
+// proceso (procesadas, válidas, mejor costo, tasa). Cada proceso reemplaza su
+// fila con MPI_Accumulate como mucho una vez por intervalo y el proceso 0 las
+// lee con MPI_Get_accumulate; nadie espera a nadie, así que el bucle de
+// cálculo no gana ninguna barrera
+class TelemetriaMPI {
+  static const int CAMPOS = 4;
+  MPI_Win ventana_;
+  double *filas_;
+  int rank_;
+  int num_procesos_;
+  Reloj::duration intervalo_;
+  Reloj::time_point inicio_;
+  Reloj::time_point ultima_;
+
+public:
+  TelemetriaMPI(int rank, int num_procesos, std::chrono::milliseconds intervalo)
+      : filas_(nullptr), rank_(rank), num_procesos_(num_procesos),
+        intervalo_(intervalo), inicio_(Reloj::now()), ultima_(inicio_) {
+    MPI_Aint tam = rank == 0 ? num_procesos * CAMPOS * sizeof(double) : 0;
+    MPI_Win_allocate(tam, sizeof(double), MPI_INFO_NULL, MPI_COMM_WORLD,
+                     &filas_, &ventana_);
+    if (rank == 0) {
+      for (int r = 0; r < num_procesos; r++) {
+        LecturaTelemetria vacia;
+        double *fila = filas_ + r * CAMPOS;
+        fila[0] = 0.0;
+        fila[1] = 0.0;
+        fila[2] = vacia.mejor_costo;
+        fila[3] = 0.0;
       }
     }
+    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Win_lock_all(0, ventana_);
+  }
 
-    estado_anterior_prendido = estado_actual_prendido;
+  ~TelemetriaMPI() {
+    MPI_Win_unlock_all(ventana_);
+    MPI_Win_free(&ventana_);
   }
 
-  // Si termina prendido, agregar hora 23
-  if (estado_anterior_prendido && !transiciones.empty()) {
-    // Solo agregar 23 si no es la última transición ya registrada
-    if (transiciones.back() != 23) {
-      transiciones.push_back(23);
+  // Reemplaza la fila de este proceso si ya pasó el intervalo (o si se
+  // fuerza); devuelve true si publicó
+  bool publicar(LecturaTelemetria local, bool forzar) {
+    auto ahora = Reloj::now();
+    if (!forzar && ahora - ultima_ < intervalo_) {
+      return false;
     }
+    ultima_ = ahora;
+    double segundos = std::chrono::duration<double>(ahora - inicio_).count();
+    double fila[CAMPOS] = {(double)local.procesadas, (double)local.validas,
+                           local.mejor_costo,
+                           segundos > 0 ? local.procesadas / segundos : 0.0};
+    MPI_Accumulate(fila, CAMPOS, MPI_DOUBLE, 0, rank_ * CAMPOS, CAMPOS,
+                   MPI_DOUBLE, MPI_REPLACE, ventana_);
+    MPI_Win_flush(0, ventana_);
+    return true;
   }
 
-  // Convertir a string
-  if (transiciones.empty()) {
-    return ""; // Nunca se prendió
+  // Última fila publicada por cada proceso (solo tiene sentido en el 0)
+  std::vector<LecturaTelemetria> leer() {
+    std::vector<double> filas(num_procesos_ * CAMPOS);
+    MPI_Get_accumulate(nullptr, 0, MPI_DOUBLE, filas.data(), filas.size(),
+                       MPI_DOUBLE, 0, 0, filas.size(), MPI_DOUBLE, MPI_NO_OP,
+                       ventana_);
+    MPI_Win_flush(0, ventana_);
+    std::vector<LecturaTelemetria> lecturas(num_procesos_);
+    for (int r = 0; r < num_procesos_; r++) {
+      const double *fila = filas.data() + r * CAMPOS;
+      lecturas[r].procesadas = (uint64_t)fila[0];
+      lecturas[r].validas = (uint64_t)fila[1];
+      lecturas[r].mejor_costo = fila[2];
+      lecturas[r].tasa = fila[3];
+    }
+    return lecturas;
+  }
+};
+
+// Escritura de las filas de cada ronda, solapada con el cálculo de la
+// siguiente. Para ubicar sus lotes cada proceso necesita el tamaño de todos
+// los lotes de la ronda (los repartió el contador compartido), así que se
+// intercambian con colectivas no bloqueantes (MPI_Iallgather de la cantidad y
+// MPI_Iallgatherv de los lotes) y cada proceso escribe los suyos con
+// MPI_File_iwrite_at, sin operación colectiva sobre el archivo. avanzar() se
+// llama entre bloques para que el intercambio progrese; un proceso solo se
+// detiene si al entregar una ronda la anterior todavía no terminó, así los
+// procesos van como mucho una ronda desfasados en vez de en paso fijo.
+// Solo se usa desde el hilo principal (MPI_THREAD_FUNNELED)
+class EscritorRondas {
+  // Cada escritura se parte en tramos que entran en el `int` de MPI
+  static constexpr uint64_t MAX_BYTES_ESCRITURA = 1u << 30;
+
+  enum Etapa { LIBRE, CANTIDADES, LOTES, FILAS };
+
+  MPI_File archivo_;
+  MPI_Datatype tipo_lote_;
+  Etapa etapa_;
+  uint64_t base_;                    // Offset en el archivo de la ronda pendiente
+  std::string buffer_;               // Filas de la ronda pendiente
+  std::vector<Lote> lotes_;          // Sus lotes propios, en orden creciente
+  int num_lotes_local_;
+  std::vector<int> num_lotes_;       // Lotes de cada proceso
+  std::vector<int> desplazamientos_;
+  std::vector<Lote> todos_;
+  std::vector<MPI_Request> pedidos_;
+
+  // La etapa en curso terminó: lanza la siguiente
+  void siguienteEtapa() {
+    pedidos_.clear();
+    if (etapa_ == CANTIDADES) {
+      // Los lotes son de al menos una combinación y el barrido no pasa de
+      // 2^24 combinaciones: las cuentas en lotes (no en bytes) caben en int
+      int total = 0;
+      for (size_t r = 0; r < num_lotes_.size(); r++) {
+        desplazamientos_[r] = total;
+        total += num_lotes_[r];
+      }
+      todos_.resize(total);
+      pedidos_.emplace_back();
+      MPI_Iallgatherv(lotes_.data(), num_lotes_local_, tipo_lote_,
+                      todos_.data(), num_lotes_.data(),
+                      desplazamientos_.data(), tipo_lote_, MPI_COMM_WORLD,
+                      &pedidos_.back());
+      etapa_ = LOTES;
+    } else if (etapa_ == LOTES) {
+      // Suma de prefijos en orden de combinacion_id: offset de cada lote
+      std::sort(todos_.begin(), todos_.end(),
+                [](const Lote &a, const Lote &b) { return a.desde < b.desde; });
+      std::vector<uint64_t> offsets_archivo(todos_.size());
+      uint64_t acumulado = base_;
+      for (size_t i = 0; i < todos_.size(); i++) {
+        offsets_archivo[i] = acumulado;
+        acumulado += todos_[i].bytes;
+      }
+      for (const Lote &lote : lotes_) {
+        size_t pos = std::lower_bound(todos_.begin(), todos_.end(), lote,
+                                      [](const Lote &a, const Lote &b) {
+                                        return a.desde < b.desde;
+                                      }) -
+                     todos_.begin();
+        for (uint64_t hecho = 0; hecho < lote.bytes;) {
+          uint64_t tramo = std::min(lote.bytes - hecho, MAX_BYTES_ESCRITURA);
+          pedidos_.emplace_back();
+          MPI_File_iwrite_at(archivo_, offsets_archivo[pos] + hecho,
+                             buffer_.data() + lote.offset + hecho, (int)tramo,
+                             MPI_BYTE, &pedidos_.back());
+          hecho += tramo;
+        }
+      }
+      base_ = acumulado;
+      etapa_ = FILAS;
+    } else {
+      etapa_ = LIBRE;
+    }
   }
 
-  std::stringstream ss;
-  for (size_t i = 0; i < transiciones.size(); i++) {
-    if (i > 0)
-      ss << "-";
-    ss << transiciones[i];
+public:
+  EscritorRondas(MPI_File archivo, uint64_t base, int num_procesos)
+      : archivo_(archivo), etapa_(LIBRE), base_(base), num_lotes_local_(0),
+        num_lotes_(num_procesos), desplazamientos_(num_procesos) {
+    MPI_Type_contiguous(sizeof(Lote) / sizeof(uint64_t), MPI_UINT64_T,
+                        &tipo_lote_);
+    MPI_Type_commit(&tipo_lote_);
   }
 
-  return ss.str();
+  ~EscritorRondas() { MPI_Type_free(&tipo_lote_); }
+
+  // Toma las filas y los lotes de la ronda que acaba de terminar (espera
+  // antes a que se escriba la anterior). Devuelve en `lotes` y `buffer` los
+  // de la ronda ya escrita, para reutilizar su memoria
+  void entregar(std::vector<Lote> &lotes, std::string &buffer,
+                double tiempos[NUM_FASES]) {
+    terminar(tiempos);
+    lotes_.swap(lotes);
+    buffer_.swap(buffer);
+    num_lotes_local_ = lotes_.size();
+    pedidos_.emplace_back();
+    MPI_Iallgather(&num_lotes_local_, 1, MPI_INT, num_lotes_.data(), 1,
+                   MPI_INT, MPI_COMM_WORLD, &pedidos_.back());
+    etapa_ = CANTIDADES;
+  }
+
+  // Hace progresar la ronda pendiente sin bloquear
+  void avanzar() {
+    while (etapa_ != LIBRE) {
+      int listo;
+      MPI_Testall(pedidos_.size(), pedidos_.data(), &listo,
+                  MPI_STATUSES_IGNORE);
+      if (!listo) {
+        return;
+      }
+      siguienteEtapa();
+    }
+  }
+
+  // Espera a que la ronda pendiente quede escrita. Esperar el intercambio es
+  // esperar a los procesos más lentos: se cuenta como espera y el resto como
+  // escritura
+  void terminar(double tiempos[NUM_FASES]) {
+    while (etapa_ != LIBRE) {
+      auto inicio = Reloj::now();
+      Fase fase = etapa_ == FILAS ? ESCRITURA : ESPERA;
+      MPI_Waitall(pedidos_.size(), pedidos_.data(), MPI_STATUSES_IGNORE);
+      siguienteEtapa();
+      tiempos[fase] += segundosDesde(inicio);
+    }
+  }
+};
+
+// Más hilos por proceso que esto es casi seguro un error de tipeo (p. ej.
+// --hilos -1)
+const uint32_t MAX_HILOS_POR_PROCESO = 4096;
+
+// Valor numérico de una opción en [minimo, maximo]; std::stoul acepta "-1"
+// (da un valor enorme), así que el signo se rechaza antes
+uint32_t leerOpcion(const std::string &texto, const std::string &opcion,
+                    uint32_t minimo, uint32_t maximo) {
+  try {
+    size_t usados = 0;
+    unsigned long valor =
+        texto.empty() || texto[0] == '-' ? 0 : std::stoul(texto, &usados);
+    if (usados > 0 && usados == texto.size() && valor >= minimo &&
+        valor <= maximo) {
+      return static_cast<uint32_t>(valor);
+    }
+  } catch (const std::exception &) {
+  }
+  throw std::invalid_argument("valor inválido para " + opcion + ": '" + texto +
+                              "' (debe estar entre " + std::to_string(minimo) +
+                              " y " + std::to_string(maximo) + ")");
+}
+
+// Operador de reducción MPI: combina resúmenes copiados como bytes
+void combinarResumenesMPI(void *entrada, void *entrada_salida, int *cantidad,
+                          MPI_Datatype *) {
+  const ResumenAgregado *origen = static_cast<const ResumenAgregado *>(entrada);
+  ResumenAgregado *destino = static_cast<ResumenAgregado *>(entrada_salida);
+  for (int i = 0; i < *cantidad; i++) {
+    destino[i].combinar(origen[i]);
+  }
 }
 
 int main(int argc, char *argv[]) {
-  // Inicializar MPI
-  MPI_Init(&argc, &argv);
+  // Inicializar MPI: solo el hilo principal hace llamadas MPI
+  int nivel_hilos;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &nivel_hilos);
 
   int rank, size;
   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
   MPI_Comm_size(MPI_COMM_WORLD, &size);
 
+  // Opciones: --hilos N (hilos por proceso, 0 = todos los núcleos)
+  //           --bloque N (combinaciones por bloque del pool)
+  //           --lote-min N (tamaño mínimo de lote del reparto dinámico)
+  //           --ronda N (combinaciones por ronda de escritura)
+  //           --solo-resumen (sin filas: solo el resumen agregado)
+  //           --tiempos ARCHIVO (agrega una línea JSON con los tiempos por fase)
+  //           --metricas ARCHIVO (progreso global en formato de Prometheus)
+  //           --intervalo-metricas MS (cada cuánto se publica el progreso)
+  //           --afinidad (atar los hilos a CPUs por nodo NUMA y reportar cada nodo)
+  unsigned num_hilos = 1;
+  uint32_t tam_bloque = 4096;
+  uint32_t lote_minimo = 0;
+  uint32_t tam_ronda = 1u << 20;
+  bool solo_resumen = false;
+  std::string archivo_tiempos;
+  std::string archivo_metricas;
+  uint32_t intervalo_metricas = 1000;
+  bool afinidad = false;
+  try {
+    for (int i = 1; i < argc; i++) {
+      std::string arg = argv[i];
+      if (arg == "--hilos" && i + 1 < argc) {
+        num_hilos = leerOpcion(argv[++i], arg, 0, MAX_HILOS_POR_PROCESO);
+      } else if (arg == "--bloque" && i + 1 < argc) {
+        tam_bloque = leerOpcion(argv[++i], arg, 1, UINT32_MAX);
+      } else if (arg == "--lote-min" && i + 1 < argc) {
+        lote_minimo = leerOpcion(argv[++i], arg, 0, UINT32_MAX);
+      } else if (arg == "--ronda" && i + 1 < argc) {
+        tam_ronda = leerOpcion(argv[++i], arg, 1, UINT32_MAX);
+      } else if (arg == "--solo-resumen") {
+        solo_resumen = true;
+      } else if (arg == "--tiempos" && i + 1 < argc) {
+        archivo_tiempos = argv[++i];
+      } else if (arg == "--metricas" && i + 1 < argc) {
+        archivo_metricas = argv[++i];
+      } else if (arg == "--intervalo-metricas" && i + 1 < argc) {
+        intervalo_metricas = leerOpcion(argv[++i], arg, 1, UINT32_MAX);
+      } else if (arg == "--afinidad") {
+        afinidad = true;
+      } else {
+        throw std::invalid_argument("opción desconocida o incompleta: " + arg);
+      }
+    }
+  } catch (const std::exception &e) {
+    // Todos los procesos leen los mismos argumentos y fallan juntos: salen
+    // de forma ordenada, sin que un MPI_Abort corte el mensaje del proceso 0
+    if (rank == 0) {
+      std::cerr << "Error: " << e.what() << "\n";
+    }
+    MPI_Finalize();
+    return 1;
+  }
+
+  if (nivel_hilos < MPI_THREAD_FUNNELED && num_hilos != 1) {
+    if (rank == 0) {
+      std::cerr << "Advertencia: la implementación MPI no soporta "
+                   "MPI_THREAD_FUNNELED, se usa 1 hilo por proceso\n";
+    }
+    num_hilos = 1;
+  }
+
+  PoolBloques pool(num_hilos, tam_bloque);
+
+  // Afinidad: si el lanzador no ató los procesos (todos los de un nodo ven
+  // las mismas CPUs), se reparten las CPUs del nodo por dominio; si ya los
+  // ató (p. ej. mpirun --bind-to socket), cada uno usa las que le dieron.
+  // El hilo principal queda en las CPUs de su proceso, así el buffer de la
+  // ronda también se reserva cerca
+  Topologia topologia;
+  if (afinidad) {
+    MPI_Comm comm_nodo;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+                        MPI_INFO_NULL, &comm_nodo);
+    int rank_nodo, procesos_nodo;
+    MPI_Comm_rank(comm_nodo, &rank_nodo);
+    MPI_Comm_size(comm_nodo, &procesos_nodo);
+
+    topologia = Topologia::detectar();
+    unsigned long long firma =
+        std::hash<std::string>()(formatearListaCpus(topologia.cpus()));
+    unsigned long long firma_min, firma_max;
+    MPI_Allreduce(&firma, &firma_min, 1, MPI_UNSIGNED_LONG_LONG, MPI_MIN,
+                  comm_nodo);
+    MPI_Allreduce(&firma, &firma_max, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX,
+                  comm_nodo);
+    if (firma_min == firma_max) {
+      topologia = topologia.repartir(rank_nodo, procesos_nodo);
+    }
+    MPI_Comm_free(&comm_nodo);
+
+    fijarHiloActual(topologia.cpus());
+    aplicarAfinidad(pool, topologia);
+  }
+
+  // Por defecto, un lote mínimo da al menos un bloque a cada hilo
+  if (lote_minimo == 0) {
+    lote_minimo = pool.getTamBloque() * pool.getNumHilos();
+  }
+
   uint32_t num_combinaciones = 0;
 
   // Solo el proceso 0 lee la entrada
   if (rank == 0) {
     std::cout << "=== ANALIZADOR MASIVO CON TRANSICIONES (MPI) ===\n";
-    std::cout << "Procesos MPI: " << size << "\n";
+    std::cout << "Procesos MPI: " << size << " | Hilos por proceso: "
+              << pool.getNumHilos() << "\n";
+    if (afinidad) {
+      std::cout << "Afinidad del proceso 0 por " << topologia.describir()
+                << "\n";
+    }
     std::cin >> num_combinaciones;
 
     if (num_combinaciones > 16777216) {
@@ -93,23 +565,26 @@ int main(int argc, char *argv[]) {
   // Broadcast del número de combinaciones a todos los procesos
   MPI_Bcast(&num_combinaciones, 1, MPI_UINT32_T, 0, MPI_COMM_WORLD);
 
-  // Calcular el rango de combinaciones para cada proceso
-  uint32_t combinaciones_por_proceso = num_combinaciones / size;
-  uint32_t resto = num_combinaciones % size;
-
-  uint32_t inicio_local =
-      rank * combinaciones_por_proceso + std::min((uint32_t)rank, resto);
-  uint32_t fin_local =
-      inicio_local + combinaciones_por_proceso + (rank < resto ? 1 : 0);
-  uint32_t num_locales = fin_local - inicio_local;
+  // El archivo final se escribe directamente con MPI-IO, sin temporales
+  // (en modo resumen no se escribe ninguna fila)
+  MPI_File archivo = MPI_FILE_NULL;
+  const std::string encabezado = "CombinacionID,PatronEolica,CostoTotal,"
+                                 "SolucionValida,HorasCriticas,Transiciones\n";
+  if (!solo_resumen) {
+    if (MPI_File_open(MPI_COMM_WORLD, "resultados_demo.csv",
+                      MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+                      &archivo) != MPI_SUCCESS) {
+      if (rank == 0) {
+        std::cerr << "Error: No se pudo crear resultados_demo.csv" << std::endl;
+      }
+      MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_File_set_size(archivo, 0);
 
-  // Abrir archivo temporal inmediatamente para escribir resultados
-  std::string archivo_temp = "resultados_temp_" + std::to_string(rank) + ".csv";
-  std::ofstream archivo_local(archivo_temp);
-  
-  if (!archivo_local.is_open()) {
-    std::cerr << "Error: No se pudo crear archivo temporal: " << archivo_temp << std::endl;
-    MPI_Abort(MPI_COMM_WORLD, 1);
+    if (rank == 0) {
+      MPI_File_write_at(archivo, 0, encabezado.data(), encabezado.size(),
+                        MPI_BYTE, MPI_STATUS_IGNORE);
+    }
   }
 
   // Demanda fija según especificación del usuario
@@ -117,129 +592,246 @@ int main(int argc, char *argv[]) {
       300,  200, 100, 100, 100, 200,  300,  500,  800, 1000, 1000, 1000,
       1000, 900, 800, 800, 800, 1000, 1000, 1000, 600, 600,  400,  300};
 
-  auto inicio = std::chrono::steady_clock::now();
-
-  // Variables locales para estadísticas
-  double mejor_costo_local = std::numeric_limits<double>::infinity();
-  uint32_t combinacion_optima_local = 0;
-  uint32_t soluciones_validas_local = 0;
-  double suma_costos_local = 0.0;
-
-  // Procesar las combinaciones asignadas a este proceso
-  const uint32_t INTERVALO_REPORTE = std::max(100U, num_locales / 10);
-
-  for (uint32_t i = 0; i < num_locales; i++) {
-    uint32_t combinacion = inicio_local + i;
-
-    // Convertir número a patrón binario
-    std::bitset<24> patron_eolica(combinacion);
+  auto inicio = Reloj::now();
+  double tiempos[NUM_FASES] = {};
+
+  // Procesar los lotes asignados a este proceso: los hilos del pool
+  // resuelven bloques y el hilo principal los junta en orden en el buffer de
+  // la ronda, que se escribe mientras se calcula la siguiente
+  std::vector<std::unique_ptr<EstadisticasHilo>> stats_hilos(
+      pool.getNumHilos());
+  std::vector<std::unique_ptr<ResumenAgregado>> resumenes_hilos(
+      solo_resumen ? pool.getNumHilos() : 0);
+  std::vector<std::vector<double>> demanda_por_dominio(
+      afinidad ? topologia.dominios().size() : 1);
+
+  // Con afinidad, lo que escribe cada hilo (estadísticas, resumen) y la copia
+  // de la demanda de cada dominio se reservan desde un hilo de ese dominio:
+  // la primera escritura deja sus páginas en la memoria del nodo
+  auto enDominio = [&](unsigned dominio, const std::function<void()> &reservar) {
+    if (afinidad) {
+      ejecutarEnDominio(topologia, dominio, reservar);
+    } else {
+      reservar();
+    }
+  };
+  for (unsigned d = 0; d < demanda_por_dominio.size(); d++) {
+    enDominio(d, [&, d] { demanda_por_dominio[d] = demanda_fija; });
+  }
+  for (unsigned h = 0; h < pool.getNumHilos(); h++) {
+    enDominio(pool.dominioDeHilo(h), [&, h] {
+      stats_hilos[h] = std::make_unique<EstadisticasHilo>();
+      if (solo_resumen) {
+        resumenes_hilos[h] = std::make_unique<ResumenAgregado>();
+      }
+    });
+  }
+  TelemetriaHilos telemetria_hilos(pool.getNumHilos());
+
+  auto procesar = [&](const PoolBloques::Bloque &bloque, unsigned hilo,
+                      std::string &salida) {
+    const std::vector<double> &demanda =
+        demanda_por_dominio[pool.dominioDeHilo(hilo)];
+    for (uint32_t combinacion = bloque.desde; combinacion < bloque.hasta;
+         combinacion++) {
+      if (solo_resumen) {
+        procesarCombinacion(combinacion, demanda, nullptr,
+                            *stats_hilos[hilo], telemetria_hilos.ranura(hilo),
+                            resumenes_hilos[hilo].get());
+      } else {
+        procesarCombinacion(combinacion, demanda, &salida,
+                            *stats_hilos[hilo], telemetria_hilos.ranura(hilo),
+                            nullptr);
+      }
+    }
+  };
+
+  // Progreso global: cada proceso publica su total cuando vence el intervalo
+  // y el proceso 0, al publicar el suyo, muestra el de todos y reescribe el
+  // archivo de métricas. Se llama solo desde el hilo principal
+  // (MPI_THREAD_FUNNELED), entre bloques
+  std::unique_ptr<TelemetriaMPI> telemetria;
+  EstimadorAvance avance;
+  uint32_t ronda_actual = 0, num_rondas = 0;
+  auto informarProgreso = [&](bool forzar) {
+    if (!telemetria->publicar(telemetria_hilos.leerTotal(), forzar) ||
+        rank != 0) {
+      return;
+    }
+    MetricasBarrido metricas;
+    metricas.programa = "demo_analisis_con_transiciones_mpi";
+    metricas.etiqueta_fuente = "proceso";
+    metricas.total = num_combinaciones;
+    metricas.segundos = avance.segundos();
+    metricas.fuentes = telemetria->leer();
+    for (const LecturaTelemetria &proceso : metricas.fuentes) {
+      metricas.global.combinar(proceso);
+    }
+    avance.actualizar(metricas.global.procesadas);
+    metricas.global.tasa = avance.tasa();
+    metricas.eta = avance.eta(metricas.global.procesadas, metricas.total);
+
+    double porcentaje = num_combinaciones > 0
+        ? (double)metricas.global.procesadas / num_combinaciones * 100.0
+        : 100.0;
+    std::cout << "\rProgreso: " << std::fixed << std::setprecision(1)
+              << porcentaje << "% | "
+              << "Casos: " << metricas.global.procesadas << "/"
+              << num_combinaciones << " | "
+              << "Ronda: " << std::min(ronda_actual + 1, num_rondas) << "/"
+              << num_rondas << " | "
+              << "Tasa: " << std::setprecision(0) << metricas.global.tasa
+              << " c/s | ETA: ";
+    if (metricas.eta < 0) {
+      std::cout << "--";
+    } else {
+      std::cout << (int)metricas.eta << " s";
+    }
+    std::cout << std::flush;
 
-    // Configurar escenario (SIN salida de debug)
-    Escenario escenario;
-    for (int hora = 0; hora < 24; hora++) {
-      escenario.setDemanda(hora, demanda_fija[hora]);
-      double energia_eolica = patron_eolica[23 - hora] ? 500.0 : 0.0;
-      escenario.setEnergiaOtrasFuentes(hora, energia_eolica);
+    if (!archivo_metricas.empty() &&
+        !escribirMetricasPrometheus(archivo_metricas, metricas)) {
+      std::cerr << "\nError: No se pudo escribir " << archivo_metricas << "\n";
+      archivo_metricas.clear();
+    }
+  };
+
+  std::string buffer_ronda;
+  std::vector<Lote> lotes_ronda;
+  std::unique_ptr<EscritorRondas> escritor;
+  auto emitir = [&](const PoolBloques::Bloque &, const std::string &salida) {
+    buffer_ronda += salida;
+    if (escritor) {
+      escritor->avanzar();
     }
+    informarProgreso(false);
+  };
+
+  // El rango se recorre en rondas para acotar la memoria de los buffers (la
+  // ronda en cálculo y la que se está escribiendo). Dentro de cada ronda el
+  // reparto es dinámico: cada proceso pide lotes al contador compartido, así
+  // los nodos rápidos no esperan a los lentos
+  num_rondas = (num_combinaciones + tam_ronda - 1) / tam_ronda;
+  if (!solo_resumen) {
+    escritor = std::make_unique<EscritorRondas>(archivo, encabezado.size(),
+                                                size);
+  }
+  {
+    // Las ventanas RMA de los contadores y del progreso se liberan al salir
+    // de este bloque
+    RepartidorLotes repartidor(std::max(1U, num_rondas), lote_minimo, rank,
+                               size);
+    telemetria = std::make_unique<TelemetriaMPI>(
+        rank, size, std::chrono::milliseconds(intervalo_metricas));
+    avance.reiniciar();
+    for (uint32_t ronda = 0; ronda < num_rondas; ronda++) {
+      ronda_actual = ronda;
+      uint32_t inicio_ronda = ronda * tam_ronda;
+      uint32_t fin_ronda = std::min(num_combinaciones, inicio_ronda + tam_ronda);
+      repartidor.iniciarRonda(ronda, inicio_ronda, fin_ronda);
+
+      lotes_ronda.clear();
+      buffer_ronda.clear();
+      uint32_t desde, hasta;
+      auto inicio_calculo = Reloj::now();
+      while (repartidor.siguiente(desde, hasta)) {
+        Lote lote{desde, hasta, buffer_ronda.size(), 0};
+        pool.ejecutar(desde, hasta, procesar, emitir);
+        lote.bytes = buffer_ronda.size() - lote.offset;
+        lotes_ronda.push_back(lote);
+      }
+      tiempos[CALCULO] += segundosDesde(inicio_calculo);
 
-    // Resolver (silenciar salida)
-    CalculadorCostos calculador(escenario);
-    calculador.configurarCostos(1.0, 2.5, 5.0);
+      if (escritor) {
+        MEDIR_FASE(ESCRITURA);
+        escritor->entregar(lotes_ronda, buffer_ronda, tiempos);
+      }
 
-    // Capturar stdout temporalmente
-    std::streambuf *old_cout = std::cout.rdbuf();
-    std::cout.rdbuf(nullptr);
-    Solucion solucion = calculador.resolver();
-    std::cout.rdbuf(old_cout);
+      informarProgreso(false);
+    }
 
-    // Contar horas críticas
-    int horas_criticas = 0;
-    for (int hora = 0; hora < 24; hora++) {
-      if (!escenario.demandaCubiertaConEO(hora)) {
-        horas_criticas++;
-      }
+    if (escritor) {
+      MEDIR_FASE(ESCRITURA);
+      escritor->terminar(tiempos);
+      escritor.reset();
     }
 
-    // Generar cadena de transiciones
-    std::string transiciones = "";
-    if (solucion.es_valida) {
-      transiciones = generarTransiciones(solucion.estados_por_hora);
+    // Desbalance de la última ronda: sin esta barrera quedaría escondido
+    // dentro del cierre del archivo o de la primera reducción. Antes, cada
+    // proceso publica su total final; tras la barrera el proceso 0 ve los
+    // totales exactos y deja el archivo de métricas completo
+    telemetria->publicar(telemetria_hilos.leerTotal(), true);
+    auto inicio_espera = Reloj::now();
+    MPI_Barrier(MPI_COMM_WORLD);
+    tiempos[ESPERA] += segundosDesde(inicio_espera);
+    if (rank == 0) {
+      informarProgreso(true);
     }
+    telemetria.reset();
+  }
+  std::string().swap(buffer_ronda);
+  std::vector<Lote>().swap(lotes_ronda);
 
-    // Escribir resultado directamente al archivo temporal
-    archivo_local << combinacion << ","
-                  << patron_eolica.to_string() << ","
-                  << std::fixed << std::setprecision(2) << solucion.costo_total << ","
-                  << (solucion.es_valida ? "SI" : "NO") << ","
-                  << horas_criticas << ","
-                  << transiciones << "\n";
+  if (!solo_resumen) {
+    auto inicio_cierre = Reloj::now();
+    MPI_File_close(&archivo);
+    tiempos[ESCRITURA] += segundosDesde(inicio_cierre);
+  }
 
-    // Actualizar estadísticas locales
-    if (solucion.es_valida) {
-      soluciones_validas_local++;
-      suma_costos_local += solucion.costo_total;
-      if (solucion.costo_total < mejor_costo_local) {
-        mejor_costo_local = solucion.costo_total;
-        combinacion_optima_local = combinacion;
-      }
-    }
+  // Modo resumen: combinar los resúmenes de los hilos y reducirlos entre
+  // procesos con un operador propio sobre el bloque de bytes
+  std::unique_ptr<ResumenAgregado> resumen_global;
+  auto inicio_combinacion = Reloj::now();
+  for (size_t h = 1; h < resumenes_hilos.size(); h++) {
+    resumenes_hilos[0]->combinar(*resumenes_hilos[h]);
+  }
+  tiempos[COMBINACION] += segundosDesde(inicio_combinacion);
 
-    // Mostrar progreso solo en proceso 0
-    if (rank == 0 &&
-        ((i + 1) % INTERVALO_REPORTE == 0 || i + 1 == num_locales)) {
-      auto ahora = std::chrono::steady_clock::now();
-      auto duracion =
-          std::chrono::duration_cast<std::chrono::seconds>(ahora - inicio);
+  auto inicio_reduccion = Reloj::now();
+  if (solo_resumen) {
 
-      double porcentaje = (double)(i + 1) / num_locales * 100.0;
-      double tasa = (double)(i + 1) / std::max(1, (int)duracion.count());
+    MPI_Datatype tipo_resumen;
+    MPI_Type_contiguous(sizeof(ResumenAgregado), MPI_BYTE, &tipo_resumen);
+    MPI_Type_commit(&tipo_resumen);
+    MPI_Op op_resumen;
+    MPI_Op_create(combinarResumenesMPI, 1, &op_resumen);
 
-      std::cout << "\rProceso 0 - Progreso: " << std::fixed
-                << std::setprecision(1) << porcentaje << "% | "
-                << "Casos: " << (i + 1) << "/" << num_locales << " | "
-                << "Tasa: " << std::fixed << std::setprecision(0) << tasa
-                << " c/s" << std::flush;
+    if (rank == 0) {
+      resumen_global = std::make_unique<ResumenAgregado>();
     }
-  }
-
-  // Cerrar archivo temporal
-  archivo_local.close();
+    MPI_Reduce(resumenes_hilos[0].get(), resumen_global.get(), 1, tipo_resumen,
+               op_resumen, 0, MPI_COMM_WORLD);
 
-  // Sincronizar todos los procesos
-  MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Op_free(&op_resumen);
+    MPI_Type_free(&tipo_resumen);
+  }
+  tiempos[REDUCCION] += segundosDesde(inicio_reduccion);
 
-  // Solo el proceso 0 combina todos los archivos
-  if (rank == 0) {
-    std::ofstream archivo_final("resultados_demo.csv");
-    archivo_final << "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,Transiciones\n";
-    
-    // Leer y combinar todos los archivos temporales EN ORDEN
-    for (int r = 0; r < size; r++) {
-      std::string archivo_temp_r = "resultados_temp_" + std::to_string(r) + ".csv";
-      std::ifstream archivo_temp_read(archivo_temp_r);
-      
-      if (archivo_temp_read.is_open()) {
-        std::string linea;
-        while (std::getline(archivo_temp_read, linea)) {
-          archivo_final << linea << "\n";
-        }
-        archivo_temp_read.close();
-        
-        // Eliminar archivo temporal
-        std::remove(archivo_temp_r.c_str());
-      } else {
-        std::cerr << "Advertencia: No se pudo leer archivo temporal: " << archivo_temp_r << std::endl;
-      }
+  // Combinar las estadísticas de los hilos
+  inicio_combinacion = Reloj::now();
+  double mejor_costo_local = std::numeric_limits<double>::infinity();
+  uint32_t combinacion_optima_local = 0;
+  uint32_t soluciones_validas_local = 0;
+  double suma_costos_local = 0.0;
+  for (const auto &local : stats_hilos) {
+    soluciones_validas_local += local->soluciones_validas;
+    suma_costos_local += local->suma_costos;
+    if (local->mejor_costo < mejor_costo_local ||
+        (local->mejor_costo == mejor_costo_local &&
+         local->combinacion_optima < combinacion_optima_local)) {
+      mejor_costo_local = local->mejor_costo;
+      combinacion_optima_local = local->combinacion_optima;
     }
-    archivo_final.close();
   }
+  tiempos[COMBINACION] += segundosDesde(inicio_combinacion);
 
-  // Recopilar estadísticas globales
-  uint32_t soluciones_validas_global;
-  double suma_costos_global;
-  double mejor_costo_global;
-  uint32_t combinacion_optima_global;
+  // Recopilar estadísticas globales (solo el proceso 0 recibe los valores)
+  uint32_t soluciones_validas_global = 0;
+  double suma_costos_global = 0.0;
+  double mejor_costo_global = std::numeric_limits<double>::infinity();
+  uint32_t combinacion_optima_global = std::numeric_limits<uint32_t>::max();
 
+  inicio_reduccion = Reloj::now();
   MPI_Reduce(&soluciones_validas_local, &soluciones_validas_global, 1,
              MPI_UINT32_T, MPI_SUM, 0, MPI_COMM_WORLD);
   MPI_Reduce(&suma_costos_local, &suma_costos_global, 1, MPI_DOUBLE, MPI_SUM, 0,
@@ -247,42 +839,77 @@ int main(int argc, char *argv[]) {
   MPI_Reduce(&mejor_costo_local, &mejor_costo_global, 1, MPI_DOUBLE, MPI_MIN, 0,
              MPI_COMM_WORLD);
 
-  // Para encontrar la combinación óptima global
-  struct {
-    double costo;
-    int rank;
-  } local_min, global_min;
+  // Para encontrar la combinación óptima global: con reparto dinámico el
+  // rank ya no indica qué IDs son menores, así que se desempata por ID
+  double optimo_local[2] = {mejor_costo_local, (double)combinacion_optima_local};
+  std::vector<double> optimos(rank == 0 ? 2 * size : 0);
+  MPI_Gather(optimo_local, 2, MPI_DOUBLE, optimos.data(), 2, MPI_DOUBLE, 0,
+             MPI_COMM_WORLD);
 
-  local_min.costo = mejor_costo_local;
-  local_min.rank = rank;
+  if (rank == 0) {
+    for (int r = 0; r < size; r++) {
+      uint32_t id = (uint32_t)optimos[2 * r + 1];
+      if (optimos[2 * r] == mejor_costo_global &&
+          id < combinacion_optima_global) {
+        combinacion_optima_global = id;
+      }
+    }
+  }
+  tiempos[REDUCCION] += segundosDesde(inicio_reduccion);
+  double tiempo_total = segundosDesde(inicio);
 
-  MPI_Reduce(&local_min, &global_min, 1, MPI_DOUBLE_INT, MPI_MINLOC, 0,
+  // Máximo (camino crítico) y suma (para el promedio) de cada fase
+  double tiempos_max[NUM_FASES], tiempos_suma[NUM_FASES];
+  MPI_Reduce(tiempos, tiempos_max, NUM_FASES, MPI_DOUBLE, MPI_MAX, 0,
+             MPI_COMM_WORLD);
+  MPI_Reduce(tiempos, tiempos_suma, NUM_FASES, MPI_DOUBLE, MPI_SUM, 0,
              MPI_COMM_WORLD);
 
-  // El proceso que tiene el mínimo envía su combinación óptima
-  if (rank == global_min.rank) {
-    MPI_Send(&combinacion_optima_local, 1, MPI_UINT32_T, 0, 0, MPI_COMM_WORLD);
+  // Instrumentación de fases (USAR_INSTRUMENTACION): totales de todos los
+  // procesos, sumados campo a campo
+  std::vector<TotalesFase> fases_instrumentadas = totalesFases();
+  if (INSTRUMENTACION_ACTIVA) {
+    const int CAMPOS_FASE = sizeof(TotalesFase) / sizeof(uint64_t);
+    std::vector<TotalesFase> fases_globales(fases_instrumentadas.size());
+    MPI_Reduce(fases_instrumentadas.data(), fases_globales.data(),
+               fases_instrumentadas.size() * CAMPOS_FASE, MPI_UINT64_T, MPI_SUM,
+               0, MPI_COMM_WORLD);
+    fases_instrumentadas.swap(fases_globales);
   }
 
-  if (rank == 0 && global_min.rank != 0) {
-    MPI_Recv(&combinacion_optima_global, 1, MPI_UINT32_T, global_min.rank, 0,
-             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-  } else if (rank == 0) {
-    combinacion_optima_global = combinacion_optima_local;
+  // Rendimiento por dominio de memoria de cada proceso (con --afinidad)
+  std::vector<RendimientoDominio> rendimiento;
+  if (afinidad) {
+    std::vector<RendimientoDominio> propio =
+        rendimientoPorDominio(topologia, pool, rank);
+    int bytes = propio.size() * sizeof(RendimientoDominio);
+    std::vector<int> bytes_procesos(rank == 0 ? size : 0);
+    std::vector<int> desplazamientos(rank == 0 ? size : 0);
+    MPI_Gather(&bytes, 1, MPI_INT, bytes_procesos.data(), 1, MPI_INT, 0,
+               MPI_COMM_WORLD);
+    if (rank == 0) {
+      int total_bytes = 0;
+      for (int r = 0; r < size; r++) {
+        desplazamientos[r] = total_bytes;
+        total_bytes += bytes_procesos[r];
+      }
+      rendimiento.resize(total_bytes / sizeof(RendimientoDominio));
+    }
+    MPI_Gatherv(propio.data(), bytes, MPI_BYTE, rendimiento.data(),
+                bytes_procesos.data(), desplazamientos.data(), MPI_BYTE, 0,
+                MPI_COMM_WORLD);
   }
 
   // Solo el proceso 0 muestra los resultados finales
   if (rank == 0) {
-    auto fin = std::chrono::steady_clock::now();
-    auto tiempo_total =
-        std::chrono::duration_cast<std::chrono::seconds>(fin - inicio);
-
     std::cout << "\n\n=== PROCESAMIENTO COMPLETADO ===\n";
     std::cout << "Combinaciones procesadas: " << num_combinaciones << "\n";
     std::cout << "Procesos MPI utilizados: " << size << "\n";
-    std::cout << "Tiempo total: " << tiempo_total.count() << " segundos\n";
+    std::cout << "Hilos por proceso: " << pool.getNumHilos() << "\n";
+    std::cout << "Tiempo total: " << std::fixed << std::setprecision(2)
+              << tiempo_total << " segundos\n";
     std::cout << "Tasa promedio: " << std::fixed << std::setprecision(1)
-              << (double)num_combinaciones / tiempo_total.count()
+              << (double)num_combinaciones / std::max(tiempo_total, 1e-9)
               << " combinaciones/segundo\n";
     std::cout << "Soluciones válidas: " << soluciones_validas_global << " ("
               << std::fixed << std::setprecision(1)
@@ -296,8 +923,54 @@ int main(int argc, char *argv[]) {
       std::cout << "Costo promedio: " << std::fixed << std::setprecision(2)
                 << costo_promedio << "\n";
     }
-    
-    std::cout << "Resultados con transiciones guardados en: resultados_demo.csv\n";
+
+    std::cout << "\n=== TIEMPOS POR FASE (máximo / promedio entre procesos) ===\n";
+    for (int fase = 0; fase < NUM_FASES; fase++) {
+      std::cout << "  " << std::left << std::setw(12) << NOMBRES_FASES[fase]
+                << std::right << std::fixed << std::setprecision(3)
+                << tiempos_max[fase] << " s / " << tiempos_suma[fase] / size
+                << " s\n";
+    }
+
+    // Una línea JSON por ejecución, para juntar varias en un mismo archivo
+    if (!archivo_tiempos.empty()) {
+      std::ofstream salida_tiempos(archivo_tiempos, std::ios::app);
+      salida_tiempos << std::fixed << std::setprecision(6)
+                     << "{\"procesos\":" << size
+                     << ",\"hilos\":" << pool.getNumHilos()
+                     << ",\"combinaciones\":" << num_combinaciones
+                     << ",\"solo_resumen\":" << (solo_resumen ? "true" : "false")
+                     << ",\"total\":" << tiempo_total;
+      for (int fase = 0; fase < NUM_FASES; fase++) {
+        salida_tiempos << ",\"" << NOMBRES_FASES[fase]
+                       << "_max\":" << tiempos_max[fase] << ",\""
+                       << NOMBRES_FASES[fase]
+                       << "_prom\":" << tiempos_suma[fase] / size;
+      }
+      salida_tiempos << "}\n";
+      if (!salida_tiempos) {
+        std::cerr << "Error: No se pudo escribir " << archivo_tiempos << "\n";
+      }
+    }
+    escribirReporteFases(std::cout, fases_instrumentadas, num_combinaciones);
+    if (afinidad) {
+      imprimirRendimientoDominios(std::cout, rendimiento);
+    }
+
+    if (solo_resumen) {
+      std::cout << "\n";
+      resumen_global->imprimirReporte(std::cout);
+
+      std::ofstream archivo_resumen("resumen_demo.txt");
+      resumen_global->imprimirReporte(archivo_resumen,
+                                      std::numeric_limits<size_t>::max());
+      std::cout << "\nResumen agregado guardado en: resumen_demo.txt\n";
+    } else {
+      std::cout << "Resultados con transiciones guardados en: resultados_demo.csv\n";
+    }
+    if (!archivo_metricas.empty()) {
+      std::cout << "Métricas de progreso en: " << archivo_metricas << "\n";
+    }
   }
 
   MPI_Finalize();
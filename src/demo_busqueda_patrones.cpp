@@ -0,0 +1,83 @@
+#include "../include/buscador_patrones.hpp"
+#include <iostream>
+#include <bitset>
+#include <iomanip>
+
+int main() {
+    std::cout << "=== BÚSQUEDA DE PATRONES EXTREMOS (RAMIFICACIÓN Y ACOTAMIENTO) ===\n";
+    std::cout << "Encuentra los K patrones eólicos más baratos o más caros sin recorrer las 2^24 combinaciones\n\n";
+
+    // Demanda fija según especificación del usuario
+    std::vector<double> demanda_fija = {
+        300, 200, 100, 100, 100, 200, 300, 500, 800, 1000, 1000, 1000,
+        1000, 900, 800, 800, 800, 1000, 1000, 1000, 600, 600, 400, 300
+    };
+
+    CalculadorTabular calculador;
+    calculador.configurarDemanda(demanda_fija);
+    calculador.configurarCostos(1.0, 2.5, 5.0);
+
+    int opcion;
+    size_t k;
+    int min_eolicas, max_eolicas;
+
+    std::cout << "Criterio (1 = más baratos, 2 = más caros): ";
+    std::cin >> opcion;
+    std::cout << "Cantidad de patrones (K): ";
+    std::cin >> k;
+    std::cout << "Mínimo de horas con eólica (0-24): ";
+    std::cin >> min_eolicas;
+    std::cout << "Máximo de horas con eólica (0-24): ";
+    std::cin >> max_eolicas;
+
+    if (!std::cin || (opcion != 1 && opcion != 2)) {
+        std::cerr << "Error: entrada inválida\n";
+        return 1;
+    }
+
+    CriterioBusqueda criterio = opcion == 2 ? CriterioBusqueda::MAS_CAROS : CriterioBusqueda::MAS_BARATOS;
+
+    BuscadorPatrones buscador(calculador);
+    try {
+        buscador.configurarHorasEolicas(min_eolicas, max_eolicas);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<PatronCandidato> resultado = buscador.buscar(criterio, k);
+    const EstadisticasBusqueda& stats = buscador.getEstadisticas();
+
+    std::cout << "\n=== TOP " << k << (criterio == CriterioBusqueda::MAS_CAROS ? " MÁS CAROS" : " MÁS BARATOS")
+              << " (eólica en " << min_eolicas << "-" << max_eolicas << " horas) ===\n";
+    std::cout << std::setw(5) << "#"
+              << std::setw(12) << "ID"
+              << std::setw(27) << "Patrón"
+              << std::setw(10) << "Costo"
+              << std::setw(10) << "Críticas"
+              << std::setw(9) << "Eólica" << "\n";
+    std::cout << std::string(73, '-') << "\n";
+
+    for (size_t i = 0; i < resultado.size(); i++) {
+        const PatronCandidato& p = resultado[i];
+        std::cout << std::setw(5) << (i + 1)
+                  << std::setw(12) << p.combinacion_id
+                  << std::setw(26) << std::bitset<24>(p.combinacion_id)
+                  << std::setw(10) << std::fixed << std::setprecision(2) << p.costo_total
+                  << std::setw(10) << p.horas_criticas
+                  << std::setw(9) << p.horas_eolicas << "\n";
+    }
+
+    if (resultado.empty()) {
+        std::cout << "No hay patrones válidos que cumplan la restricción.\n";
+    }
+
+    std::cout << "\n=== ESTADÍSTICAS DE LA BÚSQUEDA ===\n";
+    std::cout << "Nodos explorados: " << stats.nodos_explorados << "\n";
+    std::cout << "Nodos podados: " << stats.nodos_podados << "\n";
+    std::cout << "Subárboles de costo uniforme: " << stats.subarboles_uniformes << "\n";
+    std::cout << "Patrones evaluados: " << stats.hojas_evaluadas << " de 16777216\n";
+    std::cout << "Tiempo: " << std::fixed << std::setprecision(3) << stats.tiempo_ms << " ms\n";
+
+    return 0;
+}
@@ -1,7 +1,44 @@
 #include "../include/escenario.hpp"
+#include <charconv>
+#include <cmath>
 #include <iostream>
 #include <fstream>
-#include <sstream>
+
+bool esEspacio(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+bool leerValoresHora(std::string_view linea, double valores[24], std::string& error) {
+    const char* p = linea.data();
+    const char* fin = p + linea.size();
+    int cantidad = 0;
+    while (true) {
+        while (p < fin && esEspacio(*p)) p++;
+        if (p == fin) break;
+        const char* inicio = p;
+        while (p < fin && !esEspacio(*p)) p++;
+        if (cantidad == 24) {
+            error = "hay más de 24 valores";
+            return false;
+        }
+        double valor;
+        auto resultado = std::from_chars(inicio, p, valor);
+        if (resultado.ec != std::errc() || resultado.ptr != p) {
+            error = "valor inválido '" + std::string(inicio, p) + "' en la hora " + std::to_string(cantidad);
+            return false;
+        }
+        if (!(valor >= 0.0) || !std::isfinite(valor)) {
+            error = "valor negativo o no finito '" + std::string(inicio, p) + "' en la hora " + std::to_string(cantidad);
+            return false;
+        }
+        valores[cantidad++] = valor;
+    }
+    if (cantidad != 24) {
+        error = "se esperaban 24 valores y hay " + std::to_string(cantidad);
+        return false;
+    }
+    return true;
+}
 
 Escenario::Escenario() {
     demanda_.resize(24, 0.0);
@@ -15,29 +52,28 @@ bool Escenario::cargarDatos(const std::string& archivo_parametros) {
         return false;
     }
     
-    std::string linea;
-    int hora = 0;
-    
-    // Leer demanda (primera línea)
-    if (std::getline(archivo, linea)) {
-        std::istringstream iss(linea);
-        double valor;
-        hora = 0;
-        while (iss >> valor && hora < 24) {
-            demanda_[hora] = valor;
-            hora++;
+    // Dos líneas de 24 valores: demanda y energía de otras fuentes (las
+    // vacías y los comentarios '#' se saltean). Un valor de más, de menos o
+    // que no es número es un error, en lugar de quedar en 0 sin aviso.
+    std::vector<double>* destinos[2] = {&demanda_, &energia_otras_fuentes_};
+    const char* nombres[2] = {"demanda", "otras fuentes"};
+    std::string linea, error;
+    int numero_linea = 0, leidas = 0;
+    double valores[24];
+    while (leidas < 2 && std::getline(archivo, linea)) {
+        numero_linea++;
+        size_t inicio = linea.find_first_not_of(" \t\r");
+        if (inicio == std::string::npos || linea[inicio] == '#') continue;
+        if (!leerValoresHora(linea, valores, error)) {
+            std::cerr << "Error: " << archivo_parametros << ", línea " << numero_linea << " ("
+                      << nombres[leidas] << "): " << error << std::endl;
+            return false;
         }
+        destinos[leidas++]->assign(valores, valores + 24);
     }
-    
-    // Leer energía de otras fuentes (segunda línea)
-    if (std::getline(archivo, linea)) {
-        std::istringstream iss(linea);
-        double valor;
-        hora = 0;
-        while (iss >> valor && hora < 24) {
-            energia_otras_fuentes_[hora] = valor;
-            hora++;
-        }
+    if (leidas < 2) {
+        std::cerr << "Error: " << archivo_parametros << " no tiene la línea de " << nombres[leidas] << std::endl;
+        return false;
     }
     
     archivo.close();
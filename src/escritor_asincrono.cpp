@@ -0,0 +1,159 @@
+#include "escritor_asincrono.hpp"
+#include "instrumentacion.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+EscritorAsincrono::EscritorAsincrono(std::ostream& salida, const Config& config) :
+    salida_(salida), config_(config), ultima_entrega_(std::chrono::steady_clock::now()),
+    escribiendo_(false), pedido_flush_(false), terminar_(false), bytes_entregados_(0) {
+    if (config_.tam_buffer == 0 || config_.max_buffers < 2) {
+        throw std::invalid_argument("El escritor necesita buffers de tamaño > 0 y al menos 2 buffers");
+    }
+    actual_.reserve(config_.tam_buffer);
+    hilo_ = std::thread(&EscritorAsincrono::hiloEscritura, this);
+}
+
+EscritorAsincrono::~EscritorAsincrono() {
+    try {
+        entregarActual();
+    } catch (...) {
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        terminar_ = true;
+    }
+    cv_trabajo_.notify_all();
+    hilo_.join();
+}
+
+void EscritorAsincrono::relanzarError() {
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+}
+
+void EscritorAsincrono::encolar(std::string&& buffer) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Contrapresión: uno se llena, el resto puede estar en cola o escribiéndose
+    cv_espacio_.wait(lock, [&] {
+        return error_ || pendientes_.size() + (escribiendo_ ? 1 : 0) < config_.max_buffers - 1;
+    });
+    relanzarError();
+    pendientes_.push_back(std::move(buffer));
+    cv_trabajo_.notify_one();
+}
+
+void EscritorAsincrono::entregarActual() {
+    ultima_entrega_ = std::chrono::steady_clock::now();
+    if (actual_.empty()) {
+        return;
+    }
+    std::string lleno;
+    lleno.swap(actual_);
+    encolar(std::move(lleno));
+
+    // Reutilizar la capacidad de un buffer ya escrito si hay alguno
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!libres_.empty()) {
+        actual_.swap(libres_.back());
+        libres_.pop_back();
+    } else {
+        actual_.reserve(config_.tam_buffer);
+    }
+}
+
+void EscritorAsincrono::escribir(const char* datos, size_t bytes) {
+    actual_.append(datos, bytes);
+    bytes_entregados_ += bytes;
+    if (actual_.size() >= config_.tam_buffer ||
+        std::chrono::steady_clock::now() - ultima_entrega_ >= config_.intervalo_flush) {
+        entregarActual();
+    }
+}
+
+void EscritorAsincrono::entregar(std::string&& buffer) {
+    // Lo acumulado va antes para respetar el orden
+    entregarActual();
+    bytes_entregados_ += buffer.size();
+    encolar(std::move(buffer));
+}
+
+void EscritorAsincrono::vaciar() {
+    entregarActual();
+    std::unique_lock<std::mutex> lock(mutex_);
+    pedido_flush_ = true;
+    cv_trabajo_.notify_one();
+    cv_espacio_.wait(lock, [&] { return error_ || !pedido_flush_; });
+    relanzarError();
+}
+
+void EscritorAsincrono::hiloEscritura() {
+    size_t bytes_sin_flush = 0;
+    auto ultimo_flush = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_trabajo_.wait_for(lock, config_.intervalo_flush,
+                             [&] { return !pendientes_.empty() || pedido_flush_ || terminar_; });
+
+        if (!pendientes_.empty()) {
+            std::string buffer = std::move(pendientes_.front());
+            pendientes_.pop_front();
+            escribiendo_ = true;
+            lock.unlock();
+
+            {
+                MEDIR_FASE(ESCRITURA);
+                salida_.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                bytes_sin_flush += buffer.size();
+                auto ahora = std::chrono::steady_clock::now();
+                if (bytes_sin_flush >= config_.bytes_flush || ahora - ultimo_flush >= config_.intervalo_flush) {
+                    salida_.flush();
+                    bytes_sin_flush = 0;
+                    ultimo_flush = ahora;
+                }
+            }
+            bool fallo = !salida_;
+            buffer.clear();
+
+            lock.lock();
+            escribiendo_ = false;
+            if (fallo && !error_) {
+                error_ = std::make_exception_ptr(std::runtime_error("Error al escribir el archivo de resultados"));
+                pendientes_.clear();   // Lo que sigue ya no puede escribirse en orden
+            }
+            // Conservar a lo sumo un buffer libre: la memoria queda acotada
+            if (libres_.empty()) {
+                libres_.push_back(std::move(buffer));
+            }
+            cv_espacio_.notify_all();
+            continue;
+        }
+
+        // Sin nada en cola: flush por tiempo, por pedido o al terminar
+        bool vencido = std::chrono::steady_clock::now() - ultimo_flush >= config_.intervalo_flush;
+        if ((pedido_flush_ || terminar_ || vencido) && bytes_sin_flush > 0) {
+            lock.unlock();
+            salida_.flush();
+            bool fallo = !salida_;
+            lock.lock();
+            bytes_sin_flush = 0;
+            ultimo_flush = std::chrono::steady_clock::now();
+            if (fallo && !error_) {
+                error_ = std::make_exception_ptr(std::runtime_error("Error al escribir el archivo de resultados"));
+                pendientes_.clear();   // Lo que sigue ya no puede escribirse en orden
+            }
+        }
+        // Mientras se hacía flush pudo llegar otro buffer: se escribe antes de responder
+        if (!pendientes_.empty()) {
+            continue;
+        }
+        if (pedido_flush_) {
+            pedido_flush_ = false;
+            cv_espacio_.notify_all();
+        }
+        if (terminar_) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include "escritor_cubo.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+EscritorCubo::EscritorCubo(const std::string& archivo, const CabeceraCubo& cabecera, bool reanudar) :
+    archivo_(archivo), datos_(nullptr), tam_(static_cast<size_t>(cabecera.bytes_totales)), cabecera_(nullptr) {
+
+    int fd = open(archivo.c_str(), reanudar ? O_RDWR : O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("No se pudo abrir el cubo " + archivo + ": " + std::strerror(errno));
+    }
+    struct stat info;
+    if (reanudar && (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != tam_)) {
+        close(fd);
+        throw std::runtime_error("El cubo no coincide con el checkpoint: " + archivo);
+    }
+    // Sin reanudar, el archivo nuevo queda lleno de ceros (huecos sin bloques)
+    if (!reanudar && ftruncate(fd, static_cast<off_t>(tam_)) != 0) {
+        close(fd);
+        throw std::runtime_error("No se pudo reservar el cubo " + archivo + ": " + std::strerror(errno));
+    }
+    void* mapa = mmap(nullptr, tam_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        throw std::runtime_error("No se pudo mapear el cubo: " + archivo);
+    }
+    datos_ = static_cast<uint8_t*>(mapa);
+    cabecera_ = reinterpret_cast<CabeceraCubo*>(datos_);
+
+    if (reanudar) {
+        if (cabecera_->completo != 0 || std::memcmp(cabecera_, &cabecera, sizeof(CabeceraCubo)) != 0) {
+            munmap(datos_, tam_);
+            throw std::runtime_error("El cubo se generó con otros parámetros o ya está completo: " + archivo);
+        }
+    } else {
+        std::memcpy(cabecera_, &cabecera, sizeof(CabeceraCubo));
+        cabecera_->completo = 0;
+    }
+}
+
+EscritorCubo::~EscritorCubo() {
+    munmap(datos_, tam_);
+}
+
+void EscritorCubo::registrar(uint32_t id, bool solucion_valida, double costo_total, int horas_criticas,
+                             const std::vector<EstadoMaquina>& estados, uint32_t mascara_encendido) {
+    size_t fila = id - cabecera_->desde;
+    uint32_t costo = COSTO_INVALIDO;
+    if (solucion_valida) {
+        costo = static_cast<uint32_t>(std::llround(costo_total * cabecera_->escala_costo));
+    }
+    reinterpret_cast<uint32_t*>(datos_ + cabecera_->offset_costos)[fila] = costo;
+    datos_[cabecera_->offset_horas + fila] = static_cast<uint8_t>(horas_criticas);
+
+    uint8_t secuencia[BYTES_SECUENCIA_CUBO] = {};
+    empaquetarSecuencia(estados, secuencia);
+    std::memcpy(datos_ + cabecera_->offset_secuencias + fila * BYTES_SECUENCIA_CUBO, secuencia, BYTES_SECUENCIA_CUBO);
+    reinterpret_cast<uint32_t*>(datos_ + cabecera_->offset_mascaras)[fila] = solucion_valida ? mascara_encendido : 0;
+}
+
+void EscritorCubo::sincronizar() {
+    if (msync(datos_, tam_, MS_SYNC) != 0) {
+        throw std::runtime_error("Error al escribir el cubo " + archivo_ + ": " + std::strerror(errno));
+    }
+}
+
+void EscritorCubo::completar() {
+    // El bitmap se deriva de los costos: así registrar() no comparte palabras entre hilos
+    const uint32_t* costos = reinterpret_cast<const uint32_t*>(datos_ + cabecera_->offset_costos);
+    uint64_t* validas = reinterpret_cast<uint64_t*>(datos_ + cabecera_->offset_validas);
+    size_t filas = cabecera_->hasta - cabecera_->desde;
+    for (size_t palabra = 0; palabra * 64 < filas; palabra++) {
+        uint64_t bits = 0;
+        size_t fin = std::min(filas - palabra * 64, size_t(64));
+        for (size_t b = 0; b < fin; b++) {
+            bits |= uint64_t(costos[palabra * 64 + b] != COSTO_INVALIDO) << b;
+        }
+        validas[palabra] = bits;
+    }
+    sincronizar();
+    cabecera_->completo = 1;
+    sincronizar();
+}
@@ -0,0 +1,170 @@
+#include "calculador_tabular.hpp"
+#include "cargador_escenarios.hpp"
+#include "formato_csv.hpp"
+#include "pool_bloques.hpp"
+#include "resumen_agregado.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Evaluación de pronósticos reales: un archivo con muchos días (dos líneas de
+// 24 valores por día, como data/parametros.in) se carga en paralelo y cada día
+// válido se resuelve con CalculadorTabular a partir de su máscara de horas
+// críticas. Los días con errores de formato se informan por línea y se saltean.
+//
+// Uso: evaluar_escenarios [--hilos N] [--salida dias.csv] [--max-errores N] archivo
+
+namespace {
+const char* const COLUMNAS_DIAS = "Dia,Linea,CostoTotal,SolucionValida,HorasCriticas,Transiciones";
+
+struct Opciones {
+    unsigned num_hilos;
+    std::string archivo;
+    std::string archivo_salida;
+    size_t max_errores;
+
+    Opciones() : num_hilos(0), max_errores(20) {}
+};
+
+// Totales de un hilo, cada uno en su propia línea de caché: los hilos los
+// actualizan en cada día y no deben invalidarse entre sí
+struct alignas(64) TotalesHilo {
+    uint64_t soluciones = 0;
+    double costo_total = 0.0;
+};
+
+bool interpretarOpciones(int argc, char* argv[], Opciones& opciones) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hay_valor = i + 1 < argc;
+        if (arg == "--hilos" && hay_valor) {
+            opciones.num_hilos = std::stoul(argv[++i]);
+        } else if (arg == "--salida" && hay_valor) {
+            opciones.archivo_salida = argv[++i];
+        } else if (arg == "--max-errores" && hay_valor) {
+            opciones.max_errores = std::stoul(argv[++i]);
+        } else if (opciones.archivo.empty() && arg.compare(0, 2, "--") != 0) {
+            opciones.archivo = arg;
+        } else {
+            throw std::invalid_argument("opción desconocida o incompleta: " + arg);
+        }
+    }
+    return !opciones.archivo.empty();
+}
+}
+
+int main(int argc, char* argv[]) {
+    Opciones opciones;
+    try {
+        if (!interpretarOpciones(argc, argv, opciones)) {
+            std::cerr << "Uso: " << argv[0] << " [--hilos N] [--salida dias.csv] [--max-errores N] archivo\n"
+                      << "archivo: dos líneas de 24 valores por día (demanda y otras fuentes)\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    try {
+        auto inicio = std::chrono::steady_clock::now();
+        CargadorEscenarios cargador(opciones.archivo);
+        PoolBloques pool(opciones.num_hilos, 1);
+
+        // La DP solo depende de la máscara de horas críticas de cada día
+        CalculadorTabular tabular;
+        tabular.configurarCostos(1.0, 2.5, 5.0);
+
+        std::unique_ptr<std::ofstream> salida;
+        if (!opciones.archivo_salida.empty()) {
+            salida = std::make_unique<std::ofstream>(opciones.archivo_salida, std::ios::binary);
+            if (!salida->is_open()) {
+                throw std::runtime_error("No se pudo crear " + opciones.archivo_salida);
+            }
+            *salida << COLUMNAS_DIAS << "\n";
+        }
+
+        std::vector<TotalesHilo> totales(pool.getNumHilos());
+        auto procesar = [&](const CargadorEscenarios::Dia& dia, unsigned hilo, std::string& filas) {
+            EstadoMaquina estados[24];
+            double costo = tabular.resolver(dia.mascara_criticas, estados);
+            bool valida = costo != CalculadorTabular::INFINITO;
+            if (valida) {
+                totales[hilo].soluciones++;
+                totales[hilo].costo_total += costo;
+            }
+            if (!salida) return;
+
+            uint32_t mascara_encendido = valida ? ResumenAgregado::mascaraEncendido(estados, 24) : 0;
+            char fila[MAX_FILA_CSV];
+            char* p = escribirEnteroCsv(fila, dia.numero + 1);
+            *p++ = ',';
+            p = escribirEnteroCsv(p, dia.linea);
+            *p++ = ',';
+            p = escribirCostoCsv(p, costo);
+            *p++ = ',';
+            std::memcpy(p, valida ? "SI," : "NO,", 3);
+            p += 3;
+            p = escribirEnteroCsv(p, static_cast<uint64_t>(__builtin_popcount(dia.mascara_criticas)));
+            *p++ = ',';
+            p = escribirTransicionesCsv(p, mascara_encendido);
+            *p++ = '\n';
+            filas.append(fila, static_cast<size_t>(p - fila));
+        };
+        auto emitir = [&](std::string& filas) {
+            if (salida && !filas.empty()) {
+                salida->write(filas.data(), static_cast<std::streamsize>(filas.size()));
+            }
+        };
+        ResultadoCarga carga = cargador.recorrer(pool, procesar, emitir);
+        if (salida) {
+            salida->close();
+            if (!*salida) {
+                throw std::runtime_error("Error al escribir " + opciones.archivo_salida);
+            }
+        }
+
+        TotalesHilo total;
+        for (const TotalesHilo& parcial : totales) {
+            total.soluciones += parcial.soluciones;
+            total.costo_total += parcial.costo_total;
+        }
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+        for (size_t i = 0; i < carga.errores.size() && i < opciones.max_errores; i++) {
+            std::cerr << opciones.archivo << ", línea " << carga.errores[i].linea << ": "
+                      << carga.errores[i].mensaje << "\n";
+        }
+        if (carga.errores.size() > opciones.max_errores) {
+            std::cerr << "... y " << carga.errores.size() - opciones.max_errores << " error(es) más\n";
+        }
+
+        std::cout << "📅 === EVALUACIÓN DE ESCENARIOS ===\n";
+        std::cout << "Archivo: " << opciones.archivo << "\n";
+        std::cout << "Días leídos: " << carga.dias << " (" << pool.getNumHilos() << " hilo(s), "
+                  << std::fixed << std::setprecision(2) << segundos << " s, "
+                  << std::setprecision(1) << carga.bytes / 1e6 / std::max(segundos, 1e-9) << " MB/s)\n";
+        std::cout << "Días válidos: " << carga.dias_validos << "\n";
+        if (!carga.errores.empty()) {
+            std::cout << "⚠️  Errores de formato: " << carga.errores.size() << "\n";
+        }
+        std::cout << "Días con solución: " << total.soluciones << "\n";
+        if (total.soluciones > 0) {
+            std::cout << "Costo promedio: " << std::setprecision(2) << total.costo_total / total.soluciones << "\n";
+        }
+        if (salida) {
+            std::cout << "Resultados por día guardados en: " << opciones.archivo_salida << "\n";
+        }
+        return carga.errores.empty() ? 0 : 2;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+}
@@ -0,0 +1,655 @@
+#include "formato_columnar.hpp"
+#include "formato_csv.hpp"
+#include "pool_bloques.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+
+#if defined(USAR_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(USAR_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace {
+const std::string COLUMNAS_FIJAS = "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,";
+
+// Archivo de solo lectura mapeado completo
+class Mapa {
+public:
+    const uint8_t* datos;
+    size_t tam;
+
+    explicit Mapa(const std::string& archivo) : datos(nullptr), tam(0) {
+        int fd = open(archivo.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("No se pudo abrir " + archivo);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            throw std::runtime_error("Archivo vacío o ilegible: " + archivo);
+        }
+        tam = static_cast<size_t>(info.st_size);
+        void* mapa = mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapa == MAP_FAILED) {
+            throw std::runtime_error("No se pudo mapear " + archivo);
+        }
+        datos = static_cast<const uint8_t*>(mapa);
+    }
+    ~Mapa() { munmap(const_cast<uint8_t*>(datos), tam); }
+
+    Mapa(const Mapa&) = delete;
+    Mapa& operator=(const Mapa&) = delete;
+};
+
+// --- Codificación de enteros, cadenas y códigos empaquetados ---
+
+void agregarU32(std::string& destino, uint32_t valor) {
+    char bytes[4];
+    std::memcpy(bytes, &valor, 4);
+    destino.append(bytes, 4);
+}
+
+void agregarVarint(std::string& destino, uint32_t valor) {
+    while (valor >= 0x80) {
+        destino.push_back(static_cast<char>((valor & 0x7F) | 0x80));
+        valor >>= 7;
+    }
+    destino.push_back(static_cast<char>(valor));
+}
+
+unsigned bitsPara(size_t valores_distintos) {
+    unsigned bits = 0;
+    while ((size_t(1) << bits) < valores_distintos) {
+        bits++;
+    }
+    return bits;
+}
+
+void empaquetar(std::string& destino, const std::vector<uint32_t>& codigos, unsigned bits) {
+    if (bits == 0) {
+        return;
+    }
+    uint64_t acumulado = 0;
+    unsigned ocupados = 0;
+    for (uint32_t codigo : codigos) {
+        acumulado |= uint64_t(codigo) << ocupados;
+        ocupados += bits;
+        while (ocupados >= 8) {
+            destino.push_back(static_cast<char>(acumulado & 0xFF));
+            acumulado >>= 8;
+            ocupados -= 8;
+        }
+    }
+    if (ocupados > 0) {
+        destino.push_back(static_cast<char>(acumulado & 0xFF));
+    }
+}
+
+void agregarDiccionario(std::string& destino, const std::vector<std::string_view>& valores) {
+    agregarU32(destino, static_cast<uint32_t>(valores.size()));
+    for (std::string_view valor : valores) {
+        agregarU32(destino, static_cast<uint32_t>(valor.size()));
+        destino.append(valor.data(), valor.size());
+    }
+}
+
+// Lectura con control de límites sobre los datos de un bloque
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* fin;
+
+    void exigir(size_t bytes) const {
+        if (static_cast<size_t>(fin - p) < bytes) {
+            throw std::runtime_error("Bloque columnar corrupto o truncado");
+        }
+    }
+    uint32_t u32() {
+        exigir(4);
+        uint32_t valor;
+        std::memcpy(&valor, p, 4);
+        p += 4;
+        return valor;
+    }
+    uint32_t varint() {
+        uint32_t valor = 0;
+        for (unsigned desplazamiento = 0; desplazamiento < 35; desplazamiento += 7) {
+            exigir(1);
+            uint8_t byte = *p++;
+            valor |= uint32_t(byte & 0x7F) << desplazamiento;
+            if (!(byte & 0x80)) return valor;
+        }
+        throw std::runtime_error("Bloque columnar corrupto (varint)");
+    }
+    std::vector<uint32_t> codigos(size_t cantidad, unsigned bits, size_t limite) {
+        std::vector<uint32_t> codigos(cantidad, 0);
+        if (bits == 0) return codigos;
+        if (bits > 32) throw std::runtime_error("Bloque columnar corrupto (bits)");
+        size_t bytes = (cantidad * bits + 7) / 8;
+        exigir(bytes);
+        uint64_t acumulado = 0;
+        unsigned disponibles = 0;
+        uint64_t mascara = (uint64_t(1) << bits) - 1;
+        for (size_t i = 0; i < cantidad; i++) {
+            while (disponibles < bits) {
+                acumulado |= uint64_t(*p++) << disponibles;
+                disponibles += 8;
+            }
+            codigos[i] = static_cast<uint32_t>(acumulado & mascara);
+            acumulado >>= bits;
+            disponibles -= bits;
+            if (codigos[i] >= limite) throw std::runtime_error("Bloque columnar corrupto (código)");
+        }
+        return codigos;
+    }
+    std::vector<std::string> diccionario() {
+        uint32_t cantidad = u32();
+        std::vector<std::string> valores;
+        valores.reserve(std::min<uint32_t>(cantidad, 1u << 16));
+        for (uint32_t i = 0; i < cantidad; i++) {
+            uint32_t largo = u32();
+            exigir(largo);
+            valores.emplace_back(reinterpret_cast<const char*>(p), largo);
+            p += largo;
+        }
+        return valores;
+    }
+};
+
+// --- Compresión de bloques ---
+
+void comprimirDatos(const std::string& datos, CompresionColumnar compresion, std::string& salida) {
+    switch (compresion) {
+        case CompresionColumnar::NINGUNA:
+            salida = datos;
+            return;
+#if defined(USAR_ZLIB)
+        case CompresionColumnar::ZLIB: {
+            uLongf largo = compressBound(static_cast<uLong>(datos.size()));
+            salida.resize(largo);
+            if (compress2(reinterpret_cast<Bytef*>(&salida[0]), &largo, reinterpret_cast<const Bytef*>(datos.data()),
+                          static_cast<uLong>(datos.size()), 6) != Z_OK) {
+                throw std::runtime_error("Error de zlib al comprimir un bloque");
+            }
+            salida.resize(largo);
+            return;
+        }
+#endif
+#if defined(USAR_ZSTD)
+        case CompresionColumnar::ZSTD: {
+            salida.resize(ZSTD_compressBound(datos.size()));
+            size_t largo = ZSTD_compress(&salida[0], salida.size(), datos.data(), datos.size(), 9);
+            if (ZSTD_isError(largo)) {
+                throw std::runtime_error(std::string("Error de zstd al comprimir un bloque: ") + ZSTD_getErrorName(largo));
+            }
+            salida.resize(largo);
+            return;
+        }
+#endif
+        default:
+            throw std::runtime_error(std::string("Compresión no disponible en este binario: ") + nombreCompresion(compresion));
+    }
+}
+
+void descomprimirDatos(const uint8_t* datos, size_t bytes, size_t bytes_datos, CompresionColumnar compresion,
+                       std::string& salida) {
+    salida.resize(bytes_datos);
+    switch (compresion) {
+        case CompresionColumnar::NINGUNA:
+            if (bytes != bytes_datos) break;
+            std::memcpy(&salida[0], datos, bytes);
+            return;
+#if defined(USAR_ZLIB)
+        case CompresionColumnar::ZLIB: {
+            uLongf largo = static_cast<uLongf>(bytes_datos);
+            if (uncompress(reinterpret_cast<Bytef*>(&salida[0]), &largo, datos, static_cast<uLong>(bytes)) != Z_OK ||
+                largo != bytes_datos) {
+                break;
+            }
+            return;
+        }
+#endif
+#if defined(USAR_ZSTD)
+        case CompresionColumnar::ZSTD: {
+            size_t largo = ZSTD_decompress(&salida[0], bytes_datos, datos, bytes);
+            if (ZSTD_isError(largo) || largo != bytes_datos) break;
+            return;
+        }
+#endif
+        default:
+            throw std::runtime_error(std::string("El archivo usa ") + nombreCompresion(compresion) +
+                                     ", que este binario no tiene compilado");
+    }
+    throw std::runtime_error("Bloque columnar corrupto: no se pudo descomprimir");
+}
+
+// --- Codificación de un bloque de filas CSV ---
+
+[[noreturn]] void filaInvalida(uint64_t fila, std::string_view linea) {
+    throw std::runtime_error("Fila " + std::to_string(fila) + " con formato inesperado: " +
+                             std::string(linea.substr(0, 120)));
+}
+
+// Valor numérico para ordenar costos y calcular extremos ("inf" incluido)
+double valorCosto(std::string_view costo) {
+    return std::strtod(std::string(costo).c_str(), nullptr);
+}
+
+// Codifica las líneas [inicio, fin) del CSV; `primera_fila` solo es para los errores
+void codificarBloque(const char* inicio, const char* fin, uint64_t primera_fila,
+                     std::string& datos, EstadisticasBloque& estadisticas) {
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> codigos_costo, validas, horas, codigos_texto;
+    std::unordered_map<std::string_view, uint32_t> indice_costos, indice_textos;
+    std::vector<std::string_view> costos, textos;
+
+    estadisticas = EstadisticasBloque();
+    estadisticas.costo_min = std::numeric_limits<double>::infinity();
+    estadisticas.costo_max = -std::numeric_limits<double>::infinity();
+    estadisticas.horas_min = 255;
+
+    char patron[24];
+    char numero[16];
+    uint64_t fila = primera_fila;
+    for (const char* p = inicio; p < fin; fila++) {
+        const char* fin_linea = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(fin - p)));
+        if (fin_linea == nullptr) fin_linea = fin;
+        std::string_view linea(p, static_cast<size_t>(fin_linea - p));
+        p = fin_linea + 1;
+
+        // Cinco campos fijos y el texto final (puede estar vacío y tener '-')
+        std::string_view campos[6];
+        size_t pos = 0;
+        for (int c = 0; c < 5; c++) {
+            size_t coma = linea.find(',', pos);
+            if (coma == std::string_view::npos) filaInvalida(fila, linea);
+            campos[c] = linea.substr(pos, coma - pos);
+            pos = coma + 1;
+        }
+        campos[5] = linea.substr(pos);
+
+        // El ID y las horas se vuelven a escribir igual; el patrón se deriva del ID
+        uint32_t id = 0;
+        int horas_criticas = 0;
+        auto leido_id = std::from_chars(campos[0].data(), campos[0].data() + campos[0].size(), id);
+        auto leidas_horas = std::from_chars(campos[4].data(), campos[4].data() + campos[4].size(), horas_criticas);
+        if (leido_id.ec != std::errc() || leido_id.ptr != campos[0].data() + campos[0].size() ||
+            leidas_horas.ec != std::errc() || leidas_horas.ptr != campos[4].data() + campos[4].size() ||
+            horas_criticas < 0 || horas_criticas > 24 ||
+            std::string_view(numero, escribirEnteroCsv(numero, id) - numero) != campos[0] ||
+            std::string_view(numero, escribirEnteroCsv(numero, horas_criticas) - numero) != campos[4] ||
+            id > 0xFFFFFF || std::string_view(patron, escribirPatronCsv(patron, id) - patron) != campos[1] ||
+            (campos[3] != "SI" && campos[3] != "NO")) {
+            filaInvalida(fila, linea);
+        }
+        bool valida = campos[3] == "SI";
+
+        auto costo = indice_costos.emplace(campos[2], static_cast<uint32_t>(costos.size()));
+        if (costo.second) costos.push_back(campos[2]);
+        auto texto = indice_textos.emplace(campos[5], static_cast<uint32_t>(textos.size()));
+        if (texto.second) textos.push_back(campos[5]);
+
+        ids.push_back(id);
+        codigos_costo.push_back(costo.first->second);
+        validas.push_back(valida ? 1 : 0);
+        horas.push_back(static_cast<uint32_t>(horas_criticas));
+        codigos_texto.push_back(texto.first->second);
+
+        if (valida) {
+            double valor = valorCosto(campos[2]);
+            estadisticas.validas++;
+            estadisticas.costo_min = std::min(estadisticas.costo_min, valor);
+            estadisticas.costo_max = std::max(estadisticas.costo_max, valor);
+        }
+        estadisticas.horas_min = std::min<uint8_t>(estadisticas.horas_min, static_cast<uint8_t>(horas_criticas));
+        estadisticas.horas_max = std::max<uint8_t>(estadisticas.horas_max, static_cast<uint8_t>(horas_criticas));
+    }
+
+    // Diccionario de costos en orden numérico: los códigos quedan ordenados como los costos
+    std::vector<uint32_t> orden(costos.size());
+    for (uint32_t i = 0; i < orden.size(); i++) orden[i] = i;
+    std::vector<double> valores(costos.size());
+    for (size_t i = 0; i < costos.size(); i++) valores[i] = valorCosto(costos[i]);
+    std::sort(orden.begin(), orden.end(), [&](uint32_t a, uint32_t b) {
+        return valores[a] != valores[b] ? valores[a] < valores[b] : costos[a] < costos[b];
+    });
+    std::vector<uint32_t> nuevo_codigo(costos.size());
+    std::vector<std::string_view> costos_ordenados(costos.size());
+    for (uint32_t i = 0; i < orden.size(); i++) {
+        nuevo_codigo[orden[i]] = i;
+        costos_ordenados[i] = costos[orden[i]];
+    }
+    for (uint32_t& codigo : codigos_costo) codigo = nuevo_codigo[codigo];
+
+    estadisticas.filas = static_cast<uint32_t>(ids.size());
+    estadisticas.id_min = *std::min_element(ids.begin(), ids.end());
+    estadisticas.id_max = *std::max_element(ids.begin(), ids.end());
+    bool consecutivos = true;
+    for (size_t i = 1; i < ids.size() && consecutivos; i++) {
+        consecutivos = ids[i] == ids[0] + i;
+    }
+
+    datos.clear();
+    agregarU32(datos, estadisticas.filas);
+    agregarU32(datos, ids[0]);
+    datos.push_back(consecutivos ? 1 : 0);
+    if (!consecutivos) {
+        // Deltas con signo en zigzag: el CSV no tiene por qué estar ordenado
+        for (size_t i = 1; i < ids.size(); i++) {
+            int64_t delta = int64_t(ids[i]) - int64_t(ids[i - 1]);
+            agregarVarint(datos, static_cast<uint32_t>((delta << 1) ^ (delta >> 63)));
+        }
+    }
+    agregarDiccionario(datos, costos_ordenados);
+    datos.push_back(static_cast<char>(bitsPara(costos.size())));
+    empaquetar(datos, codigos_costo, bitsPara(costos.size()));
+    empaquetar(datos, validas, 1);
+    empaquetar(datos, horas, 5);
+    agregarDiccionario(datos, textos);
+    datos.push_back(static_cast<char>(bitsPara(textos.size())));
+    empaquetar(datos, codigos_texto, bitsPara(textos.size()));
+}
+
+BloqueColumnar decodificarBloque(const std::string& datos) {
+    Cursor cursor{reinterpret_cast<const uint8_t*>(datos.data()),
+                  reinterpret_cast<const uint8_t*>(datos.data()) + datos.size()};
+    BloqueColumnar bloque;
+    uint32_t filas = cursor.u32();
+    uint32_t primer_id = cursor.u32();
+    cursor.exigir(1);
+    bool consecutivos = *cursor.p++ != 0;
+    if (filas == 0 || filas > datos.size() * 8) {
+        throw std::runtime_error("Bloque columnar corrupto (filas)");
+    }
+
+    bloque.ids.resize(filas);
+    bloque.ids[0] = primer_id;
+    for (uint32_t i = 1; i < filas; i++) {
+        if (consecutivos) {
+            bloque.ids[i] = primer_id + i;
+        } else {
+            uint32_t zigzag = cursor.varint();
+            int64_t delta = int64_t(zigzag >> 1) ^ -int64_t(zigzag & 1);
+            bloque.ids[i] = static_cast<uint32_t>(int64_t(bloque.ids[i - 1]) + delta);
+        }
+    }
+
+    bloque.costos = cursor.diccionario();
+    cursor.exigir(1);
+    unsigned bits_costo = *cursor.p++;
+    bloque.codigos_costo = cursor.codigos(filas, bits_costo, bloque.costos.size());
+    std::vector<uint32_t> validas = cursor.codigos(filas, 1, 2);
+    std::vector<uint32_t> horas = cursor.codigos(filas, 5, 25);
+    bloque.validas.assign(validas.begin(), validas.end());
+    bloque.horas_criticas.assign(horas.begin(), horas.end());
+
+    bloque.textos = cursor.diccionario();
+    cursor.exigir(1);
+    unsigned bits_texto = *cursor.p++;
+    bloque.codigos_texto = cursor.codigos(filas, bits_texto, bloque.textos.size());
+    if (bloque.costos.empty() || bloque.textos.empty()) {
+        throw std::runtime_error("Bloque columnar corrupto (diccionario vacío)");
+    }
+    return bloque;
+}
+
+void escribirTodo(std::ofstream& salida, const std::string& datos, const std::string& archivo) {
+    salida.write(datos.data(), static_cast<std::streamsize>(datos.size()));
+    if (!salida) {
+        throw std::runtime_error("Error al escribir " + archivo);
+    }
+}
+}
+
+// --- BloqueColumnar ---
+
+double BloqueColumnar::costo(size_t fila) const {
+    return valorCosto(costos[codigos_costo[fila]]);
+}
+
+void BloqueColumnar::agregarFilaCsv(size_t fila, std::string& salida) const {
+    char inicio[64];
+    char* p = escribirEnteroCsv(inicio, ids[fila]);
+    *p++ = ',';
+    p = escribirPatronCsv(p, ids[fila]);
+    *p++ = ',';
+    salida.append(inicio, static_cast<size_t>(p - inicio));
+    salida += costos[codigos_costo[fila]];
+    p = inicio;
+    *p++ = ',';
+    std::memcpy(p, validas[fila] ? "SI," : "NO,", 3);
+    p += 3;
+    p = escribirEnteroCsv(p, horas_criticas[fila]);
+    *p++ = ',';
+    salida.append(inicio, static_cast<size_t>(p - inicio));
+    salida += textos[codigos_texto[fila]];
+    salida += '\n';
+}
+
+// --- Opciones y nombres ---
+
+OpcionesColumnar::OpcionesColumnar() :
+    num_hilos(0), filas_por_bloque(65536), compresion(compresionDisponible()) {}
+
+CompresionColumnar compresionDisponible() {
+#if defined(USAR_ZSTD)
+    return CompresionColumnar::ZSTD;
+#elif defined(USAR_ZLIB)
+    return CompresionColumnar::ZLIB;
+#else
+    return CompresionColumnar::NINGUNA;
+#endif
+}
+
+const char* nombreCompresion(CompresionColumnar compresion) {
+    switch (compresion) {
+        case CompresionColumnar::NINGUNA: return "ninguna";
+        case CompresionColumnar::ZLIB: return "zlib";
+        case CompresionColumnar::ZSTD: return "zstd";
+        default: return "desconocida";
+    }
+}
+
+// --- Compresión y descompresión de archivos ---
+
+ResultadoColumnar comprimirResultados(const std::string& csv, const std::string& salida,
+                                      const OpcionesColumnar& opciones) {
+    if (opciones.filas_por_bloque == 0) {
+        throw std::invalid_argument("Las filas por bloque deben ser mayores que cero");
+    }
+    Mapa entrada(csv);
+    const char* datos = reinterpret_cast<const char*>(entrada.datos);
+    const char* fin = datos + entrada.tam;
+
+    // Cabecera CSV: las cinco columnas fijas y Transiciones o SecuenciaEstados
+    const char* fin_cabecera = static_cast<const char*>(std::memchr(datos, '\n', entrada.tam));
+    if (fin_cabecera == nullptr) {
+        throw std::runtime_error("El CSV no tiene filas: " + csv);
+    }
+    std::string columnas(datos, fin_cabecera);
+    if (columnas.compare(0, COLUMNAS_FIJAS.size(), COLUMNAS_FIJAS) != 0 ||
+        columnas.find(',', COLUMNAS_FIJAS.size()) != std::string::npos) {
+        throw std::runtime_error("No es un CSV de resultados conocido: " + csv);
+    }
+    if (fin[-1] != '\n') {
+        throw std::runtime_error("El CSV termina en una fila incompleta: " + csv);
+    }
+
+    // Inicio de cada bloque de filas (una pasada con memchr)
+    std::vector<const char*> inicios;
+    uint64_t filas = 0;
+    for (const char* p = fin_cabecera + 1; p < fin; filas++) {
+        if (filas % opciones.filas_por_bloque == 0) inicios.push_back(p);
+        p = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(fin - p))) + 1;
+    }
+    inicios.push_back(fin);
+    if (filas == 0 || filas > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Cantidad de filas no soportada en " + csv);
+    }
+    uint32_t num_bloques = static_cast<uint32_t>(inicios.size() - 1);
+
+    std::ofstream archivo(salida, std::ios::binary | std::ios::trunc);
+    if (!archivo.is_open()) {
+        throw std::runtime_error("No se pudo crear " + salida);
+    }
+    CabeceraColumnar cabecera;
+    std::memset(&cabecera, 0, sizeof(cabecera));
+    std::memcpy(cabecera.magia, MAGIA_COLUMNAR, sizeof(MAGIA_COLUMNAR));
+    cabecera.version = VERSION_COLUMNAR;
+    cabecera.compresion = static_cast<uint32_t>(opciones.compresion);
+    cabecera.filas_por_bloque = opciones.filas_por_bloque;
+    cabecera.num_bloques = num_bloques;
+    cabecera.filas = filas;
+    cabecera.bytes_columnas = static_cast<uint32_t>(columnas.size());
+    // offset_directorio = 0 hasta terminar: un archivo cortado no se puede abrir
+    escribirTodo(archivo, std::string(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera)) + columnas, salida);
+    uint64_t offset = sizeof(cabecera) + columnas.size();
+
+    // Codificar y comprimir en paralelo; los bloques se escriben en orden
+    std::vector<EstadisticasBloque> directorio(num_bloques);
+    PoolBloques pool(opciones.num_hilos, 1);
+    auto procesar = [&](const PoolBloques::Bloque& bloque, unsigned, std::string& comprimido) {
+        std::string datos_bloque;
+        uint32_t i = bloque.indice;
+        codificarBloque(inicios[i], inicios[i + 1], uint64_t(i) * opciones.filas_por_bloque + 1,
+                        datos_bloque, directorio[i]);
+        comprimirDatos(datos_bloque, opciones.compresion, comprimido);
+        directorio[i].bytes_datos = static_cast<uint32_t>(datos_bloque.size());
+        directorio[i].bytes_comprimidos = static_cast<uint32_t>(comprimido.size());
+    };
+    auto emitir = [&](const PoolBloques::Bloque& bloque, std::string& comprimido) {
+        directorio[bloque.indice].offset = offset;
+        escribirTodo(archivo, comprimido, salida);
+        offset += comprimido.size();
+    };
+    pool.ejecutar(0, num_bloques, procesar, emitir);
+
+    escribirTodo(archivo, std::string(reinterpret_cast<const char*>(directorio.data()),
+                                      directorio.size() * sizeof(EstadisticasBloque)), salida);
+    cabecera.offset_directorio = offset;
+    archivo.seekp(0);
+    escribirTodo(archivo, std::string(reinterpret_cast<const char*>(&cabecera), sizeof(cabecera)), salida);
+    archivo.close();
+    if (!archivo) {
+        throw std::runtime_error("Error al cerrar " + salida);
+    }
+
+    ResultadoColumnar resultado;
+    resultado.filas = filas;
+    resultado.bloques = num_bloques;
+    resultado.bytes_entrada = entrada.tam;
+    resultado.bytes_salida = offset + directorio.size() * sizeof(EstadisticasBloque);
+    return resultado;
+}
+
+ResultadoColumnar descomprimirResultados(const std::string& archivo, const std::string& csv, unsigned num_hilos) {
+    ArchivoColumnar columnar(archivo);
+    std::ofstream salida(csv, std::ios::binary | std::ios::trunc);
+    if (!salida.is_open()) {
+        throw std::runtime_error("No se pudo crear " + csv);
+    }
+    escribirTodo(salida, columnar.columnas() + "\n", csv);
+
+    PoolBloques pool(num_hilos, 1);
+    auto procesar = [&](const PoolBloques::Bloque& bloque, unsigned, std::string& texto) {
+        BloqueColumnar filas = columnar.leerBloque(bloque.indice);
+        for (size_t i = 0; i < filas.filas(); i++) {
+            filas.agregarFilaCsv(i, texto);
+        }
+    };
+    uint64_t bytes = columnar.columnas().size() + 1;
+    auto emitir = [&](const PoolBloques::Bloque&, std::string& texto) {
+        escribirTodo(salida, texto, csv);
+        bytes += texto.size();
+    };
+    pool.ejecutar(0, static_cast<uint32_t>(columnar.bloques().size()), procesar, emitir);
+    salida.close();
+    if (!salida) {
+        throw std::runtime_error("Error al cerrar " + csv);
+    }
+
+    ResultadoColumnar resultado;
+    resultado.filas = columnar.cabecera().filas;
+    resultado.bloques = columnar.cabecera().num_bloques;
+    resultado.bytes_entrada = columnar.bytes();
+    resultado.bytes_salida = bytes;
+    return resultado;
+}
+
+// --- ArchivoColumnar ---
+
+ArchivoColumnar::ArchivoColumnar(const std::string& archivo) : archivo_(archivo), datos_(nullptr), tam_(0) {
+    int fd = open(archivo.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("No se pudo abrir " + archivo);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(CabeceraColumnar)) {
+        close(fd);
+        throw std::runtime_error("Archivo columnar vacío o ilegible: " + archivo);
+    }
+    tam_ = static_cast<size_t>(info.st_size);
+    void* mapa = mmap(nullptr, tam_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        throw std::runtime_error("No se pudo mapear " + archivo);
+    }
+    datos_ = static_cast<const uint8_t*>(mapa);
+
+    std::memcpy(&cabecera_, datos_, sizeof(cabecera_));
+    uint64_t bytes_directorio = uint64_t(cabecera_.num_bloques) * sizeof(EstadisticasBloque);
+    const char* error = nullptr;
+    if (std::memcmp(cabecera_.magia, MAGIA_COLUMNAR, sizeof(MAGIA_COLUMNAR)) != 0) {
+        error = "No es un archivo columnar de resultados: ";
+    } else if (cabecera_.version != VERSION_COLUMNAR) {
+        error = "Archivo columnar de una versión incompatible: ";
+    } else if (cabecera_.offset_directorio == 0) {
+        error = "Archivo columnar incompleto (la compresión no terminó): ";
+    } else if (sizeof(cabecera_) + uint64_t(cabecera_.bytes_columnas) > cabecera_.offset_directorio ||
+               cabecera_.offset_directorio + bytes_directorio != tam_) {
+        error = "Archivo columnar truncado o con offsets inválidos: ";
+    }
+    if (error) {
+        munmap(const_cast<uint8_t*>(datos_), tam_);
+        throw std::runtime_error(error + archivo);
+    }
+
+    columnas_.assign(reinterpret_cast<const char*>(datos_) + sizeof(cabecera_), cabecera_.bytes_columnas);
+    bloques_.resize(cabecera_.num_bloques);
+    std::memcpy(bloques_.data(), datos_ + cabecera_.offset_directorio, bytes_directorio);
+    for (const EstadisticasBloque& bloque : bloques_) {
+        if (bloque.offset + bloque.bytes_comprimidos > cabecera_.offset_directorio) {
+            munmap(const_cast<uint8_t*>(datos_), tam_);
+            throw std::runtime_error("Directorio columnar inválido: " + archivo);
+        }
+    }
+}
+
+ArchivoColumnar::~ArchivoColumnar() {
+    munmap(const_cast<uint8_t*>(datos_), tam_);
+}
+
+BloqueColumnar ArchivoColumnar::leerBloque(size_t indice) const {
+    const EstadisticasBloque& estadisticas = bloques_.at(indice);
+    std::string datos;
+    descomprimirDatos(datos_ + estadisticas.offset, estadisticas.bytes_comprimidos, estadisticas.bytes_datos,
+                      static_cast<CompresionColumnar>(cabecera_.compresion), datos);
+    BloqueColumnar bloque = decodificarBloque(datos);
+    if (bloque.filas() != estadisticas.filas) {
+        throw std::runtime_error("Bloque columnar corrupto (filas): " + archivo_);
+    }
+    return bloque;
+}
@@ -0,0 +1,142 @@
+#include "formato_csv.hpp"
+#include <charconv>
+#include <cstring>
+
+namespace {
+// Los 8 bits de cada byte como caracteres, del más significativo al menos
+struct TablaBytes {
+    char bits[256][8];
+
+    constexpr TablaBytes() : bits() {
+        for (int valor = 0; valor < 256; valor++) {
+            for (int bit = 0; bit < 8; bit++) {
+                bits[valor][bit] = (valor >> (7 - bit)) & 1 ? '1' : '0';
+            }
+        }
+    }
+};
+constexpr TablaBytes TABLA_BYTES;
+
+struct NombreEstado {
+    const char* texto;
+    size_t largo;
+};
+// En el orden de EstadoMaquina
+constexpr NombreEstado NOMBRES_ESTADO[] = {
+    {"ON_CALIENTE", 11}, {"OFF_CALIENTE", 12}, {"ON_TIBIO", 8},
+    {"OFF_TIBIO", 9},    {"ON_FRIO", 7},       {"OFF_FRIO", 8},
+};
+constexpr NombreEstado ESTADO_DESCONOCIDO = {"DESCONOCIDO", 11};
+
+const NombreEstado& buscarNombre(EstadoMaquina estado) {
+    size_t indice = static_cast<size_t>(estado);
+    return indice < sizeof(NOMBRES_ESTADO) / sizeof(NOMBRES_ESTADO[0]) ? NOMBRES_ESTADO[indice] : ESTADO_DESCONOCIDO;
+}
+
+char* escribirHora(char* p, int hora) {
+    if (hora >= 10) {
+        *p++ = static_cast<char>('0' + hora / 10);
+    }
+    *p++ = static_cast<char>('0' + hora % 10);
+    return p;
+}
+}
+
+char* escribirEnteroCsv(char* p, uint64_t valor) {
+    return std::to_chars(p, p + 20, valor).ptr;
+}
+
+char* escribirPatronCsv(char* p, uint32_t combinacion) {
+    std::memcpy(p, TABLA_BYTES.bits[(combinacion >> 16) & 0xFF], 8);
+    std::memcpy(p + 8, TABLA_BYTES.bits[(combinacion >> 8) & 0xFF], 8);
+    std::memcpy(p + 16, TABLA_BYTES.bits[combinacion & 0xFF], 8);
+    return p + 24;
+}
+
+char* escribirCostoCsv(char* p, double costo) {
+    // Máximo: signo, 309 dígitos enteros, punto y 2 decimales
+    return std::to_chars(p, p + 320, costo, std::chars_format::fixed, 2).ptr;
+}
+
+const char* nombreEstado(EstadoMaquina estado) {
+    return buscarNombre(estado).texto;
+}
+
+char* escribirEstadoCsv(char* p, EstadoMaquina estado) {
+    const NombreEstado& nombre = buscarNombre(estado);
+    std::memcpy(p, nombre.texto, nombre.largo);
+    return p + nombre.largo;
+}
+
+char* escribirSecuenciaCsv(char* p, const std::vector<EstadoMaquina>& estados) {
+    for (size_t i = 0; i < estados.size(); i++) {
+        if (i > 0) *p++ = '-';
+        p = escribirEstadoCsv(p, estados[i]);
+    }
+    return p;
+}
+
+char* escribirTransicionesCsv(char* p, uint32_t mascara_encendido) {
+    // Misma regla que generarTransiciones: hora 0 si arranca prendida, cada
+    // cambio, y la 23 si termina prendida y no es ya la última
+    bool anterior = false;
+    int ultima = -1;
+    for (int hora = 0; hora < 24; hora++) {
+        bool actual = (mascara_encendido >> hora) & 1u;
+        if (actual != anterior) {
+            if (ultima >= 0) *p++ = '-';
+            p = escribirHora(p, hora);
+            ultima = hora;
+        }
+        anterior = actual;
+    }
+    if (anterior && ultima >= 0 && ultima != 23) {
+        *p++ = '-';
+        p = escribirHora(p, 23);
+    }
+    return p;
+}
+
+char* escribirFilaTransicionesCsv(char* p, uint32_t combinacion, double costo_total, bool solucion_valida,
+                                  int horas_criticas, uint32_t mascara_encendido) {
+    p = escribirEnteroCsv(p, combinacion);
+    *p++ = ',';
+    p = escribirPatronCsv(p, combinacion);
+    *p++ = ',';
+    p = escribirCostoCsv(p, costo_total);
+    *p++ = ',';
+    std::memcpy(p, solucion_valida ? "SI," : "NO,", 3);
+    p += 3;
+    p = std::to_chars(p, p + 12, horas_criticas).ptr;
+    *p++ = ',';
+    if (solucion_valida) {
+        p = escribirTransicionesCsv(p, mascara_encendido);
+    }
+    *p++ = '\n';
+    return p;
+}
+
+void agregarFilaTransicionesCsv(std::string& destino, uint32_t combinacion, double costo_total,
+                                bool solucion_valida, int horas_criticas, uint32_t mascara_encendido) {
+    char fila[MAX_FILA_CSV];
+    char* fin = escribirFilaTransicionesCsv(fila, combinacion, costo_total, solucion_valida,
+                                            horas_criticas, mascara_encendido);
+    destino.append(fila, static_cast<size_t>(fin - fila));
+}
+
+char* escribirFilaSecuenciaCsv(char* p, uint32_t combinacion, double costo_total, bool solucion_valida,
+                               int horas_criticas, const std::vector<EstadoMaquina>& estados) {
+    p = escribirEnteroCsv(p, combinacion);
+    *p++ = ',';
+    p = escribirPatronCsv(p, combinacion);
+    *p++ = ',';
+    p = escribirCostoCsv(p, costo_total);
+    *p++ = ',';
+    std::memcpy(p, solucion_valida ? "SI," : "NO,", 3);
+    p += 3;
+    p = std::to_chars(p, p + 12, horas_criticas).ptr;
+    *p++ = ',';
+    p = escribirSecuenciaCsv(p, estados);
+    *p++ = '\n';
+    return p;
+}
@@ -0,0 +1,199 @@
+#include "resumen_agregado.hpp"
+#include "shard_barrido.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Junta los shards de un barrido (ver shard_barrido.hpp) en un solo CSV en orden
+// de ID y combina sus resúmenes agregados. Los shards se leen con mmap y la copia
+// va en paralelo: cada hilo toma el siguiente shard libre y escribe sus filas con
+// pwrite directamente en su posición final del archivo de salida.
+//
+// Uso: fusionar_shards [--hilos N] salida.csv shard1 shard2 ...
+// El resumen combinado queda en salida_resumen.txt.
+
+namespace {
+// Escribir un bloque completo en `offset`, reintentando escrituras parciales
+void escribirEn(int fd, const char* datos, size_t bytes, off_t offset) {
+    while (bytes > 0) {
+        ssize_t escritos = pwrite(fd, datos, bytes, offset);
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Error al escribir la salida: ") + std::strerror(errno));
+        }
+        datos += escritos;
+        bytes -= static_cast<size_t>(escritos);
+        offset += escritos;
+    }
+}
+
+// Todos completos, del mismo generador y parámetros, y cubriendo un rango sin huecos
+void verificarShards(const std::vector<std::unique_ptr<ShardMapeado>>& shards) {
+    const MetadatosShard& base = shards[0]->metadatos();
+    for (size_t i = 0; i < shards.size(); i++) {
+        const ShardMapeado& shard = *shards[i];
+        const MetadatosShard& metadatos = shard.metadatos();
+        if (!shard.completo()) {
+            throw std::runtime_error("El shard " + shard.archivo() + " está incompleto (su trabajo no terminó)");
+        }
+        if (metadatos.generador != base.generador || metadatos.columnas != base.columnas ||
+            metadatos.parametros != base.parametros) {
+            throw std::runtime_error("El shard " + shard.archivo() + " se generó con otros parámetros que " +
+                                     shards[0]->archivo());
+        }
+        if (shard.resumen().combinaciones != metadatos.hasta - metadatos.desde) {
+            throw std::runtime_error("El resumen de " + shard.archivo() + " no cubre su rango");
+        }
+        if (i == 0) continue;
+
+        const MetadatosShard& anterior = shards[i - 1]->metadatos();
+        if (metadatos.desde > anterior.hasta) {
+            throw std::runtime_error("Faltan las combinaciones [" + std::to_string(anterior.hasta) + ", " +
+                                     std::to_string(metadatos.desde) + ")");
+        }
+        if (metadatos.desde < anterior.hasta) {
+            throw std::runtime_error("Los shards " + shards[i - 1]->archivo() + " y " + shard.archivo() +
+                                     " se superponen");
+        }
+    }
+}
+}
+
+int main(int argc, char* argv[]) {
+    unsigned num_hilos = 0;
+    std::string salida;
+    std::vector<std::string> archivos;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--hilos" && i + 1 < argc) {
+            num_hilos = std::stoul(argv[++i]);
+        } else if (salida.empty()) {
+            salida = arg;
+        } else {
+            archivos.push_back(arg);
+        }
+    }
+    if (salida.empty() || archivos.empty()) {
+        std::cerr << "Uso: " << argv[0] << " [--hilos N] salida.csv shard1 shard2 ...\n";
+        return 1;
+    }
+    if (num_hilos == 0) {
+        num_hilos = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::cout << "=== FUSIÓN DE SHARDS ===\n";
+
+    try {
+        std::vector<std::unique_ptr<ShardMapeado>> shards;
+        for (const std::string& archivo : archivos) {
+            shards.push_back(std::make_unique<ShardMapeado>(archivo));
+        }
+        std::sort(shards.begin(), shards.end(),
+                  [](const std::unique_ptr<ShardMapeado>& a, const std::unique_ptr<ShardMapeado>& b) {
+                      return a->metadatos().desde < b->metadatos().desde;
+                  });
+        verificarShards(shards);
+
+        // Posición final de las filas de cada shard, después de la cabecera CSV
+        std::string cabecera = shards[0]->metadatos().columnas + "\n";
+        std::vector<off_t> posiciones(shards.size());
+        off_t total_bytes = static_cast<off_t>(cabecera.size());
+        for (size_t i = 0; i < shards.size(); i++) {
+            posiciones[i] = total_bytes;
+            total_bytes += static_cast<off_t>(shards[i]->bytesFilas());
+        }
+
+        int fd = open(salida.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("No se pudo crear " + salida + ": " + std::strerror(errno));
+        }
+        if (ftruncate(fd, total_bytes) != 0) {
+            close(fd);
+            throw std::runtime_error("No se pudo reservar " + salida + ": " + std::strerror(errno));
+        }
+
+        num_hilos = static_cast<unsigned>(std::min<size_t>(num_hilos, shards.size()));
+        std::vector<std::unique_ptr<ResumenAgregado>> resumenes;
+        for (unsigned h = 0; h < num_hilos; h++) {
+            resumenes.push_back(std::make_unique<ResumenAgregado>());
+        }
+        std::atomic<size_t> siguiente(0);
+        std::mutex mutex_error;
+        std::exception_ptr error;
+
+        auto trabajador = [&](unsigned hilo) {
+            try {
+                if (hilo == 0) {
+                    escribirEn(fd, cabecera.data(), cabecera.size(), 0);
+                }
+                for (size_t i = siguiente++; i < shards.size(); i = siguiente++) {
+                    escribirEn(fd, shards[i]->filas(), shards[i]->bytesFilas(), posiciones[i]);
+                    resumenes[hilo]->combinar(shards[i]->resumen());
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_error);
+                if (!error) error = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> hilos;
+        for (unsigned h = 0; h < num_hilos; h++) {
+            hilos.emplace_back(trabajador, h);
+        }
+        for (std::thread& hilo : hilos) {
+            hilo.join();
+        }
+        if (close(fd) != 0 && !error) {
+            throw std::runtime_error("Error al cerrar " + salida + ": " + std::strerror(errno));
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+
+        // La combinación es conmutativa: el orden en que cada hilo tomó shards no importa
+        ResumenAgregado& resumen = *resumenes[0];
+        for (unsigned h = 1; h < num_hilos; h++) {
+            resumen.combinar(*resumenes[h]);
+        }
+
+        std::string base = salida;
+        if (base.size() > 4 && base.compare(base.size() - 4, 4, ".csv") == 0) {
+            base.erase(base.size() - 4);
+        }
+        std::string archivo_resumen = base + "_resumen.txt";
+        std::ofstream salida_resumen(archivo_resumen);
+        resumen.imprimirReporte(salida_resumen, std::numeric_limits<size_t>::max());
+        salida_resumen.close();
+
+        std::cout << "Shards fusionados: " << shards.size() << " (" << num_hilos << " hilo(s))\n";
+        std::cout << "Combinaciones: [" << shards.front()->metadatos().desde << ", "
+                  << shards.back()->metadatos().hasta << ") = " << resumen.combinaciones << "\n";
+        std::cout << "Soluciones válidas: " << resumen.soluciones_validas << "\n";
+        if (resumen.soluciones_validas > 0) {
+            std::cout << "Mejor costo encontrado: " << std::fixed << std::setprecision(2) << resumen.baratos[0].costo
+                      << " (combinación #" << resumen.baratos[0].combinacion_id << ")\n";
+            std::cout << "Costo promedio: " << resumen.suma_centesimas / 100.0 / resumen.soluciones_validas << "\n";
+        }
+        std::cout << "Resultados guardados en: " << salida << "\n";
+        std::cout << "Resumen agregado guardado en: " << archivo_resumen << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,273 @@
+#include "indice_resultados.hpp"
+#include "cubo_resultados.hpp"
+#include "formato_columnar.hpp"
+#include "lector_resultados.hpp"
+#include "pool_bloques.hpp"
+#include <cerrno>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace {
+// Lo que se guarda de cada fila del origen
+struct ColumnasOrigen {
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> costos;          // COSTO_INVALIDO si no hay solución
+    std::vector<uint32_t> mascaras;
+    std::vector<uint8_t> horas;
+    std::vector<uint64_t> posiciones;      // Solo CSV
+
+    void reservar(size_t filas, bool con_posiciones) {
+        ids.reserve(filas);
+        costos.reserve(filas);
+        mascaras.reserve(filas);
+        horas.reserve(filas);
+        if (con_posiciones) posiciones.reserve(filas);
+    }
+};
+
+uint64_t alinear64(uint64_t offset) {
+    return (offset + 63) & ~uint64_t(63);
+}
+
+std::string leerColumnasCsv(const std::string& origen, ColumnasOrigen& columnas, unsigned num_hilos) {
+    int fd = open(origen.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("No se pudo abrir " + origen);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        throw std::invalid_argument("Archivo vacío o ilegible: " + origen);
+    }
+    size_t tam = static_cast<size_t>(info.st_size);
+    void* mapa = mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        throw std::runtime_error("No se pudo mapear " + origen);
+    }
+    madvise(mapa, tam, MADV_SEQUENTIAL);
+    const char* datos = static_cast<const char*>(mapa);
+    const char* fin = datos + tam;
+
+    try {
+        const char* fin_cabecera = static_cast<const char*>(std::memchr(datos, '\n', tam));
+        if (fin_cabecera == nullptr) fin_cabecera = fin;
+        std::string cabecera(datos, fin_cabecera);
+        if (!cabecera.empty() && cabecera.back() == '\r') cabecera.pop_back();
+        ColumnaTexto columna = columnaTextoDeCabecera(cabecera);
+
+        // Tramos cortados en fin de línea; cada uno llena sus propias columnas
+        const size_t TAM_TRAMO = 8u << 20;
+        std::vector<const char*> cortes{std::min(fin_cabecera + 1, fin)};
+        while (cortes.back() < fin) {
+            const char* corte = cortes.back() + std::min(TAM_TRAMO, static_cast<size_t>(fin - cortes.back()));
+            const char* salto = corte < fin ? static_cast<const char*>(std::memchr(corte, '\n', fin - corte)) : nullptr;
+            cortes.push_back(salto ? salto + 1 : fin);
+        }
+        std::vector<ColumnasOrigen> tramos(cortes.size() - 1);
+
+        PoolBloques pool(num_hilos, 1);
+        auto procesar = [&](const PoolBloques::Bloque& bloque, unsigned, std::string&) {
+            ColumnasOrigen& tramo = tramos[bloque.indice];
+            FilaResultado fila;
+            for (const char* p = cortes[bloque.indice], *hasta = cortes[bloque.indice + 1]; p < hasta;) {
+                const char* salto = static_cast<const char*>(std::memchr(p, '\n', hasta - p));
+                const char* fin_linea = salto ? salto : hasta;
+                std::string_view linea(p, static_cast<size_t>(fin_linea - p));
+                uint64_t posicion = static_cast<uint64_t>(p - datos);
+                p = fin_linea + 1;
+                if (linea.empty()) continue;
+                if (!interpretarFilaResultado(linea, columna, fila)) {
+                    throw std::invalid_argument("Fila con formato inválido en el byte " + std::to_string(posicion) +
+                                                " de " + origen);
+                }
+                tramo.ids.push_back(fila.combinacion_id);
+                tramo.costos.push_back(fila.solucion_valida ? claveCosto(fila.costo_total) : COSTO_INVALIDO);
+                tramo.mascaras.push_back(fila.mascara_encendido);
+                tramo.horas.push_back(static_cast<uint8_t>(fila.horas_criticas));
+                tramo.posiciones.push_back(posicion);
+            }
+        };
+        // Los tramos se juntan en orden al emitirlos
+        auto emitir = [&](const PoolBloques::Bloque& bloque, std::string&) {
+            ColumnasOrigen& tramo = tramos[bloque.indice];
+            columnas.ids.insert(columnas.ids.end(), tramo.ids.begin(), tramo.ids.end());
+            columnas.costos.insert(columnas.costos.end(), tramo.costos.begin(), tramo.costos.end());
+            columnas.mascaras.insert(columnas.mascaras.end(), tramo.mascaras.begin(), tramo.mascaras.end());
+            columnas.horas.insert(columnas.horas.end(), tramo.horas.begin(), tramo.horas.end());
+            columnas.posiciones.insert(columnas.posiciones.end(), tramo.posiciones.begin(), tramo.posiciones.end());
+            tramo = ColumnasOrigen();
+        };
+        pool.ejecutar(0, static_cast<uint32_t>(tramos.size()), procesar, emitir);
+        munmap(mapa, tam);
+        return cabecera;
+    } catch (...) {
+        munmap(mapa, tam);
+        throw;
+    }
+}
+
+std::string leerColumnasCubo(const std::string& origen, ColumnasOrigen& columnas) {
+    CuboResultados cubo(origen);
+    if (cubo.cabecera().escala_costo != ESCALA_COSTO_INDICE) {
+        throw std::invalid_argument("El cubo usa otra escala de costos: " + origen);
+    }
+    columnas.reservar(cubo.filas(), false);
+    for (uint32_t id = cubo.desde(); id < cubo.hasta(); id++) {
+        columnas.ids.push_back(id);
+        columnas.costos.push_back(cubo.costoCentesimas(id));
+        columnas.mascaras.push_back(cubo.mascaraEncendido(id));
+        columnas.horas.push_back(static_cast<uint8_t>(cubo.horasCriticas(id)));
+    }
+    return "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,SecuenciaEstados";
+}
+
+// Permutación de filas ordenada por (clave, fila): claves distintas, inicio de
+// cada lista y la permutación misma
+struct IndiceOrdenado {
+    std::vector<uint32_t> claves;
+    std::vector<uint64_t> inicios;
+    std::vector<uint32_t> filas;
+};
+
+template <typename FuncionClave>
+IndiceOrdenado ordenarPorClave(size_t num_filas, FuncionClave clave_de) {
+    std::vector<uint64_t> pares;
+    pares.reserve(num_filas);
+    uint32_t clave;
+    for (size_t fila = 0; fila < num_filas; fila++) {
+        if (clave_de(fila, clave)) {
+            pares.push_back(uint64_t(clave) << 32 | fila);
+        }
+    }
+    std::sort(pares.begin(), pares.end());
+
+    IndiceOrdenado indice;
+    indice.filas.reserve(pares.size());
+    for (size_t i = 0; i < pares.size(); i++) {
+        uint32_t actual = static_cast<uint32_t>(pares[i] >> 32);
+        if (indice.claves.empty() || indice.claves.back() != actual) {
+            indice.claves.push_back(actual);
+            indice.inicios.push_back(i);
+        }
+        indice.filas.push_back(static_cast<uint32_t>(pares[i]));
+    }
+    indice.inicios.push_back(pares.size());
+    return indice;
+}
+
+void escribirSeccion(std::ofstream& salida, const void* datos, size_t bytes) {
+    salida.write(static_cast<const char*>(datos), static_cast<std::streamsize>(bytes));
+    static const char ceros[64] = {};
+    uint64_t posicion = static_cast<uint64_t>(salida.tellp());
+    salida.write(ceros, static_cast<std::streamsize>(alinear64(posicion) - posicion));
+}
+}
+
+ResultadoIndice construirIndice(const std::string& origen, const std::string& destino, unsigned num_hilos) {
+    struct stat info;
+    if (stat(origen.c_str(), &info) != 0) {
+        throw std::runtime_error("No se pudo abrir " + origen);
+    }
+    char magia[8] = {};
+    {
+        std::ifstream entrada(origen, std::ios::binary);
+        entrada.read(magia, sizeof(magia));
+    }
+
+    ColumnasOrigen columnas;
+    CabeceraIndice cabecera;
+    std::memset(&cabecera, 0, sizeof(cabecera));
+    std::string nombres_columnas;
+    if (std::memcmp(magia, MAGIA_CUBO, sizeof(magia)) == 0) {
+        cabecera.origen = static_cast<uint32_t>(OrigenIndice::CUBO);
+        nombres_columnas = leerColumnasCubo(origen, columnas);
+    } else if (std::memcmp(magia, MAGIA_COLUMNAR, sizeof(magia)) == 0) {
+        throw std::invalid_argument("Los archivos columnares se indexan después de descomprimirlos (comprimir_resultados -d)");
+    } else {
+        cabecera.origen = static_cast<uint32_t>(OrigenIndice::CSV);
+        nombres_columnas = leerColumnasCsv(origen, columnas, num_hilos);
+    }
+    size_t num_filas = columnas.ids.size();
+    if (num_filas >= std::numeric_limits<uint32_t>::max()) {
+        throw std::invalid_argument("Demasiadas filas para indexar: " + origen);
+    }
+
+    IndiceOrdenado indices[NUM_CLAVES_INDICE] = {
+        ordenarPorClave(num_filas, [&](size_t fila, uint32_t& clave) {
+            clave = columnas.costos[fila];
+            return clave != COSTO_INVALIDO;
+        }),
+        ordenarPorClave(num_filas, [&](size_t fila, uint32_t& clave) {
+            clave = mascaraCanonica(columnas.mascaras[fila]);
+            return columnas.costos[fila] != COSTO_INVALIDO;
+        }),
+        ordenarPorClave(num_filas, [&](size_t fila, uint32_t& clave) {
+            clave = columnas.horas[fila];
+            return true;
+        }),
+    };
+
+    // Cabecera con todos los offsets antes de escribir nada
+    std::memcpy(cabecera.magia, MAGIA_INDICE, sizeof(MAGIA_INDICE));
+    cabecera.version = VERSION_INDICE;
+    cabecera.filas = num_filas;
+    cabecera.bytes_origen = static_cast<uint64_t>(info.st_size);
+    cabecera.modificacion_origen = int64_t(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+    cabecera.escala_costo = ESCALA_COSTO_INDICE;
+    size_t barra = origen.rfind('/');
+    std::string nombre = barra == std::string::npos ? origen : origen.substr(barra + 1);
+    std::strncpy(cabecera.archivo_origen, nombre.c_str(), sizeof(cabecera.archivo_origen) - 1);
+    std::strncpy(cabecera.columnas, nombres_columnas.c_str(), sizeof(cabecera.columnas) - 1);
+
+    uint64_t offset = BYTES_CABECERA_INDICE;
+    for (uint32_t t = 0; t < NUM_CLAVES_INDICE; t++) {
+        TablaIndice& tabla = cabecera.tablas[t];
+        tabla.num_claves = static_cast<uint32_t>(indices[t].claves.size());
+        tabla.num_filas = static_cast<uint32_t>(indices[t].filas.size());
+        tabla.offset_claves = offset;
+        offset = alinear64(offset + indices[t].claves.size() * 4);
+        tabla.offset_inicios = offset;
+        offset = alinear64(offset + indices[t].inicios.size() * 8);
+        tabla.offset_filas = offset;
+        offset = alinear64(offset + indices[t].filas.size() * 4);
+    }
+    cabecera.offset_ids = offset;
+    offset = alinear64(offset + num_filas * 4);
+    if (!columnas.posiciones.empty()) {
+        cabecera.offset_posiciones = offset;
+        offset = alinear64(offset + num_filas * 8);
+    }
+    cabecera.bytes_totales = offset;
+
+    std::ofstream salida(destino, std::ios::binary | std::ios::trunc);
+    if (!salida.is_open()) {
+        throw std::runtime_error("No se pudo crear el índice " + destino + ": " + std::strerror(errno));
+    }
+    std::vector<char> bloque_cabecera(BYTES_CABECERA_INDICE, 0);
+    std::memcpy(bloque_cabecera.data(), &cabecera, sizeof(cabecera));
+    salida.write(bloque_cabecera.data(), static_cast<std::streamsize>(bloque_cabecera.size()));
+    for (const IndiceOrdenado& indice : indices) {
+        escribirSeccion(salida, indice.claves.data(), indice.claves.size() * 4);
+        escribirSeccion(salida, indice.inicios.data(), indice.inicios.size() * 8);
+        escribirSeccion(salida, indice.filas.data(), indice.filas.size() * 4);
+    }
+    escribirSeccion(salida, columnas.ids.data(), num_filas * 4);
+    if (!columnas.posiciones.empty()) {
+        escribirSeccion(salida, columnas.posiciones.data(), num_filas * 8);
+    }
+    salida.close();
+    if (!salida) {
+        throw std::runtime_error("Error al escribir el índice " + destino);
+    }
+
+    ResultadoIndice resultado;
+    resultado.filas = num_filas;
+    resultado.validas = indices[static_cast<uint32_t>(ClaveIndice::COSTO)].filas.size();
+    for (uint32_t t = 0; t < NUM_CLAVES_INDICE; t++) {
+        resultado.claves[t] = static_cast<uint32_t>(indices[t].claves.size());
+    }
+    resultado.bytes = cabecera.bytes_totales;
+    return resultado;
+}
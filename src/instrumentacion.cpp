@@ -0,0 +1,307 @@
+#include "instrumentacion.hpp"
+#include <iomanip>
+
+#ifdef USAR_INSTRUMENTACION
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+const char* const NOMBRES_FASES[NUM_FASES_INSTRUMENTADAS] = {
+    "escenario", "resolver", "reconstruccion", "formato", "agregado", "escritura"};
+
+using Reloj = std::chrono::steady_clock;
+
+inline uint64_t leerTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Reloj::now().time_since_epoch()).count();
+#endif
+}
+
+// Contadores de hardware de un hilo: un grupo de perf_event que se lee con una
+// sola llamada a read()
+class ContadoresHardware {
+private:
+    int fds_[NUM_CONTADORES_HARDWARE];
+    bool activos_;
+
+public:
+    ContadoresHardware() : activos_(false) {
+        std::fill(fds_, fds_ + NUM_CONTADORES_HARDWARE, -1);
+    }
+
+    ~ContadoresHardware() {
+        for (int fd : fds_) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    // Abre el grupo para el hilo actual; false (y errno) si el kernel no lo permite
+    bool abrir() {
+        const uint64_t eventos[NUM_CONTADORES_HARDWARE] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < NUM_CONTADORES_HARDWARE; i++) {
+            perf_event_attr atributos;
+            std::memset(&atributos, 0, sizeof(atributos));
+            atributos.type = PERF_TYPE_HARDWARE;
+            atributos.size = sizeof(atributos);
+            atributos.config = eventos[i];
+            atributos.disabled = i == 0;
+            atributos.exclude_kernel = 1;
+            atributos.exclude_hv = 1;
+            atributos.read_format = PERF_FORMAT_GROUP;
+            fds_[i] = static_cast<int>(syscall(SYS_perf_event_open, &atributos, 0, -1, i == 0 ? -1 : fds_[0], 0));
+            if (fds_[i] < 0) {
+                return false;
+            }
+        }
+        ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        activos_ = true;
+        return true;
+    }
+
+    bool activos() const { return activos_; }
+
+    // Si read() falla (o lee de menos) los contadores quedan inactivos desde
+    // ahí y devuelve false, con errno del fallo
+    bool leer(uint64_t valores[NUM_CONTADORES_HARDWARE]) {
+        uint64_t grupo[1 + NUM_CONTADORES_HARDWARE];
+        ssize_t leidos = read(fds_[0], grupo, sizeof(grupo));
+        if (leidos != static_cast<ssize_t>(sizeof(grupo))) {
+            if (leidos >= 0) errno = EIO;
+            activos_ = false;
+            return false;
+        }
+        std::memcpy(valores, grupo + 1, sizeof(uint64_t) * NUM_CONTADORES_HARDWARE);
+        return true;
+    }
+};
+
+// Estado de medición de un hilo. Solo lo toca su hilo; al terminar, el hilo
+// suma sus totales a los de los hilos ya terminados
+struct EstadoHilo {
+    TotalesFase fases[NUM_FASES_INSTRUMENTADAS];
+    int fase_actual = -1;
+    uint64_t ultimos_ticks = 0;
+    uint64_t ultimos_contadores[NUM_CONTADORES_HARDWARE] = {};
+    ContadoresHardware hardware;
+};
+
+struct Registro {
+    std::mutex mutex;
+    std::vector<EstadoHilo*> vivos;
+    TotalesFase terminados[NUM_FASES_INSTRUMENTADAS];
+    // Referencia para convertir ticks en segundos
+    uint64_t ticks_inicio = leerTicks();
+    Reloj::time_point reloj_inicio = Reloj::now();
+    std::string motivo_sin_contadores;
+};
+
+Registro& registro() {
+    static Registro* global = new Registro();   // Vive hasta el final: los hilos lo usan al salir
+    return *global;
+}
+
+void sumar(TotalesFase& destino, const TotalesFase& origen) {
+    destino.llamadas += origen.llamadas;
+    destino.ticks += origen.ticks;
+    for (int c = 0; c < NUM_CONTADORES_HARDWARE; c++) {
+        destino.contadores[c] += origen.contadores[c];
+    }
+}
+
+// Registra el estado del hilo al crearlo y lo retira al terminar el hilo
+class EstadoHiloRegistrado {
+private:
+    std::unique_ptr<EstadoHilo> estado_;
+
+public:
+    EstadoHiloRegistrado() : estado_(std::make_unique<EstadoHilo>()) {
+        bool sin_contadores = std::getenv("MAQUINA_SIN_CONTADORES") != nullptr;
+        bool abiertos = !sin_contadores && estado_->hardware.abrir();
+        int error = errno;
+        Registro& r = registro();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (!abiertos && r.motivo_sin_contadores.empty()) {
+            r.motivo_sin_contadores = sin_contadores ? "desactivados con MAQUINA_SIN_CONTADORES"
+                                                     : std::string("perf_event_open: ") + std::strerror(error);
+        }
+        r.vivos.push_back(estado_.get());
+    }
+
+    ~EstadoHiloRegistrado() {
+        Registro& r = registro();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (int f = 0; f < NUM_FASES_INSTRUMENTADAS; f++) {
+            sumar(r.terminados[f], estado_->fases[f]);
+        }
+        r.vivos.erase(std::find(r.vivos.begin(), r.vivos.end(), estado_.get()));
+    }
+
+    EstadoHilo& estado() { return *estado_; }
+};
+
+EstadoHilo& estadoHilo() {
+    thread_local EstadoHiloRegistrado estado;
+    return estado.estado();
+}
+
+// Carga a la fase en curso lo transcurrido desde la última marca del hilo
+void marcar(EstadoHilo& hilo, bool contar_llamada) {
+    uint64_t contadores[NUM_CONTADORES_HARDWARE] = {};
+    bool abiertos = hilo.hardware.activos();
+    bool con_contadores = abiertos && hilo.hardware.leer(contadores);
+    if (abiertos && !con_contadores) {
+        // La lectura falló: el hilo sigue sin contadores, como si no se hubieran abierto
+        int error = errno;
+        Registro& r = registro();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (r.motivo_sin_contadores.empty()) {
+            r.motivo_sin_contadores = std::string("read: ") + std::strerror(error);
+        }
+    }
+    uint64_t ticks = leerTicks();
+    if (hilo.fase_actual >= 0) {
+        TotalesFase& fase = hilo.fases[hilo.fase_actual];
+        fase.ticks += ticks - hilo.ultimos_ticks;
+        fase.llamadas += contar_llamada;
+        if (con_contadores) {
+            for (int c = 0; c < NUM_CONTADORES_HARDWARE; c++) {
+                fase.contadores[c] += contadores[c] - hilo.ultimos_contadores[c];
+            }
+        }
+    }
+    hilo.ultimos_ticks = ticks;
+    if (con_contadores) {
+        std::memcpy(hilo.ultimos_contadores, contadores, sizeof(contadores));
+    }
+}
+}
+
+AlcanceFase::AlcanceFase(FaseInstrumentada fase) {
+    EstadoHilo& hilo = estadoHilo();
+    marcar(hilo, false);
+    fase_anterior_ = hilo.fase_actual;
+    hilo.fase_actual = static_cast<int>(fase);
+}
+
+AlcanceFase::~AlcanceFase() {
+    EstadoHilo& hilo = estadoHilo();
+    marcar(hilo, true);
+    hilo.fase_actual = fase_anterior_;
+}
+#endif
+
+std::vector<TotalesFase> totalesFases() {
+    std::vector<TotalesFase> totales(NUM_FASES_INSTRUMENTADAS);
+#ifdef USAR_INSTRUMENTACION
+    Registro& r = registro();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (int f = 0; f < NUM_FASES_INSTRUMENTADAS; f++) {
+        totales[f] = r.terminados[f];
+        for (const EstadoHilo* hilo : r.vivos) {
+            sumar(totales[f], hilo->fases[f]);
+        }
+    }
+#endif
+    return totales;
+}
+
+void reiniciarFases() {
+#ifdef USAR_INSTRUMENTACION
+    Registro& r = registro();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (int f = 0; f < NUM_FASES_INSTRUMENTADAS; f++) {
+        r.terminados[f] = TotalesFase();
+        for (EstadoHilo* hilo : r.vivos) {
+            hilo->fases[f] = TotalesFase();
+        }
+    }
+#endif
+}
+
+void escribirReporteFases(std::ostream& salida, uint64_t escenarios) {
+    escribirReporteFases(salida, totalesFases(), escenarios);
+}
+
+void escribirReporteFases(std::ostream& salida, const std::vector<TotalesFase>& totales, uint64_t escenarios) {
+#ifdef USAR_INSTRUMENTACION
+    // Frecuencia del TSC medida contra el reloj desde el primer uso; con menos
+    // de 10 ms de referencia se espera un poco para que no sea ruido
+    Registro& r = registro();
+    if (Reloj::now() - r.reloj_inicio < std::chrono::milliseconds(10)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    double ns_referencia = std::chrono::duration<double, std::nano>(Reloj::now() - r.reloj_inicio).count();
+    double ticks_por_ns = (leerTicks() - r.ticks_inicio) / ns_referencia;
+
+    TotalesFase total;
+    for (const TotalesFase& fase : totales) {
+        sumar(total, fase);
+    }
+    bool con_contadores = total.contadores[0] > 0;
+    double por_escenario = escenarios > 0 ? 1.0 / escenarios : 0.0;
+    double segundos_total = total.ticks / ticks_por_ns / 1e9;
+
+    std::ios::fmtflags formato = salida.flags();
+    salida << "\n=== FASES DEL BARRIDO (instrumentación) ===\n";
+    salida << "Escenarios: " << escenarios << " | TSC: " << std::fixed << std::setprecision(2)
+           << ticks_por_ns << " GHz | Contadores de hardware: ";
+    if (con_contadores) {
+        salida << "sí\n";
+    } else {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        salida << "no (" << (r.motivo_sin_contadores.empty() ? "sin datos" : r.motivo_sin_contadores) << ")\n";
+    }
+    salida << std::left << std::setw(16) << "Fase" << std::right << std::setw(12) << "Llamadas"
+           << std::setw(11) << "Segundos" << std::setw(14) << "ns/escenario" << std::setw(8) << "%";
+    if (con_contadores) {
+        salida << std::setw(12) << "Ciclos/esc" << std::setw(12) << "Instr/esc" << std::setw(7) << "IPC"
+               << std::setw(13) << "FallosCache" << std::setw(13) << "FallosSalto";
+    }
+    salida << "\n";
+
+    auto fila = [&](const char* nombre, const TotalesFase& fase) {
+        double segundos = fase.ticks / ticks_por_ns / 1e9;
+        salida << std::left << std::setw(16) << nombre << std::right << std::setw(12) << fase.llamadas
+               << std::setw(11) << std::setprecision(3) << segundos
+               << std::setw(14) << std::setprecision(1) << segundos * 1e9 * por_escenario
+               << std::setw(8) << (segundos_total > 0 ? segundos / segundos_total * 100.0 : 0.0);
+        if (con_contadores) {
+            const uint64_t* c = fase.contadores;
+            salida << std::setw(12) << c[0] * por_escenario << std::setw(12) << c[1] * por_escenario
+                   << std::setw(7) << std::setprecision(2) << (c[0] > 0 ? static_cast<double>(c[1]) / c[0] : 0.0)
+                   << std::setw(13) << std::setprecision(1) << c[2] * por_escenario
+                   << std::setw(13) << c[3] * por_escenario;
+        }
+        salida << "\n";
+    };
+    for (int f = 0; f < NUM_FASES_INSTRUMENTADAS; f++) {
+        fila(NOMBRES_FASES[f], totales[f]);
+    }
+    fila("total", total);
+    salida << "(Contadores por escenario; cada fase cuenta solo su tiempo propio, sin las fases anidadas)\n";
+    salida.flags(formato);
+#else
+    (void)salida;
+    (void)totales;
+    (void)escenarios;
+#endif
+}
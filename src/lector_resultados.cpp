@@ -0,0 +1,143 @@
+#include "lector_resultados.hpp"
+#include "formato_csv.hpp"
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+const std::string_view COLUMNAS_FIJAS = "CombinacionID,PatronEolica,CostoTotal,SolucionValida,HorasCriticas,";
+
+// Campo hasta la próxima coma; avanza `pos`
+bool siguienteCampo(std::string_view linea, size_t& pos, std::string_view& campo) {
+    size_t coma = linea.find(',', pos);
+    if (coma == std::string_view::npos) {
+        return false;
+    }
+    campo = linea.substr(pos, coma - pos);
+    pos = coma + 1;
+    return true;
+}
+
+template <typename T>
+bool leerNumero(std::string_view texto, T& valor) {
+    auto resultado = std::from_chars(texto.data(), texto.data() + texto.size(), valor);
+    return resultado.ec == std::errc() && resultado.ptr == texto.data() + texto.size();
+}
+}
+
+ColumnaTexto columnaTextoDeCabecera(std::string_view cabecera) {
+    if (!cabecera.empty() && cabecera.back() == '\r') {
+        cabecera.remove_suffix(1);
+    }
+    if (cabecera.substr(0, COLUMNAS_FIJAS.size()) == COLUMNAS_FIJAS) {
+        std::string_view ultima = cabecera.substr(COLUMNAS_FIJAS.size());
+        if (ultima == "Transiciones") return ColumnaTexto::TRANSICIONES;
+        if (ultima == "SecuenciaEstados") return ColumnaTexto::SECUENCIA_ESTADOS;
+    }
+    throw std::runtime_error("No es un CSV de resultados conocido (cabecera: " +
+                             std::string(cabecera.substr(0, 120)) + ")");
+}
+
+bool interpretarFilaResultado(std::string_view linea, ColumnaTexto columna, FilaResultado& fila) {
+    if (!linea.empty() && linea.back() == '\r') {
+        linea.remove_suffix(1);
+    }
+    std::string_view id, patron, costo, valida, horas;
+    size_t pos = 0;
+    if (!siguienteCampo(linea, pos, id) || !siguienteCampo(linea, pos, patron) ||
+        !siguienteCampo(linea, pos, costo) || !siguienteCampo(linea, pos, valida) ||
+        !siguienteCampo(linea, pos, horas)) {
+        return false;
+    }
+    fila.texto = linea.substr(pos);
+    if (!leerNumero(id, fila.combinacion_id) || !leerNumero(costo, fila.costo_total) ||
+        !leerNumero(horas, fila.horas_criticas) || (valida != "SI" && valida != "NO")) {
+        return false;
+    }
+    fila.solucion_valida = valida == "SI";
+    fila.mascara_encendido = 0;
+    if (!fila.solucion_valida) {
+        return true;
+    }
+    return columna == ColumnaTexto::TRANSICIONES ? mascaraDeTransiciones(fila.texto, fila.mascara_encendido)
+                                                 : mascaraDeSecuencia(fila.texto, fila.mascara_encendido);
+}
+
+bool mascaraDeTransiciones(std::string_view transiciones, uint32_t& mascara) {
+    // Horas de cambio alternando prender/apagar; un número impar de cambios
+    // deja la máquina prendida hasta la hora 23
+    mascara = 0;
+    if (transiciones.empty()) {
+        return true;
+    }
+    int horas[25];
+    int cantidad = 0;
+    size_t pos = 0;
+    while (pos <= transiciones.size()) {
+        size_t guion = transiciones.find('-', pos);
+        if (guion == std::string_view::npos) guion = transiciones.size();
+        int hora;
+        if (cantidad == 25 || !leerNumero(transiciones.substr(pos, guion - pos), hora) || hora < 0 || hora > 23 ||
+            (cantidad > 0 && hora <= horas[cantidad - 1])) {
+            return false;
+        }
+        horas[cantidad++] = hora;
+        pos = guion + 1;
+    }
+    for (int i = 0; i < cantidad; i += 2) {
+        int hasta = i + 1 < cantidad ? horas[i + 1] : 24;
+        for (int hora = horas[i]; hora < hasta; hora++) {
+            mascara |= 1u << hora;
+        }
+    }
+    return true;
+}
+
+bool mascaraDeSecuencia(std::string_view secuencia, uint32_t& mascara) {
+    mascara = 0;
+    int hora = 0;
+    size_t pos = 0;
+    while (pos < secuencia.size()) {
+        if (hora == 24) {
+            return false;
+        }
+        size_t guion = secuencia.find('-', pos);
+        if (guion == std::string_view::npos) guion = secuencia.size();
+        std::string_view estado = secuencia.substr(pos, guion - pos);
+        if (estado.substr(0, 3) == "ON_") {
+            mascara |= 1u << hora;
+        } else if (estado.substr(0, 4) != "OFF_") {
+            return false;
+        }
+        hora++;
+        pos = guion + 1;
+    }
+    return true;
+}
+
+uint32_t mascaraCanonica(uint32_t mascara) {
+    char cadena[128];
+    char* fin = escribirTransicionesCsv(cadena, mascara);
+    uint32_t canonica = 0;
+    mascaraDeTransiciones(std::string_view(cadena, static_cast<size_t>(fin - cadena)), canonica);
+    return canonica;
+}
+
+bool FiltroResultados::acepta(bool solucion_valida, double costo_total, int horas_criticas,
+                              uint32_t mascara_encendido) const {
+    if (!solucion_valida && (solo_validas || por_transiciones || filtraCosto())) {
+        return false;
+    }
+    if (horas_criticas < horas_min || horas_criticas > horas_max) {
+        return false;
+    }
+    if (solucion_valida && (costo_total < costo_min || costo_total > costo_max)) {
+        return false;
+    }
+    if (por_transiciones) {
+        // Se compara la forma canónica: la misma que escriben los demos
+        char cadena[128];
+        char* fin = escribirTransicionesCsv(cadena, mascara_encendido);
+        return std::string_view(cadena, static_cast<size_t>(fin - cadena)) == transiciones;
+    }
+    return true;
+}
@@ -0,0 +1,210 @@
+#define MAQUINA_COMPILANDO
+#include "maquina.h"
+#include "calculador_tabular.hpp"
+#include "cargador_escenarios.hpp"
+#include "pool_bloques.hpp"
+#include "resumen_agregado.hpp"
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Implementación de la API en C sobre CalculadorTabular. Ninguna excepción
+// cruza la frontera: cada llamada la convierte en un código y guarda el
+// mensaje para maquina_ultimo_error().
+
+static_assert(MAQUINA_K_EXTREMOS == ResumenAgregado::K_EXTREMOS, "Los extremos del resumen no coinciden");
+static_assert(MAQUINA_ON_CALIENTE == static_cast<int>(EstadoMaquina::ON_CALIENTE) &&
+              MAQUINA_OFF_FRIO == static_cast<int>(EstadoMaquina::OFF_FRIO), "Los estados de la API no coinciden");
+
+struct maquina_solver {
+    CalculadorTabular tabular;
+};
+
+namespace {
+constexpr uint32_t NUM_PATRONES = 1u << 24;
+
+thread_local std::string ultimo_error;
+
+int fallar(int codigo, const std::string& mensaje) {
+    ultimo_error = mensaje;
+    return codigo;
+}
+
+// Corre `cuerpo` y traduce sus excepciones a códigos de error
+template <typename Cuerpo>
+int protegido(Cuerpo cuerpo) {
+    try {
+        ultimo_error.clear();
+        return cuerpo();
+    } catch (const std::invalid_argument& e) {
+        return fallar(MAQUINA_ERROR_ARGUMENTO, e.what());
+    } catch (const std::bad_alloc&) {
+        return fallar(MAQUINA_ERROR_INTERNO, "memoria insuficiente");
+    } catch (const std::exception& e) {
+        return fallar(MAQUINA_ERROR_INTERNO, e.what());
+    } catch (...) {
+        return fallar(MAQUINA_ERROR_INTERNO, "excepción desconocida");
+    }
+}
+
+void validarRango(const maquina_solver* solver, uint32_t desde, uint32_t hasta) {
+    if (solver == nullptr) throw std::invalid_argument("solver nulo");
+    if (desde > hasta || hasta > NUM_PATRONES) {
+        throw std::invalid_argument("rango de patrones inválido (debe ser desde <= hasta <= 2^24)");
+    }
+}
+
+void resolverMascara(const CalculadorTabular& tabular, uint32_t mascara_criticas, maquina_resultado& resultado) {
+    EstadoMaquina estados[24];
+    resultado.costo_total = tabular.resolver(mascara_criticas, estados);
+    resultado.valida = resultado.costo_total != CalculadorTabular::INFINITO;
+    resultado.horas_criticas = __builtin_popcount(mascara_criticas);
+    resultado.mascara_criticas = mascara_criticas;
+    resultado.mascara_encendido = 0;
+    for (int hora = 0; hora < 24; hora++) {
+        resultado.estados[hora] = static_cast<uint8_t>(estados[hora]);
+        bool prendida = estados[hora] == EstadoMaquina::ON_CALIENTE || estados[hora] == EstadoMaquina::ON_TIBIO ||
+                        estados[hora] == EstadoMaquina::ON_FRIO;
+        if (resultado.valida && prendida) resultado.mascara_encendido |= 1u << hora;
+    }
+}
+
+maquina_extremo extremoDe(const PatronCosto& patron) {
+    return maquina_extremo{patron.costo, patron.combinacion_id, patron.mascara_encendido, patron.horas_criticas};
+}
+}
+
+extern "C" {
+
+int maquina_version_api(void) {
+    return MAQUINA_VERSION_API;
+}
+
+const char* maquina_ultimo_error(void) {
+    return ultimo_error.c_str();
+}
+
+maquina_solver* maquina_crear(const double* demanda, double potencia_eolica,
+                              double costo_frio, double costo_tibio, double costo_caliente) {
+    maquina_solver* solver = nullptr;
+    protegido([&] {
+        if (!(potencia_eolica >= 0.0) || !(costo_frio >= 0.0) || !(costo_tibio >= 0.0) || !(costo_caliente >= 0.0)) {
+            throw std::invalid_argument("la potencia eólica y los costos deben ser no negativos");
+        }
+        auto nuevo = std::make_unique<maquina_solver>();
+        if (demanda != nullptr) {
+            nuevo->tabular.configurarDemanda(std::vector<double>(demanda, demanda + 24), potencia_eolica);
+        } else {
+            nuevo->tabular.configurarDemanda(nuevo->tabular.getDemanda(), potencia_eolica);
+        }
+        nuevo->tabular.configurarCostos(costo_frio, costo_tibio, costo_caliente);
+        solver = nuevo.release();
+        return MAQUINA_OK;
+    });
+    return solver;
+}
+
+void maquina_destruir(maquina_solver* solver) {
+    delete solver;
+}
+
+int maquina_resolver_escenarios(const maquina_solver* solver, size_t n, const double* demanda,
+                                const double* otras_fuentes, maquina_resultado* resultados) {
+    return protegido([&] {
+        if (solver == nullptr || (n > 0 && (demanda == nullptr || otras_fuentes == nullptr || resultados == nullptr))) {
+            throw std::invalid_argument("puntero nulo");
+        }
+        for (size_t i = 0; i < n; i++) {
+            resolverMascara(solver->tabular, mascaraCriticas(demanda + 24 * i, otras_fuentes + 24 * i), resultados[i]);
+        }
+        return MAQUINA_OK;
+    });
+}
+
+int maquina_resolver_mascaras(const maquina_solver* solver, size_t n, const uint32_t* mascaras_criticas,
+                              maquina_resultado* resultados) {
+    return protegido([&] {
+        if (solver == nullptr || (n > 0 && (mascaras_criticas == nullptr || resultados == nullptr))) {
+            throw std::invalid_argument("puntero nulo");
+        }
+        for (size_t i = 0; i < n; i++) {
+            resolverMascara(solver->tabular, mascaras_criticas[i] & (NUM_PATRONES - 1), resultados[i]);
+        }
+        return MAQUINA_OK;
+    });
+}
+
+int maquina_resolver_patrones(const maquina_solver* solver, uint32_t desde, uint32_t hasta,
+                              maquina_resultado* resultados) {
+    return protegido([&] {
+        validarRango(solver, desde, hasta);
+        if (desde < hasta && resultados == nullptr) throw std::invalid_argument("puntero nulo");
+        for (uint32_t patron = desde; patron < hasta; patron++) {
+            resolverMascara(solver->tabular, solver->tabular.mascaraCriticas(patron), resultados[patron - desde]);
+        }
+        return MAQUINA_OK;
+    });
+}
+
+int maquina_recorrer_patrones(const maquina_solver* solver, uint32_t desde, uint32_t hasta,
+                              maquina_funcion_patron funcion, void* contexto) {
+    return protegido([&] {
+        validarRango(solver, desde, hasta);
+        if (funcion == nullptr) throw std::invalid_argument("callback nulo");
+        maquina_resultado resultado;
+        for (uint32_t patron = desde; patron < hasta; patron++) {
+            resolverMascara(solver->tabular, solver->tabular.mascaraCriticas(patron), resultado);
+            if (funcion(patron, &resultado, contexto) != 0) return static_cast<int>(MAQUINA_DETENIDO);
+        }
+        return static_cast<int>(MAQUINA_OK);
+    });
+}
+
+int maquina_agregar_patrones(const maquina_solver* solver, uint32_t desde, uint32_t hasta,
+                             unsigned num_hilos, maquina_resumen* resumen) {
+    return protegido([&] {
+        validarRango(solver, desde, hasta);
+        if (resumen == nullptr) throw std::invalid_argument("puntero nulo");
+
+        // Un resumen parcial por hilo, combinados al final como en los demos
+        PoolBloques pool(num_hilos, 4096);
+        std::vector<std::unique_ptr<ResumenAgregado>> parciales;
+        for (unsigned h = 0; h < pool.getNumHilos(); h++) {
+            parciales.push_back(std::make_unique<ResumenAgregado>());
+        }
+        pool.ejecutar(desde, hasta, [&](const PoolBloques::Bloque& bloque, unsigned hilo, std::string&) {
+            maquina_resultado resultado;
+            for (uint32_t patron = bloque.desde; patron < bloque.hasta; patron++) {
+                resolverMascara(solver->tabular, solver->tabular.mascaraCriticas(patron), resultado);
+                parciales[hilo]->registrar(patron, resultado.valida, resultado.costo_total,
+                                           resultado.horas_criticas, resultado.mascara_encendido);
+            }
+        }, [](const PoolBloques::Bloque&, std::string&) {});
+        ResumenAgregado& total = *parciales[0];
+        for (size_t h = 1; h < parciales.size(); h++) {
+            total.combinar(*parciales[h]);
+        }
+
+        *resumen = maquina_resumen{};
+        resumen->combinaciones = total.combinaciones;
+        resumen->validas = total.soluciones_validas;
+        if (total.num_baratos > 0) {
+            resumen->costo_minimo = total.baratos[0].costo;
+            resumen->costo_maximo = total.caros[0].costo;
+            resumen->costo_promedio = total.suma_centesimas / 100.0 / total.soluciones_validas;
+        }
+        for (int horas = 0; horas <= 24; horas++) {
+            resumen->por_horas_criticas[horas] = total.por_horas_criticas[horas];
+        }
+        resumen->num_baratos = total.num_baratos;
+        resumen->num_caros = total.num_caros;
+        for (uint32_t i = 0; i < total.num_baratos; i++) resumen->baratos[i] = extremoDe(total.baratos[i]);
+        for (uint32_t i = 0; i < total.num_caros; i++) resumen->caros[i] = extremoDe(total.caros[i]);
+        resumen->num_firmas = total.num_firmas;
+        return MAQUINA_OK;
+    });
+}
+
+}
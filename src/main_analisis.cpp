@@ -2,19 +2,92 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
 
-void mostrarMenu() {
+void mostrarMenu(unsigned num_hilos) {
     std::cout << "\n=== ANALIZADOR EXHAUSTIVO DE MÁQUINA DE ESTADOS ===\n";
     std::cout << "1. Ejecutar análisis completo (16,777,216 combinaciones)\n";
     std::cout << "2. Ejecutar análisis parcial (especificar rango)\n";
     std::cout << "3. Ejecutar prueba pequeña (primeras 1000 combinaciones)\n";
     std::cout << "4. Ejecutar prueba mediana (primeras 100,000 combinaciones)\n";
     std::cout << "5. Configurar parámetros y ejecutar\n";
+    std::cout << "6. Configurar número de hilos (actual: " << num_hilos << ")\n";
+    std::cout << "7. Reanudar análisis interrumpido\n";
     std::cout << "0. Salir\n";
     std::cout << "Selecciona una opción: ";
 }
 
-int main() {
+// Modo no interactivo para job arrays: analiza un tramo y lo escribe como shard.
+//   --shard i/N | --rango D H   tramo a procesar (i va de 0 a N-1)
+//   --hilos N                   hilos (0 = todos los núcleos)
+//   --salida archivo            nombre del shard
+//   --cubo archivo              escribir también el tramo como cubo binario
+//   --metricas archivo          progreso en formato de Prometheus, reescrito cada segundo
+//   --afinidad                  atar los hilos a CPUs por nodo NUMA y reportar cada nodo
+int ejecutarShard(AnalizadorExhaustivo& analizador, int argc, char* argv[]) {
+    uint32_t indice = 0, total_shards = 1;
+    uint32_t desde = 0, hasta = 0;
+    bool con_rango = false;
+    unsigned num_hilos = 1;
+    bool afinidad = false;
+    std::string archivo_res, archivo_cubo, archivo_metricas;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--shard" && i + 1 < argc) {
+                interpretarShard(argv[++i], indice, total_shards);
+            } else if (arg == "--rango" && i + 2 < argc) {
+                desde = std::stoul(argv[++i]);
+                hasta = std::stoul(argv[++i]);
+                con_rango = true;
+            } else if (arg == "--hilos" && i + 1 < argc) {
+                num_hilos = std::stoul(argv[++i]);
+            } else if (arg == "--salida" && i + 1 < argc) {
+                archivo_res = argv[++i];
+            } else if (arg == "--cubo" && i + 1 < argc) {
+                archivo_cubo = argv[++i];
+            } else if (arg == "--metricas" && i + 1 < argc) {
+                archivo_metricas = argv[++i];
+            } else if (arg == "--afinidad") {
+                afinidad = true;
+            } else {
+                throw std::invalid_argument("opción desconocida o incompleta: " + arg);
+            }
+        }
+        if (!con_rango) {
+            rangoDeShard(16777216, indice, total_shards, desde, hasta);
+        }
+        if (desde >= hasta || hasta > 16777216) {
+            throw std::invalid_argument("rango inválido");
+        }
+        
+        std::string sufijo = std::to_string(desde) + "_" + std::to_string(hasta);
+        if (archivo_res.empty()) {
+            archivo_res = "resultados_shard_" + sufijo + ".shard";
+        }
+        analizador.configurarHilos(num_hilos == 0 ? std::max(1u, std::thread::hardware_concurrency()) : num_hilos);
+        analizador.configurarAfinidad(afinidad);
+        analizador.configurarShard(indice, total_shards);
+        if (!archivo_cubo.empty()) {
+            analizador.configurarCubo(archivo_cubo);
+        }
+        if (!archivo_metricas.empty()) {
+            analizador.configurarMetricas(archivo_metricas);
+        }
+        analizador.configurarArchivos(archivo_res, "log_shard_" + sufijo + ".txt");
+        analizador.configurarReporte(std::max(1000u, (hasta - desde) / 100), true); // Guardar todos los resultados
+        analizador.ejecutarAnalisisParcial(desde, hasta);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    std::cout << "Shard guardado en: " << archivo_res << "\n";
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
     std::cout << "=== SISTEMA DE ANÁLISIS EXHAUSTIVO ===\n";
     std::cout << "Este programa analizará todas las combinaciones posibles de energía eólica\n";
     std::cout << "para encontrar patrones óptimos de operación de la máquina de estados.\n\n";
@@ -35,10 +108,16 @@ int main() {
     
     AnalizadorExhaustivo analizador;
     analizador.configurarDemanda(demanda_fija);
+    analizador.configurarCheckpoint(100000); // Punto de reanudación cada 100k combinaciones
+    unsigned num_hilos = 1;
+    
+    if (argc > 1) {
+        return ejecutarShard(analizador, argc, argv);
+    }
     
     int opcion;
     do {
-        mostrarMenu();
+        mostrarMenu(num_hilos);
         std::cin >> opcion;
         
         switch (opcion) {
@@ -49,9 +128,20 @@ int main() {
                 std::cin >> confirmar;
                 
                 if (confirmar == 's' || confirmar == 'S') {
+                    std::cout << "¿Guardar también todas las combinaciones en resultados_completos.cubo (~300 MB)? (s/N): ";
+                    char con_cubo;
+                    std::cin >> con_cubo;
+                    
                     analizador.configurarArchivos("resultados_completos.csv", "log_completo.txt");
                     analizador.configurarReporte(10000, false, 100.0); // Solo guardar costos <= 100
+                    if (con_cubo == 's' || con_cubo == 'S') {
+                        analizador.configurarCubo("resultados_completos.cubo"); // Todas las filas, en binario
+                    }
+                    analizador.configurarMetricas("metricas_completo.prom"); // Progreso para un scraper local
                     analizador.ejecutarAnalisisCompleto();
+                    // El analizador se reutiliza en las demás opciones: sin cubo ni métricas
+                    analizador.configurarCubo("");
+                    analizador.configurarMetricas("");
                 }
                 break;
             }
@@ -123,6 +213,34 @@ int main() {
                 break;
             }
             
+            case 6: {
+                unsigned nucleos = std::thread::hardware_concurrency();
+                std::cout << "\nNúcleos detectados: " << nucleos << "\n";
+                std::cout << "Número de hilos (1 = secuencial, 0 = todos los núcleos): ";
+                std::cin >> num_hilos;
+                if (num_hilos == 0) {
+                    num_hilos = std::max(1u, nucleos);
+                }
+                analizador.configurarHilos(num_hilos);
+                std::cout << "Usando " << num_hilos << " hilo(s). Los resultados son idénticos al modo secuencial.\n";
+                break;
+            }
+            
+            case 7: {
+                std::string archivo_res;
+                std::cout << "\nArchivo de resultados a reanudar (ej. resultados_completos.csv): ";
+                std::cin >> archivo_res;
+                
+                try {
+                    if (!analizador.reanudarAnalisis(archivo_res)) {
+                        std::cout << "No hay checkpoint para " << archivo_res << ".\n";
+                    }
+                } catch (const std::exception& e) {
+                    std::cout << "No se pudo reanudar: " << e.what() << "\n";
+                }
+                break;
+            }
+            
             case 0:
                 std::cout << "¡Análisis terminado!\n";
                 break;
@@ -142,6 +260,8 @@ int main() {
     std::cout << "- SolucionValida: SI/NO\n";
     std::cout << "- HorasCriticas: Número de horas que requieren generación\n";
     std::cout << "- SecuenciaEstados: Secuencia óptima de estados por hora\n\n";
+    std::cout << "Si se pide, el análisis completo guarda además todas las combinaciones en resultados_completos.cubo\n";
+    std::cout << "(formato binario indexado por patrón, ver include/cubo_resultados.hpp).\n\n";
     
     std::cout << "Los logs contienen información de progreso y estadísticas detalladas.\n\n";
     std::cout << "¡Gracias por usar el Analizador Exhaustivo!\n";
@@ -0,0 +1,243 @@
+#include "pool_bloques.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// Ventana por defecto: holgura para bloques de costo desparejo sin que las
+// salidas pendientes crezcan con el rango
+constexpr uint32_t BLOQUES_ADELANTADOS_POR_HILO = 8;
+}
+
+PoolBloques::PoolBloques(unsigned num_hilos, uint32_t tam_bloque) :
+    num_hilos_(num_hilos), tam_bloque_(tam_bloque) {
+    if (num_hilos_ == 0) {
+        num_hilos_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+    ventana_ = BLOQUES_ADELANTADOS_POR_HILO * num_hilos_;
+    if (tam_bloque_ == 0) {
+        throw std::invalid_argument("El tamaño de bloque debe ser mayor que cero");
+    }
+    for (unsigned i = 0; i < num_hilos_; i++) {
+        colas_.push_back(std::make_unique<ColaHilo>());
+    }
+    configurarDominios(std::vector<unsigned>(num_hilos_, 0), nullptr);
+}
+
+void PoolBloques::configurarVentana(uint32_t bloques) {
+    if (bloques == 0) {
+        throw std::invalid_argument("La ventana debe tener al menos un bloque");
+    }
+    ventana_ = bloques;
+}
+
+void PoolBloques::configurarDominios(const std::vector<unsigned>& dominio_de_hilo, FuncionInicio al_iniciar) {
+    if (dominio_de_hilo.size() != num_hilos_) {
+        throw std::invalid_argument("Se necesita un dominio por hilo del pool");
+    }
+    dominio_de_hilo_ = dominio_de_hilo;
+    al_iniciar_ = std::move(al_iniciar);
+
+    // Cada hilo recorre a los demás en el mismo orden rotado de siempre, pero
+    // primero los de su dominio: un bloque remoto solo se roba si no queda local
+    victimas_.assign(num_hilos_, {});
+    for (unsigned hilo = 0; hilo < num_hilos_; hilo++) {
+        std::vector<unsigned> remotas;
+        for (unsigned paso = 1; paso < num_hilos_; paso++) {
+            unsigned victima = (hilo + paso) % num_hilos_;
+            if (dominio_de_hilo_[victima] == dominio_de_hilo_[hilo]) {
+                victimas_[hilo].push_back(victima);
+            } else {
+                remotas.push_back(victima);
+            }
+        }
+        victimas_[hilo].insert(victimas_[hilo].end(), remotas.begin(), remotas.end());
+    }
+
+    unsigned num_dominios = *std::max_element(dominio_de_hilo_.begin(), dominio_de_hilo_.end()) + 1;
+    std::lock_guard<std::mutex> lock(mutex_estadisticas_);
+    estadisticas_.assign(num_dominios, EstadisticasDominio());
+    for (unsigned dominio : dominio_de_hilo_) {
+        estadisticas_[dominio].hilos++;
+    }
+}
+
+std::vector<PoolBloques::EstadisticasDominio> PoolBloques::estadisticasDominios() const {
+    std::lock_guard<std::mutex> lock(mutex_estadisticas_);
+    return estadisticas_;
+}
+
+PoolBloques::ResultadoToma PoolBloques::tomarBloque(unsigned hilo, uint64_t limite, uint32_t& indice,
+                                                   unsigned& origen) {
+    bool quedan = false;
+
+    // Primero la cola propia, por el frente (IDs más bajos)
+    {
+        ColaHilo& propia = *colas_[hilo];
+        std::lock_guard<std::mutex> lock(propia.mutex);
+        if (!propia.bloques.empty()) {
+            if (propia.bloques.front() < limite) {
+                indice = propia.bloques.front();
+                propia.bloques.pop_front();
+                origen = hilo;
+                return ResultadoToma::TOMADO;
+            }
+            quedan = true;
+        }
+    }
+
+    // Robar del final de las colas ajenas, primero las del mismo dominio; si el
+    // final cae fuera de la ventana se roba el frente, que es el más urgente
+    for (unsigned otro : victimas_[hilo]) {
+        ColaHilo& victima = *colas_[otro];
+        std::lock_guard<std::mutex> lock(victima.mutex);
+        if (victima.bloques.empty()) {
+            continue;
+        }
+        quedan = true;
+        if (victima.bloques.back() < limite) {
+            indice = victima.bloques.back();
+            victima.bloques.pop_back();
+        } else if (victima.bloques.front() < limite) {
+            indice = victima.bloques.front();
+            victima.bloques.pop_front();
+        } else {
+            continue;
+        }
+        origen = otro;
+        return ResultadoToma::TOMADO;
+    }
+    return quedan ? ResultadoToma::FUERA_DE_VENTANA : ResultadoToma::AGOTADO;
+}
+
+void PoolBloques::ejecutar(uint32_t desde, uint32_t hasta, const FuncionProceso& procesar, const FuncionEmision& emitir) {
+    if (hasta <= desde) {
+        return;
+    }
+
+    uint32_t total = hasta - desde;
+    uint32_t num_bloques = (total + tam_bloque_ - 1) / tam_bloque_;
+
+    auto bloque = [&](uint32_t indice) {
+        uint32_t inicio = desde + indice * tam_bloque_;
+        return Bloque{indice, inicio, std::min(hasta, inicio + tam_bloque_)};
+    };
+
+    // Reparto cíclico: los hilos avanzan juntos y la emisión en orden casi no espera
+    for (uint32_t i = 0; i < num_bloques; i++) {
+        colas_[i % num_hilos_]->bloques.push_back(i);
+    }
+
+    std::vector<std::string> salidas(num_bloques);
+    std::vector<char> listos(num_bloques, 0);
+    uint32_t siguiente_emision = 0;       // Protegido por mutex_listos
+    std::mutex mutex_listos;
+    std::condition_variable cv_listos;
+    std::atomic<bool> cancelado(false);
+    std::exception_ptr error;
+
+    auto trabajador = [&](unsigned hilo) {
+        // El buffer de salida de un bloque lo reserva el hilo que lo procesa, así
+        // con hilos atados sus páginas quedan en la memoria de ese dominio
+        EstadisticasDominio propias;
+        try {
+            if (al_iniciar_) {
+                al_iniciar_(hilo);
+            }
+            uint32_t indice;
+            unsigned origen;
+            while (!cancelado.load(std::memory_order_relaxed)) {
+                uint32_t base;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_listos);
+                    base = siguiente_emision;
+                }
+                ResultadoToma toma = tomarBloque(hilo, uint64_t(base) + ventana_, indice, origen);
+                if (toma == ResultadoToma::AGOTADO) {
+                    break;
+                }
+                if (toma == ResultadoToma::FUERA_DE_VENTANA) {
+                    // Esperar a que la emisión avance
+                    std::unique_lock<std::mutex> lock(mutex_listos);
+                    cv_listos.wait(lock, [&] { return siguiente_emision != base || cancelado.load(); });
+                    continue;
+                }
+
+                Bloque actual = bloque(indice);
+                auto inicio = std::chrono::steady_clock::now();
+                procesar(actual, hilo, salidas[indice]);
+                propias.segundos += std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+                propias.bloques++;
+                propias.combinaciones += actual.hasta - actual.desde;
+                if (origen != hilo) {
+                    (dominio_de_hilo_[origen] == dominio_de_hilo_[hilo] ? propias.robos_locales : propias.robos_remotos)++;
+                }
+
+                std::lock_guard<std::mutex> lock(mutex_listos);
+                listos[indice] = 1;
+                cv_listos.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_listos);
+            if (!error) error = std::current_exception();
+            cancelado = true;
+            cv_listos.notify_all();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_estadisticas_);
+        EstadisticasDominio& dominio = estadisticas_[dominio_de_hilo_[hilo]];
+        dominio.bloques += propias.bloques;
+        dominio.combinaciones += propias.combinaciones;
+        dominio.robos_locales += propias.robos_locales;
+        dominio.robos_remotos += propias.robos_remotos;
+        dominio.segundos += propias.segundos;
+    };
+
+    std::vector<std::thread> hilos;
+    for (unsigned h = 0; h < num_hilos_; h++) {
+        hilos.emplace_back(trabajador, h);
+    }
+
+    // Emisión ordenada desde el hilo llamador
+    for (uint32_t i = 0; i < num_bloques; i++) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_listos);
+            cv_listos.wait(lock, [&] { return listos[i] || cancelado.load(); });
+            if (!listos[i]) break;
+        }
+        try {
+            emitir(bloque(i), salidas[i]);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_listos);
+            if (!error) error = std::current_exception();
+            cancelado = true;
+            break;
+        }
+        std::string().swap(salidas[i]);   // Liberar el buffer ya escrito
+        {
+            std::lock_guard<std::mutex> lock(mutex_listos);
+            siguiente_emision = i + 1;
+        }
+        cv_listos.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_listos);
+        cancelado = true;
+    }
+    cv_listos.notify_all();
+    for (std::thread& hilo : hilos) {
+        hilo.join();
+    }
+    for (auto& cola : colas_) {
+        cola->bloques.clear();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
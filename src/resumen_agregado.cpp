@@ -0,0 +1,319 @@
+#include "resumen_agregado.hpp"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+namespace {
+bool vaAntes(const PatronCosto& a, const PatronCosto& b, bool caros) {
+    if (a.costo != b.costo) {
+        return caros ? a.costo > b.costo : a.costo < b.costo;
+    }
+    return a.combinacion_id < b.combinacion_id;
+}
+
+void imprimirExtremos(std::ostream& salida, const char* titulo, const PatronCosto* lista, uint32_t cantidad) {
+    salida << "\n" << titulo << "\n";
+    salida << std::setw(5) << "#" << std::setw(12) << "ID" << std::setw(27) << "Patrón" << std::setw(10) << "Costo"
+           << std::setw(11) << "Críticas" << std::setw(10) << "Eólica" << "  Transiciones\n";
+    for (uint32_t i = 0; i < cantidad; i++) {
+        std::bitset<24> patron(lista[i].combinacion_id);
+        std::string transiciones = ResumenAgregado::transicionesDeMascara(lista[i].mascara_encendido);
+        salida << std::setw(5) << (i + 1)
+               << std::setw(12) << lista[i].combinacion_id
+               << std::setw(26) << patron
+               << std::setw(10) << std::fixed << std::setprecision(2) << lista[i].costo
+               << std::setw(10) << lista[i].horas_criticas
+               << std::setw(9) << patron.count()
+               << "  " << (transiciones.empty() ? "nunca prendido" : transiciones) << "\n";
+    }
+}
+}
+
+void ResumenAgregado::reiniciar() {
+    combinaciones = 0;
+    soluciones_validas = 0;
+    suma_centesimas = 0;
+    costos_fuera_de_rango = 0;
+    std::fill(std::begin(histograma), std::end(histograma), 0);
+    std::fill(std::begin(por_horas_criticas), std::end(por_horas_criticas), 0);
+    num_baratos = 0;
+    num_caros = 0;
+    std::fill(std::begin(baratos), std::end(baratos), PatronCosto{});
+    std::fill(std::begin(caros), std::end(caros), PatronCosto{});
+    for (EntradaFirma& entrada : firmas) {
+        entrada.mascara_encendido = FIRMA_VACIA;
+        entrada.relleno = 0;
+        entrada.cuenta = 0;
+    }
+    num_firmas = 0;
+    prioridad_maxima = 0;
+    firmas_descartadas = 0;
+}
+
+void ResumenAgregado::insertarExtremo(PatronCosto* lista, uint32_t& cantidad, PatronCosto patron, bool caros) {
+    uint32_t pos = cantidad;
+    while (pos > 0 && vaAntes(patron, lista[pos - 1], caros)) {
+        pos--;
+    }
+    if (pos >= static_cast<uint32_t>(K_EXTREMOS)) {
+        return;
+    }
+    uint32_t ultimo = std::min<uint32_t>(cantidad, K_EXTREMOS - 1);
+    for (uint32_t i = ultimo; i > pos; i--) {
+        lista[i] = lista[i - 1];
+    }
+    lista[pos] = patron;
+    cantidad = std::min<uint32_t>(cantidad + 1, K_EXTREMOS);
+}
+
+uint32_t ResumenAgregado::prioridadFirma(uint32_t mascara_encendido) {
+    // Mezcla de bits invertible: cada paso (xor con desplazamiento,
+    // producto por impar) es biyectivo en 32 bits
+    uint32_t x = mascara_encendido;
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+uint32_t ResumenAgregado::posicionFirma(uint32_t mascara_encendido) {
+    // Hash multiplicativo: los bits altos del producto mezclan toda la máscara
+    return (mascara_encendido * 2654435761u) >> (32 - BITS_FIRMAS);
+}
+
+void ResumenAgregado::agregarFirma(uint32_t mascara_encendido, uint64_t cuenta) {
+    // Sondeo lineal; con carga máxima de 3/4 siempre hay un hueco
+    uint32_t pos = posicionFirma(mascara_encendido);
+    while (firmas[pos].mascara_encendido != FIRMA_VACIA) {
+        if (firmas[pos].mascara_encendido == mascara_encendido) {
+            firmas[pos].cuenta += cuenta;
+            return;
+        }
+        pos = (pos + 1) & (CAPACIDAD_FIRMAS - 1);
+    }
+
+    // Máscara nueva con la tabla llena: sale la de mayor prioridad, que
+    // tampoco estaría en el resultado de un barrido completo
+    uint32_t prioridad = prioridadFirma(mascara_encendido);
+    if (num_firmas == MAX_FIRMAS) {
+        if (prioridad > prioridad_maxima) {
+            firmas_descartadas += cuenta;
+            return;
+        }
+        quitarFirmaMaxima();
+        pos = posicionFirma(mascara_encendido);
+        while (firmas[pos].mascara_encendido != FIRMA_VACIA) {
+            pos = (pos + 1) & (CAPACIDAD_FIRMAS - 1);
+        }
+    }
+
+    firmas[pos].mascara_encendido = mascara_encendido;
+    firmas[pos].cuenta = cuenta;
+    if (num_firmas == 0 || prioridad > prioridad_maxima) {
+        prioridad_maxima = prioridad;
+    }
+    num_firmas++;
+}
+
+void ResumenAgregado::quitarFirmaMaxima() {
+    uint32_t hueco = 0;
+    while (firmas[hueco].mascara_encendido == FIRMA_VACIA ||
+           prioridadFirma(firmas[hueco].mascara_encendido) != prioridad_maxima) {
+        hueco++;
+    }
+    firmas_descartadas += firmas[hueco].cuenta;
+    num_firmas--;
+
+    // Borrado con corrimiento hacia atrás: se adelanta cada entrada siguiente
+    // cuya posición ideal no cae entre el hueco y ella
+    uint32_t pos = hueco;
+    while (true) {
+        pos = (pos + 1) & (CAPACIDAD_FIRMAS - 1);
+        if (firmas[pos].mascara_encendido == FIRMA_VACIA) {
+            break;
+        }
+        uint32_t ideal = posicionFirma(firmas[pos].mascara_encendido);
+        if (((pos - ideal) & (CAPACIDAD_FIRMAS - 1)) >= ((pos - hueco) & (CAPACIDAD_FIRMAS - 1))) {
+            firmas[hueco] = firmas[pos];
+            hueco = pos;
+        }
+    }
+    firmas[hueco].mascara_encendido = FIRMA_VACIA;
+    firmas[hueco].cuenta = 0;
+
+    prioridad_maxima = 0;
+    for (const EntradaFirma& entrada : firmas) {
+        if (entrada.mascara_encendido != FIRMA_VACIA) {
+            prioridad_maxima = std::max(prioridad_maxima, prioridadFirma(entrada.mascara_encendido));
+        }
+    }
+}
+
+void ResumenAgregado::registrar(uint32_t combinacion_id, bool solucion_valida, double costo_total,
+                                int horas_criticas, uint32_t mascara_encendido) {
+    combinaciones++;
+    if (horas_criticas >= 0 && horas_criticas <= 24) {
+        por_horas_criticas[horas_criticas]++;
+    }
+    if (!solucion_valida) {
+        return;
+    }
+
+    soluciones_validas++;
+    uint64_t centesimas = static_cast<uint64_t>(std::llround(costo_total * 100.0));
+    suma_centesimas += centesimas;
+    if (centesimas <= MAX_CENTESIMAS) {
+        histograma[centesimas]++;
+    } else {
+        costos_fuera_de_rango++;
+    }
+
+    PatronCosto patron{costo_total, combinacion_id, mascara_encendido, horas_criticas};
+    insertarExtremo(baratos, num_baratos, patron, false);
+    insertarExtremo(caros, num_caros, patron, true);
+    agregarFirma(mascara_encendido, 1);
+}
+
+void ResumenAgregado::combinar(const ResumenAgregado& otro) {
+    combinaciones += otro.combinaciones;
+    soluciones_validas += otro.soluciones_validas;
+    suma_centesimas += otro.suma_centesimas;
+    costos_fuera_de_rango += otro.costos_fuera_de_rango;
+    for (uint32_t i = 0; i <= MAX_CENTESIMAS; i++) {
+        histograma[i] += otro.histograma[i];
+    }
+    for (int i = 0; i <= 24; i++) {
+        por_horas_criticas[i] += otro.por_horas_criticas[i];
+    }
+    for (uint32_t i = 0; i < otro.num_baratos; i++) {
+        insertarExtremo(baratos, num_baratos, otro.baratos[i], false);
+    }
+    for (uint32_t i = 0; i < otro.num_caros; i++) {
+        insertarExtremo(caros, num_caros, otro.caros[i], true);
+    }
+    for (const EntradaFirma& entrada : otro.firmas) {
+        if (entrada.mascara_encendido != FIRMA_VACIA) {
+            agregarFirma(entrada.mascara_encendido, entrada.cuenta);
+        }
+    }
+    firmas_descartadas += otro.firmas_descartadas;
+}
+
+uint32_t ResumenAgregado::mascaraEncendido(const std::vector<EstadoMaquina>& estados) {
+    return mascaraEncendido(estados.data(), estados.size());
+}
+
+uint32_t ResumenAgregado::mascaraEncendido(const EstadoMaquina* estados, size_t num_horas) {
+    uint32_t mascara = 0;
+    for (size_t hora = 0; hora < num_horas && hora < 24; hora++) {
+        EstadoMaquina estado = estados[hora];
+        if (estado == EstadoMaquina::ON_CALIENTE || estado == EstadoMaquina::ON_TIBIO ||
+            estado == EstadoMaquina::ON_FRIO) {
+            mascara |= 1u << hora;
+        }
+    }
+    return mascara;
+}
+
+std::string ResumenAgregado::transicionesDeMascara(uint32_t mascara_encendido) {
+    std::vector<int> transiciones;
+    bool anterior = false;
+    for (int hora = 0; hora < 24; hora++) {
+        bool actual = (mascara_encendido >> hora) & 1u;
+        if ((hora == 0 && actual) || (hora > 0 && actual != anterior)) {
+            transiciones.push_back(hora);
+        }
+        anterior = actual;
+    }
+    // Si termina prendido se cierra en la hora 23
+    if (anterior && !transiciones.empty() && transiciones.back() != 23) {
+        transiciones.push_back(23);
+    }
+
+    std::stringstream ss;
+    for (size_t i = 0; i < transiciones.size(); i++) {
+        if (i > 0) ss << "-";
+        ss << transiciones[i];
+    }
+    return ss.str();
+}
+
+void ResumenAgregado::imprimirReporte(std::ostream& salida, size_t max_firmas) const {
+    uint64_t invalidas = combinaciones - soluciones_validas;
+
+    salida << "=== RESUMEN AGREGADO ===\n";
+    salida << "Combinaciones: " << combinaciones << "\n";
+    salida << "Soluciones válidas: " << soluciones_validas << "\n";
+    salida << "Soluciones inválidas: " << invalidas << "\n";
+    if (soluciones_validas > 0) {
+        salida << "Costo mínimo: " << std::fixed << std::setprecision(2) << baratos[0].costo << "\n";
+        salida << "Costo máximo: " << caros[0].costo << "\n";
+        salida << "Costo promedio: " << std::setprecision(4)
+               << suma_centesimas / 100.0 / soluciones_validas << "\n";
+    }
+
+    salida << "\n--- Histograma de costos ---\n";
+    for (uint32_t i = 0; i <= MAX_CENTESIMAS; i++) {
+        if (histograma[i] == 0) continue;
+        salida << std::setw(10) << std::fixed << std::setprecision(2) << i / 100.0
+               << std::setw(12) << histograma[i]
+               << std::setw(9) << std::setprecision(3) << 100.0 * histograma[i] / soluciones_validas << "%\n";
+    }
+    if (costos_fuera_de_rango > 0) {
+        salida << "  > " << MAX_CENTESIMAS / 100.0 << ": " << costos_fuera_de_rango << "\n";
+    }
+
+    imprimirExtremos(salida, "--- Patrones más baratos ---", baratos, num_baratos);
+    imprimirExtremos(salida, "--- Patrones más caros ---", caros, num_caros);
+
+    salida << "\n--- Combinaciones por horas críticas ---\n";
+    for (int i = 0; i <= 24; i++) {
+        if (por_horas_criticas[i] == 0) continue;
+        salida << std::setw(4) << i << std::setw(12) << por_horas_criticas[i]
+               << std::setw(9) << std::setprecision(1) << 100.0 * por_horas_criticas[i] / combinaciones << "%\n";
+    }
+
+    // Máscaras distintas pueden dar la misma cadena (p. ej. prendida 0-22 o 0-23)
+    std::map<std::string, uint64_t> por_cadena;
+    for (const EntradaFirma& entrada : firmas) {
+        if (entrada.mascara_encendido != FIRMA_VACIA) {
+            por_cadena[transicionesDeMascara(entrada.mascara_encendido)] += entrada.cuenta;
+        }
+    }
+    std::vector<std::pair<std::string, uint64_t>> orden(por_cadena.begin(), por_cadena.end());
+    std::stable_sort(orden.begin(), orden.end(),
+                     [](const std::pair<std::string, uint64_t>& a, const std::pair<std::string, uint64_t>& b) {
+                         return a.second > b.second;
+                     });
+
+    // Clasificación de las soluciones válidas según si la máquina se prende
+    uint64_t nunca = 0, siempre = 0, con_transiciones = 0;
+    for (const auto& entrada : orden) {
+        if (entrada.first.empty()) nunca += entrada.second;
+        else if (entrada.first == "0-23") siempre += entrada.second;
+        else con_transiciones += entrada.second;
+    }
+    auto porcentaje = [&](uint64_t cuenta) { return combinaciones > 0 ? 100.0 * cuenta / combinaciones : 0.0; };
+    salida << "\n--- Transiciones ---\n";
+    salida << "Nunca prendido: " << nunca << " (" << std::setprecision(1) << porcentaje(nunca) << "%)\n";
+    salida << "Siempre prendido (0-23): " << siempre << " (" << porcentaje(siempre) << "%)\n";
+    salida << "Con transiciones: " << con_transiciones << " (" << porcentaje(con_transiciones) << "%)\n";
+
+    salida << "\n--- Firmas de transiciones (" << orden.size() << " distintas) ---\n";
+    for (size_t i = 0; i < orden.size() && i < max_firmas; i++) {
+        salida << std::setw(12) << orden[i].second << "  "
+               << (orden[i].first.empty() ? "(nunca se prende)" : orden[i].first) << "\n";
+    }
+    if (orden.size() > max_firmas) {
+        salida << "  ... y " << orden.size() - max_firmas << " firmas más\n";
+    }
+    if (firmas_descartadas > 0) {
+        salida << "Soluciones sin firma registrada (tabla de " << MAX_FIRMAS
+               << " firmas llena; se guardan las de menor prioridad): " << firmas_descartadas << "\n";
+    }
+}
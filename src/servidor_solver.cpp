@@ -0,0 +1,662 @@
+#include "calculador_tabular.hpp"
+#include "cargador_escenarios.hpp"
+#include "formato_csv.hpp"
+#include "protocolo_solver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <thread>
+#include <vector>
+
+// Servidor del solver: un proceso que queda abierto con CalculadorTabular y
+// una caché de soluciones listos, para no pagar el arranque de
+// maquina_estados o analizador_individual en cada consulta. Atiende el
+// protocolo de protocolo_solver.hpp por un socket Unix (varios clientes a la
+// vez) o por stdin/stdout.
+//
+// Un hilo de E/S lee las consultas y las encola; un hilo de lotes junta las
+// que llegan juntas (hasta --lote, o las que haya cuando la más vieja cumple
+// --plazo-us), las resuelve y deja las respuestas de cada cliente en su buffer
+// de salida, que el hilo de E/S envía sin bloquear cuando el socket lo acepta.
+//
+// La cola tiene un tope (--cola): mientras está llena no se leen más
+// consultas, y de cada cliente se lee de nuevo solo cuando ya no le quedan
+// consultas en la cola, así la memoria no crece con la carga.
+//
+// Uso: servidor_solver [--socket ruta | --stdin] [--lote N] [--plazo-us N] [--cache N] [--cola N]
+
+namespace {
+using Reloj = std::chrono::steady_clock;
+
+const std::vector<double> DEMANDA_FIJA = {
+    300, 200, 100, 100, 100, 200, 300, 500, 800, 1000, 1000, 1000,
+    1000, 900, 800, 800, 800, 1000, 1000, 1000, 600, 600, 400, 300
+};
+
+// Con más de LIMITE_SALIDA bytes por enviar no se leen más consultas del
+// cliente; si aun así llega a MAX_SALIDA (no lee sus respuestas), se lo desconecta
+constexpr size_t LIMITE_SALIDA = 1u << 20;
+constexpr size_t MAX_SALIDA = 8u << 20;
+
+std::atomic<bool> terminar(false);
+
+void alTerminar(int) {
+    terminar = true;
+}
+
+struct Opciones {
+    std::string ruta_socket;
+    bool usar_stdin;
+    size_t tam_lote;
+    std::chrono::microseconds plazo;
+    size_t entradas_cache;
+    size_t capacidad_cola;
+
+    Opciones() : ruta_socket(RUTA_SOCKET_SOLVER), usar_stdin(false), tam_lote(64), plazo(100),
+                 entradas_cache(1u << 16), capacidad_cola(1u << 14) {}
+};
+
+// Un cliente. En modo socket el hilo de lotes deja las respuestas en `salida`
+// y el hilo de E/S las envía sin bloquear, así un cliente que no lee no frena a
+// los demás; con stdin/stdout el hilo de lotes escribe directamente. El
+// descriptor se cierra al soltar la última referencia (la conexión o sus
+// consultas en la cola).
+struct Conexion {
+    int fd_entrada;
+    int fd_salida;
+    bool propia;                  // false para stdin/stdout
+    bool entrada_cerrada;         // El cliente terminó de enviar (solo hilo de E/S)
+    std::string pendiente;        // Bytes leídos sin '\n' todavía (solo hilo de E/S)
+    std::atomic<bool> rota;       // Error al escribir o salida por encima de MAX_SALIDA
+    std::atomic<size_t> en_cola;  // Consultas suyas todavía sin respuesta
+    std::mutex mutex_salida;
+    std::string salida;           // Respuestas por enviar (modo socket)
+
+    Conexion(int entrada, int salida_, bool propia_) :
+        fd_entrada(entrada), fd_salida(salida_), propia(propia_), entrada_cerrada(false), rota(false), en_cola(0) {}
+    ~Conexion() {
+        if (propia) close(fd_entrada);
+    }
+    Conexion(const Conexion&) = delete;
+    Conexion& operator=(const Conexion&) = delete;
+};
+
+enum class TipoSolicitud { RESOLVER, ESTADISTICAS, ERROR };
+
+struct Solicitud {
+    std::shared_ptr<Conexion> conexion;
+    TipoSolicitud tipo;
+    uint32_t mascara_criticas;
+    std::string error;
+    Reloj::time_point llegada;
+};
+
+// Caché de soluciones por máscara de horas críticas, de asignación directa:
+// una máscara solo puede estar en una posición y la última la reemplaza
+class CacheSoluciones {
+private:
+    struct Entrada {
+        uint32_t clave;           // Máscara | OCUPADA
+        double costo;
+        uint8_t estados[24];
+    };
+    static constexpr uint32_t OCUPADA = 1u << 31;
+
+    std::vector<Entrada> entradas_;
+    unsigned bits_;               // log2 del tamaño
+    uint64_t consultas_;
+    uint64_t aciertos_;
+
+    // Hash de Fibonacci: los bits altos del producto dependen de todas las
+    // horas; los bajos solo de las horas bajas
+    Entrada& posicion(uint32_t mascara) {
+        return entradas_[bits_ == 0 ? 0 : static_cast<uint32_t>(mascara * 2654435761u) >> (32 - bits_)];
+    }
+
+public:
+    // `entradas` se redondea a potencia de 2 (a lo sumo 2^31)
+    explicit CacheSoluciones(size_t entradas) : bits_(0), consultas_(0), aciertos_(0) {
+        while ((size_t{1} << bits_) < entradas && bits_ < 31) bits_++;
+        entradas_.assign(size_t{1} << bits_, Entrada{0, 0.0, {}});
+    }
+
+    double resolver(const CalculadorTabular& tabular, uint32_t mascara, EstadoMaquina estados[24]) {
+        consultas_++;
+        Entrada& entrada = posicion(mascara);
+        if (entrada.clave == (mascara | OCUPADA)) {
+            aciertos_++;
+            for (int hora = 0; hora < 24; hora++) estados[hora] = static_cast<EstadoMaquina>(entrada.estados[hora]);
+            return entrada.costo;
+        }
+        entrada.clave = mascara | OCUPADA;
+        entrada.costo = tabular.resolver(mascara, estados);
+        for (int hora = 0; hora < 24; hora++) entrada.estados[hora] = static_cast<uint8_t>(estados[hora]);
+        return entrada.costo;
+    }
+
+    uint64_t consultas() const { return consultas_; }
+    uint64_t aciertos() const { return aciertos_; }
+};
+
+// Latencias de las últimas consultas (llegada a respuesta lista), para los percentiles
+class Latencias {
+private:
+    static constexpr size_t MUESTRAS = 1u << 16;
+    std::vector<double> muestras_;
+    size_t siguiente_;
+    uint64_t total_;
+    double maxima_;
+
+public:
+    Latencias() : siguiente_(0), total_(0), maxima_(0.0) { muestras_.reserve(MUESTRAS); }
+
+    void registrar(double microsegundos) {
+        if (muestras_.size() < MUESTRAS) {
+            muestras_.push_back(microsegundos);
+        } else {
+            muestras_[siguiente_] = microsegundos;
+            siguiente_ = (siguiente_ + 1) % MUESTRAS;
+        }
+        total_++;
+        maxima_ = std::max(maxima_, microsegundos);
+    }
+
+    double percentil(double p) const {
+        if (muestras_.empty()) return 0.0;
+        std::vector<double> copia = muestras_;
+        size_t k = std::min(copia.size() - 1, static_cast<size_t>(p / 100.0 * copia.size()));
+        std::nth_element(copia.begin(), copia.begin() + k, copia.end());
+        return copia[k];
+    }
+
+    uint64_t total() const { return total_; }
+    double maxima() const { return maxima_; }
+};
+
+// Cola entre el hilo de E/S y el de lotes. El tope no se impone en agregar():
+// el hilo de E/S deja de leer mientras llena() es verdadero, así que la cola lo
+// supera a lo sumo en lo que trae una lectura
+class ColaLotes {
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable hay_solicitudes_;
+    std::condition_variable hay_espacio_;
+    std::deque<Solicitud> cola_;
+    bool cerrada_;
+    size_t tam_lote_;
+    std::chrono::microseconds plazo_;
+    size_t capacidad_;
+
+public:
+    ColaLotes(size_t tam_lote, std::chrono::microseconds plazo, size_t capacidad) :
+        cerrada_(false), tam_lote_(tam_lote), plazo_(plazo), capacidad_(capacidad) {}
+
+    bool llena() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cola_.size() >= capacidad_;
+    }
+
+    // Bloquea hasta que haya lugar (modo stdin, donde no hay nada más que atender)
+    void esperarEspacio() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        hay_espacio_.wait(lock, [this] { return cola_.size() < capacidad_ || cerrada_; });
+    }
+
+    void agregar(std::vector<Solicitud>& nuevas) {
+        if (nuevas.empty()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (Solicitud& solicitud : nuevas) cola_.push_back(std::move(solicitud));
+        }
+        nuevas.clear();
+        hay_solicitudes_.notify_one();
+    }
+
+    // Espera hasta tener un lote lleno o hasta que la consulta más vieja cumpla
+    // el plazo; false si la cola se cerró y no queda nada
+    bool tomarLote(std::vector<Solicitud>& lote) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        hay_solicitudes_.wait(lock, [this] { return !cola_.empty() || cerrada_; });
+        if (cola_.empty()) return false;
+        hay_solicitudes_.wait_until(lock, cola_.front().llegada + plazo_,
+                                    [this] { return cola_.size() >= tam_lote_ || cerrada_; });
+        size_t cantidad = std::min(tam_lote_, cola_.size());
+        for (size_t i = 0; i < cantidad; i++) {
+            lote.push_back(std::move(cola_.front()));
+            cola_.pop_front();
+        }
+        hay_espacio_.notify_all();
+        return true;
+    }
+
+    void cerrar() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cerrada_ = true;
+        }
+        hay_solicitudes_.notify_all();
+        hay_espacio_.notify_all();
+    }
+};
+
+// Resuelve los lotes y entrega las respuestas; todo su estado es de un solo hilo
+class ResolutorLotes {
+private:
+    CalculadorTabular tabular_;
+    CacheSoluciones cache_;
+    Latencias latencias_;
+    uint64_t lotes_;
+    int fd_aviso_;                // Despierta al hilo de E/S cuando hay salida (-1 = no)
+
+    void entregar(Conexion& conexion, const std::string& respuestas) {
+        if (conexion.rota) return;
+        if (!conexion.propia) {
+            if (!escribirCompleto(conexion.fd_salida, respuestas.data(), respuestas.size())) {
+                conexion.rota = true;
+            }
+            return;
+        }
+        std::lock_guard<std::mutex> lock(conexion.mutex_salida);
+        if (conexion.salida.size() + respuestas.size() > MAX_SALIDA) {
+            conexion.rota = true;
+            std::string().swap(conexion.salida);
+            return;
+        }
+        conexion.salida += respuestas;
+    }
+
+    void responder(const Solicitud& solicitud, std::string& salida) {
+        if (solicitud.tipo == TipoSolicitud::ERROR) {
+            salida += "ERROR " + solicitud.error + "\n";
+            return;
+        }
+        if (solicitud.tipo == TipoSolicitud::ESTADISTICAS) {
+            salida += estadisticas() + "\n";
+            return;
+        }
+        EstadoMaquina estados[24];
+        double costo = cache_.resolver(tabular_, solicitud.mascara_criticas, estados);
+        bool valida = costo != CalculadorTabular::INFINITO;
+        char fila[MAX_FILA_CSV];
+        char* p = escribirCostoCsv(fila, costo);
+        *p++ = ',';
+        std::memcpy(p, valida ? "SI," : "NO,", 3);
+        p += 3;
+        p = escribirEnteroCsv(p, static_cast<uint64_t>(__builtin_popcount(solicitud.mascara_criticas)));
+        *p++ = ',';
+        p = escribirSecuenciaCsv(p, std::vector<EstadoMaquina>(estados, estados + 24));
+        *p++ = '\n';
+        salida.append(fila, static_cast<size_t>(p - fila));
+    }
+
+public:
+    explicit ResolutorLotes(size_t entradas_cache) : cache_(entradas_cache), lotes_(0), fd_aviso_(-1) {
+        tabular_.configurarDemanda(DEMANDA_FIJA, 500.0);
+        tabular_.configurarCostos(1.0, 2.5, 5.0);
+    }
+
+    const CalculadorTabular& tabular() const { return tabular_; }
+    void configurarAviso(int fd) { fd_aviso_ = fd; }
+
+    // Las respuestas de un mismo cliente salen en el orden de sus consultas
+    void procesar(std::vector<Solicitud>& lote) {
+        std::vector<std::pair<Conexion*, std::string>> salidas;
+        for (const Solicitud& solicitud : lote) {
+            if (salidas.empty() || salidas.back().first != solicitud.conexion.get()) {
+                auto existente = std::find_if(salidas.begin(), salidas.end(), [&](const auto& salida) {
+                    return salida.first == solicitud.conexion.get();
+                });
+                if (existente == salidas.end()) {
+                    salidas.emplace_back(solicitud.conexion.get(), std::string());
+                } else {
+                    std::rotate(existente, existente + 1, salidas.end());
+                }
+            }
+            responder(solicitud, salidas.back().second);
+        }
+        for (auto& [conexion, salida] : salidas) {
+            entregar(*conexion, salida);
+        }
+        Reloj::time_point ahora = Reloj::now();
+        for (const Solicitud& solicitud : lote) {
+            latencias_.registrar(std::chrono::duration<double, std::micro>(ahora - solicitud.llegada).count());
+            solicitud.conexion->en_cola--;
+        }
+        lotes_++;
+        lote.clear();
+        if (fd_aviso_ >= 0) {
+            char aviso = 1;
+            (void)!write(fd_aviso_, &aviso, 1);   // Con el pipe lleno el aviso ya está pendiente
+        }
+    }
+
+    std::string estadisticas() const {
+        std::ostringstream texto;
+        texto << std::fixed << std::setprecision(1) << "solicitudes=" << latencias_.total() << " lotes=" << lotes_
+              << " lote_medio=" << (lotes_ ? double(latencias_.total()) / lotes_ : 0.0)
+              << " p50_us=" << latencias_.percentil(50) << " p99_us=" << latencias_.percentil(99)
+              << " max_us=" << latencias_.maxima()
+              << " cache=" << cache_.aciertos() << "/" << cache_.consultas();
+        return texto.str();
+    }
+};
+
+// Interpreta una línea; devuelve false si no lleva respuesta (vacía o comentario)
+bool interpretarLinea(std::string_view linea, const CalculadorTabular& tabular, Solicitud& solicitud) {
+    while (!linea.empty() && (linea.back() == '\r' || linea.back() == ' ' || linea.back() == '\t')) {
+        linea.remove_suffix(1);
+    }
+    size_t inicio = linea.find_first_not_of(" \t");
+    if (inicio == std::string_view::npos || linea[inicio] == '#') return false;
+    linea.remove_prefix(inicio);
+
+    solicitud.tipo = TipoSolicitud::RESOLVER;
+    if (linea == CONSULTA_ESTADISTICAS) {
+        solicitud.tipo = TipoSolicitud::ESTADISTICAS;
+        return true;
+    }
+    size_t barra = linea.find('|');
+    if (barra != std::string_view::npos) {
+        double demanda[24], otras_fuentes[24];
+        std::string error;
+        if (!leerValoresHora(linea.substr(0, barra), demanda, error) ||
+            !leerValoresHora(linea.substr(barra + 1), otras_fuentes, error)) {
+            solicitud.tipo = TipoSolicitud::ERROR;
+            solicitud.error = error;
+        } else {
+            solicitud.mascara_criticas = mascaraCriticas(demanda, otras_fuentes);
+        }
+        return true;
+    }
+    uint32_t combinacion = 0;
+    bool patron = linea.size() == 24;
+    for (size_t i = 0; i < linea.size() && patron; i++) {
+        patron = linea[i] == '0' || linea[i] == '1';
+        combinacion = (combinacion << 1) | static_cast<uint32_t>(linea[i] == '1');
+    }
+    if (!patron) {
+        solicitud.tipo = TipoSolicitud::ERROR;
+        solicitud.error = "se esperaba un patrón de 24 bits, 'demanda | otras fuentes' o ESTADISTICAS";
+        return true;
+    }
+    solicitud.mascara_criticas = tabular.mascaraCriticas(CalculadorTabular::eolicaPorHora(combinacion));
+    return true;
+}
+
+// Agrega los bytes leídos al pendiente de la conexión y encola las líneas completas.
+// Si una línea supera MAX_LINEA_SOLVER encola un ERROR para ella y devuelve
+// false: no se leen más consultas de esa conexión
+bool encolarLineas(const std::shared_ptr<Conexion>& conexion, const char* datos, size_t tam,
+                   const CalculadorTabular& tabular, std::vector<Solicitud>& nuevas) {
+    Reloj::time_point llegada = Reloj::now();
+    std::string& pendiente = conexion->pendiente;
+    pendiente.append(datos, tam);
+    size_t inicio = 0, salto;
+    while ((salto = pendiente.find('\n', inicio)) != std::string::npos) {
+        Solicitud solicitud{conexion, TipoSolicitud::RESOLVER, 0, std::string(), llegada};
+        if (interpretarLinea(std::string_view(pendiente).substr(inicio, salto - inicio), tabular, solicitud)) {
+            conexion->en_cola++;
+            nuevas.push_back(std::move(solicitud));
+        }
+        inicio = salto + 1;
+    }
+    pendiente.erase(0, inicio);
+    if (pendiente.size() > MAX_LINEA_SOLVER) {
+        std::string().swap(pendiente);
+        conexion->en_cola++;
+        nuevas.push_back(Solicitud{conexion, TipoSolicitud::ERROR, 0,
+                                   "línea de más de " + std::to_string(MAX_LINEA_SOLVER) + " bytes", llegada});
+        return false;
+    }
+    return true;
+}
+
+// Una última línea sin '\n' al cerrar la entrada también es una consulta
+void encolarResto(const std::shared_ptr<Conexion>& conexion, const CalculadorTabular& tabular,
+                  std::vector<Solicitud>& nuevas) {
+    if (!conexion->pendiente.empty()) {
+        encolarLineas(conexion, "\n", 1, tabular, nuevas);
+    }
+}
+
+void atenderStdin(ColaLotes& cola, const CalculadorTabular& tabular) {
+    auto conexion = std::make_shared<Conexion>(STDIN_FILENO, STDOUT_FILENO, false);
+    std::vector<Solicitud> nuevas;
+    char buffer[1 << 16];
+    while (!terminar) {
+        cola.esperarEspacio();
+        ssize_t leidos = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (leidos < 0 && errno == EINTR) continue;
+        if (leidos <= 0) break;
+        bool seguir = encolarLineas(conexion, buffer, static_cast<size_t>(leidos), tabular, nuevas);
+        cola.agregar(nuevas);
+        if (!seguir) {
+            // El ERROR ya está en la cola: el hilo de lotes lo responde antes de terminar
+            throw std::runtime_error("línea de más de " + std::to_string(MAX_LINEA_SOLVER) + " bytes en stdin");
+        }
+    }
+    encolarResto(conexion, tabular, nuevas);
+    cola.agregar(nuevas);
+}
+
+int abrirSocket(const std::string& ruta) {
+    sockaddr_un direccion{};
+    if (ruta.size() >= sizeof(direccion.sun_path)) {
+        throw std::invalid_argument("ruta de socket demasiado larga: " + ruta);
+    }
+    // Un socket que quedó de una ejecución anterior se reemplaza; cualquier otro archivo, no
+    struct stat info;
+    if (lstat(ruta.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error(ruta + " existe y no es un socket");
+        }
+        unlink(ruta.c_str());
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        throw std::runtime_error("No se pudo crear el socket");
+    }
+    direccion.sun_family = AF_UNIX;
+    std::memcpy(direccion.sun_path, ruta.c_str(), ruta.size() + 1);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&direccion), sizeof(direccion)) != 0 || listen(fd, 128) != 0) {
+        close(fd);
+        throw std::runtime_error("No se pudo escuchar en " + ruta + ": " + std::strerror(errno));
+    }
+    return fd;
+}
+
+size_t bytesPorEnviar(Conexion& conexion) {
+    std::lock_guard<std::mutex> lock(conexion.mutex_salida);
+    return conexion.salida.size();
+}
+
+// Envía lo que el socket acepte sin bloquear
+void enviarPendiente(Conexion& conexion) {
+    std::lock_guard<std::mutex> lock(conexion.mutex_salida);
+    size_t enviados = 0;
+    while (enviados < conexion.salida.size()) {
+        ssize_t escritos = write(conexion.fd_salida, conexion.salida.data() + enviados, conexion.salida.size() - enviados);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (escritos <= 0) {
+            conexion.rota = true;
+            std::string().swap(conexion.salida);
+            return;
+        }
+        enviados += static_cast<size_t>(escritos);
+    }
+    conexion.salida.erase(0, enviados);
+}
+
+void atenderSocket(int servidor, int aviso, ColaLotes& cola, const CalculadorTabular& tabular) {
+    std::vector<std::shared_ptr<Conexion>> conexiones;
+    std::vector<pollfd> descriptores;
+    std::vector<Solicitud> nuevas;
+    char buffer[1 << 16];
+    while (!terminar) {
+        // Los dos primeros son el socket de escucha y el aviso del hilo de lotes.
+        // Se lee de un cliente solo si la cola tiene lugar, no le quedan consultas
+        // en ella y sus respuestas no están atrasadas
+        descriptores.assign({{servidor, POLLIN, 0}, {aviso, POLLIN, 0}});
+        bool cola_llena = cola.llena();
+        for (const std::shared_ptr<Conexion>& conexion : conexiones) {
+            size_t por_enviar = bytesPorEnviar(*conexion);
+            short eventos = 0;
+            if (!conexion->entrada_cerrada && !cola_llena && conexion->en_cola == 0 && por_enviar < LIMITE_SALIDA) {
+                eventos |= POLLIN;
+            }
+            if (por_enviar > 0) eventos |= POLLOUT;
+            descriptores.push_back({conexion->fd_entrada, eventos, 0});
+        }
+        int listos = poll(descriptores.data(), descriptores.size(), 200);
+        if (listos < 0 && errno != EINTR) {
+            throw std::runtime_error(std::string("poll: ") + std::strerror(errno));
+        }
+        if (listos <= 0) continue;
+        if (descriptores[1].revents & POLLIN) {
+            while (read(aviso, buffer, sizeof(buffer)) > 0) {}
+        }
+        for (size_t i = 0; i < conexiones.size(); i++) {
+            Conexion& conexion = *conexiones[i];
+            short recibidos = descriptores[i + 2].revents;
+            if (recibidos & POLLOUT) {
+                enviarPendiente(conexion);
+            }
+            if (recibidos & POLLIN) {
+                ssize_t leidos = read(conexion.fd_entrada, buffer, sizeof(buffer));
+                if (leidos < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+                bool seguir = leidos > 0 &&
+                              encolarLineas(conexiones[i], buffer, static_cast<size_t>(leidos), tabular, nuevas);
+                if (!seguir) {
+                    // Las respuestas pendientes se envían antes de soltar la conexión
+                    encolarResto(conexiones[i], tabular, nuevas);
+                    conexion.entrada_cerrada = true;
+                }
+            } else if (recibidos & (POLLHUP | POLLERR)) {
+                // El cliente se fue sin que se le estuviera leyendo: nada más que enviarle
+                conexion.rota = true;
+            }
+        }
+        // Se suelta la conexión rota y la que terminó sin nada por responder ni enviar
+        conexiones.erase(std::remove_if(conexiones.begin(), conexiones.end(),
+                                        [](const std::shared_ptr<Conexion>& conexion) {
+                                            return conexion->rota ||
+                                                   (conexion->entrada_cerrada && conexion->en_cola == 0 &&
+                                                    bytesPorEnviar(*conexion) == 0);
+                                        }),
+                         conexiones.end());
+        if (descriptores[0].revents & POLLIN) {
+            int cliente = accept4(servidor, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (cliente >= 0) {
+                conexiones.push_back(std::make_shared<Conexion>(cliente, cliente, true));
+            }
+        }
+        cola.agregar(nuevas);
+    }
+}
+
+bool interpretarOpciones(int argc, char* argv[], Opciones& opciones) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hay_valor = i + 1 < argc;
+        if (arg == "--socket" && hay_valor) {
+            opciones.ruta_socket = argv[++i];
+        } else if (arg == "--stdin") {
+            opciones.usar_stdin = true;
+        } else if (arg == "--lote" && hay_valor) {
+            opciones.tam_lote = std::max(1ul, std::stoul(argv[++i]));
+        } else if (arg == "--plazo-us" && hay_valor) {
+            opciones.plazo = std::chrono::microseconds(std::stoul(argv[++i]));
+        } else if (arg == "--cache" && hay_valor) {
+            opciones.entradas_cache = std::max(1ul, std::stoul(argv[++i]));
+        } else if (arg == "--cola" && hay_valor) {
+            opciones.capacidad_cola = std::max(1ul, std::stoul(argv[++i]));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+}
+
+int main(int argc, char* argv[]) {
+    Opciones opciones;
+    try {
+        if (!interpretarOpciones(argc, argv, opciones)) {
+            std::cerr << "Uso: " << argv[0] << " [--socket ruta | --stdin] [--lote N] [--plazo-us N] [--cache N] [--cola N]\n"
+                      << "Socket predeterminado: " << RUTA_SOCKET_SOLVER << "\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    // Sin SA_RESTART, para que una señal corte el read() bloqueante de stdin
+    struct sigaction accion{};
+    accion.sa_handler = alTerminar;
+    sigaction(SIGINT, &accion, nullptr);
+    sigaction(SIGTERM, &accion, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    ResolutorLotes resolutor(opciones.entradas_cache);
+    // En modo socket el hilo de lotes avisa por este pipe que hay respuestas por enviar
+    int aviso[2] = {-1, -1};
+    if (!opciones.usar_stdin) {
+        if (pipe2(aviso, O_CLOEXEC | O_NONBLOCK) != 0) {
+            std::cerr << "Error: No se pudo crear el pipe de avisos: " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        resolutor.configurarAviso(aviso[1]);
+    }
+    ColaLotes cola(opciones.tam_lote, opciones.plazo, opciones.capacidad_cola);
+    std::thread hilo_lotes([&] {
+        std::vector<Solicitud> lote;
+        while (cola.tomarLote(lote)) {
+            resolutor.procesar(lote);
+        }
+    });
+
+    int codigo = 0;
+    int servidor = -1;
+    try {
+        if (opciones.usar_stdin) {
+            atenderStdin(cola, resolutor.tabular());
+        } else {
+            servidor = abrirSocket(opciones.ruta_socket);
+            std::cerr << "🟢 Servidor del solver escuchando en " << opciones.ruta_socket << " (lotes de hasta "
+                      << opciones.tam_lote << ", plazo " << opciones.plazo.count() << " µs)\n";
+            atenderSocket(servidor, aviso[0], cola, resolutor.tabular());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        codigo = 1;
+    }
+    cola.cerrar();
+    hilo_lotes.join();
+    if (servidor >= 0) {
+        close(servidor);
+        unlink(opciones.ruta_socket.c_str());
+    }
+    for (int fd : aviso) {
+        if (fd >= 0) close(fd);
+    }
+    std::cerr << "Servidor detenido: " << resolutor.estadisticas() << "\n";
+    return codigo;
+}
@@ -0,0 +1,152 @@
+#include "shard_barrido.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+const char* const MARCA_SHARD = "#SHARD maquina_estados v1";
+
+uint32_t leerEntero(const std::string& texto, const std::string& clave) {
+    try {
+        size_t usados = 0;
+        unsigned long valor = std::stoul(texto, &usados);
+        if (usados == texto.size() && valor <= 0xFFFFFFFFul) {
+            return static_cast<uint32_t>(valor);
+        }
+    } catch (const std::exception&) {
+    }
+    throw std::invalid_argument("Valor inválido para " + clave + ": '" + texto + "'");
+}
+}
+
+void interpretarShard(const std::string& texto, uint32_t& indice, uint32_t& total_shards) {
+    size_t barra = texto.find('/');
+    if (barra == std::string::npos) {
+        throw std::invalid_argument("--shard espera i/N, se recibió '" + texto + "'");
+    }
+    indice = leerEntero(texto.substr(0, barra), "--shard");
+    total_shards = leerEntero(texto.substr(barra + 1), "--shard");
+    if (total_shards == 0 || indice >= total_shards) {
+        throw std::invalid_argument("--shard " + texto + ": se necesita 0 <= i < N");
+    }
+}
+
+void rangoDeShard(uint32_t combinaciones, uint32_t indice, uint32_t total_shards,
+                  uint32_t& desde, uint32_t& hasta) {
+    desde = static_cast<uint32_t>(static_cast<uint64_t>(combinaciones) * indice / total_shards);
+    hasta = static_cast<uint32_t>(static_cast<uint64_t>(combinaciones) * (indice + 1) / total_shards);
+}
+
+std::string listaValores(const std::vector<double>& valores) {
+    std::ostringstream ss;
+    for (size_t i = 0; i < valores.size(); i++) {
+        if (i > 0) ss << ",";
+        ss << valores[i];
+    }
+    return ss.str();
+}
+
+void escribirCabeceraShard(std::ostream& salida, const MetadatosShard& metadatos,
+                           const ResumenAgregado& resumen, bool completo, uint64_t bytes_filas) {
+    salida << MARCA_SHARD << "\n";
+    salida << "generador=" << metadatos.generador << "\n";
+    salida << "shard=" << metadatos.indice << "/" << metadatos.total_shards << "\n";
+    salida << "desde=" << metadatos.desde << "\n";
+    salida << "hasta=" << metadatos.hasta << "\n";
+    for (const auto& parametro : metadatos.parametros) {
+        salida << "param." << parametro.first << "=" << parametro.second << "\n";
+    }
+    salida << "columnas=" << metadatos.columnas << "\n";
+    salida << "completo=" << (completo ? 1 : 0) << "\n";
+    salida << "filas_bytes=" << std::setw(20) << std::setfill('0') << bytes_filas << std::setfill(' ') << "\n";
+    salida << "resumen_bytes=" << sizeof(ResumenAgregado) << "\n";
+    salida.write(reinterpret_cast<const char*>(&resumen), sizeof(ResumenAgregado));
+}
+
+ShardMapeado::ShardMapeado(const std::string& archivo) :
+    archivo_(archivo), datos_(nullptr), tam_(0), completo_(false),
+    resumen_(std::make_unique<ResumenAgregado>()), inicio_filas_(0) {
+
+    int fd = open(archivo.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("No se pudo abrir el shard: " + archivo);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("Shard vacío o ilegible: " + archivo);
+    }
+    tam_ = static_cast<size_t>(info.st_size);
+    void* mapa = mmap(nullptr, tam_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        throw std::runtime_error("No se pudo mapear el shard: " + archivo);
+    }
+    datos_ = static_cast<const char*>(mapa);
+    madvise(mapa, tam_, MADV_SEQUENTIAL);
+
+    try {
+        // Cabecera: líneas de texto hasta resumen_bytes
+        size_t pos = 0;
+        bool primera = true;
+        size_t resumen_bytes = 0;
+        uint64_t filas_bytes = 0;
+        while (true) {
+            const char* fin = static_cast<const char*>(std::memchr(datos_ + pos, '\n', tam_ - pos));
+            if (fin == nullptr) {
+                throw std::runtime_error("Cabecera de shard incompleta: " + archivo);
+            }
+            std::string linea(datos_ + pos, fin);
+            pos = static_cast<size_t>(fin - datos_) + 1;
+
+            if (primera) {
+                if (linea != MARCA_SHARD) {
+                    throw std::runtime_error("No es un shard de barrido: " + archivo);
+                }
+                primera = false;
+                continue;
+            }
+            size_t igual = linea.find('=');
+            if (igual == std::string::npos) {
+                throw std::runtime_error("Línea inválida en la cabecera de " + archivo + ": " + linea);
+            }
+            std::string clave = linea.substr(0, igual);
+            std::string valor = linea.substr(igual + 1);
+
+            if (clave == "generador") metadatos_.generador = valor;
+            else if (clave == "columnas") metadatos_.columnas = valor;
+            else if (clave == "shard") interpretarShard(valor, metadatos_.indice, metadatos_.total_shards);
+            else if (clave == "desde") metadatos_.desde = leerEntero(valor, clave);
+            else if (clave == "hasta") metadatos_.hasta = leerEntero(valor, clave);
+            else if (clave == "completo") completo_ = valor == "1";
+            else if (clave == "filas_bytes") filas_bytes = std::stoull(valor);
+            else if (clave.compare(0, 6, "param.") == 0) metadatos_.parametros[clave.substr(6)] = valor;
+            else if (clave == "resumen_bytes") {
+                resumen_bytes = leerEntero(valor, clave);
+                break;
+            }
+        }
+
+        if (resumen_bytes != sizeof(ResumenAgregado) || tam_ - pos < resumen_bytes) {
+            throw std::runtime_error("Resumen del shard incompatible o truncado: " + archivo);
+        }
+        // El resumen puede quedar desalineado en el mapa: se copia
+        std::memcpy(static_cast<void*>(resumen_.get()), datos_ + pos, resumen_bytes);
+        inicio_filas_ = pos + resumen_bytes;
+        if (completo_ && filas_bytes != tam_ - inicio_filas_) {
+            throw std::runtime_error("Shard truncado o con filas de más: " + archivo);
+        }
+    } catch (...) {
+        munmap(const_cast<char*>(datos_), tam_);
+        throw;
+    }
+}
+
+ShardMapeado::~ShardMapeado() {
+    munmap(const_cast<char*>(datos_), tam_);
+}
@@ -0,0 +1,175 @@
+#include "telemetria.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+// La tasa suavizada pesa así cada intervalo nuevo
+constexpr double PESO_TASA = 0.3;
+
+std::string valorPrometheus(double valor) {
+    std::ostringstream texto;
+    texto << std::setprecision(15) << valor;
+    return texto.str();
+}
+
+void escribirMetrica(std::ostream& salida, const std::string& nombre, const char* tipo, const char* ayuda) {
+    salida << "# HELP " << nombre << " " << ayuda << "\n";
+    salida << "# TYPE " << nombre << " " << tipo << "\n";
+}
+}
+
+void LecturaTelemetria::combinar(const LecturaTelemetria& otra) {
+    procesadas += otra.procesadas;
+    validas += otra.validas;
+    mejor_costo = std::min(mejor_costo, otra.mejor_costo);
+    tasa += otra.tasa;
+}
+
+TelemetriaHilos::TelemetriaHilos(unsigned num_ranuras) :
+    ranuras_(new RanuraTelemetria[std::max(1u, num_ranuras)]), num_ranuras_(std::max(1u, num_ranuras)) {}
+
+LecturaTelemetria TelemetriaHilos::leer(unsigned hilo) const {
+    LecturaTelemetria lectura;
+    lectura.procesadas = ranuras_[hilo].procesadas.load(std::memory_order_relaxed);
+    lectura.validas = ranuras_[hilo].validas.load(std::memory_order_relaxed);
+    lectura.mejor_costo = ranuras_[hilo].mejor_costo.load(std::memory_order_relaxed);
+    return lectura;
+}
+
+LecturaTelemetria TelemetriaHilos::leerTotal() const {
+    LecturaTelemetria total;
+    for (unsigned h = 0; h < num_ranuras_; h++) {
+        total.combinar(leer(h));
+    }
+    return total;
+}
+
+EstimadorAvance::EstimadorAvance() {
+    reiniciar();
+}
+
+void EstimadorAvance::reiniciar() {
+    inicio_ = Reloj::now();
+    ultima_ = inicio_;
+    ultimas_procesadas_ = 0;
+    tasa_ = 0.0;
+}
+
+void EstimadorAvance::actualizar(uint64_t procesadas) {
+    auto ahora = Reloj::now();
+    double segundos = std::chrono::duration<double>(ahora - ultima_).count();
+    if (segundos <= 0.0 || procesadas < ultimas_procesadas_) {
+        return;
+    }
+    double tasa_intervalo = (procesadas - ultimas_procesadas_) / segundos;
+    tasa_ = tasa_ == 0.0 ? tasa_intervalo : PESO_TASA * tasa_intervalo + (1.0 - PESO_TASA) * tasa_;
+    ultima_ = ahora;
+    ultimas_procesadas_ = procesadas;
+}
+
+double EstimadorAvance::segundos() const {
+    return std::chrono::duration<double>(Reloj::now() - inicio_).count();
+}
+
+double EstimadorAvance::eta(uint64_t procesadas, uint64_t total) const {
+    if (procesadas >= total) {
+        return 0.0;
+    }
+    if (tasa_ <= 0.0) {
+        return -1.0;
+    }
+    return (total - procesadas) / tasa_;
+}
+
+bool escribirMetricasPrometheus(const std::string& ruta, const MetricasBarrido& metricas) {
+    const std::string base = "{programa=\"" + metricas.programa + "\"";
+    auto fuente = [&](size_t i) {
+        return base + "," + metricas.etiqueta_fuente + "=\"" + std::to_string(i) + "\"}";
+    };
+
+    std::ostringstream salida;
+    escribirMetrica(salida, "maquina_combinaciones_totales", "gauge", "Combinaciones del barrido");
+    salida << "maquina_combinaciones_totales" << base << "} " << metricas.total << "\n";
+    escribirMetrica(salida, "maquina_combinaciones_procesadas_total", "counter", "Combinaciones resueltas");
+    salida << "maquina_combinaciones_procesadas_total" << base << "} " << metricas.global.procesadas << "\n";
+    escribirMetrica(salida, "maquina_soluciones_validas_total", "counter", "Combinaciones con solución válida");
+    salida << "maquina_soluciones_validas_total" << base << "} " << metricas.global.validas << "\n";
+    escribirMetrica(salida, "maquina_mejor_costo", "gauge", "Menor costo encontrado hasta ahora");
+    if (metricas.global.validas > 0) {
+        salida << "maquina_mejor_costo" << base << "} " << valorPrometheus(metricas.global.mejor_costo) << "\n";
+    }
+    escribirMetrica(salida, "maquina_tasa_combinaciones_por_segundo", "gauge", "Tasa suavizada del barrido");
+    salida << "maquina_tasa_combinaciones_por_segundo" << base << "} " << valorPrometheus(metricas.global.tasa) << "\n";
+    escribirMetrica(salida, "maquina_progreso_ratio", "gauge", "Fracción del barrido completada");
+    salida << "maquina_progreso_ratio" << base << "} "
+           << valorPrometheus(metricas.total > 0 ? static_cast<double>(metricas.global.procesadas) / metricas.total : 1.0)
+           << "\n";
+    escribirMetrica(salida, "maquina_eta_segundos", "gauge", "Tiempo estimado hasta terminar");
+    if (metricas.eta >= 0.0) {
+        salida << "maquina_eta_segundos" << base << "} " << valorPrometheus(metricas.eta) << "\n";
+    }
+    escribirMetrica(salida, "maquina_segundos_transcurridos", "gauge", "Segundos desde el inicio del barrido");
+    salida << "maquina_segundos_transcurridos" << base << "} " << valorPrometheus(metricas.segundos) << "\n";
+
+    // Series por hilo o por proceso, con nombre propio para que sum() no cuente dos veces
+    escribirMetrica(salida, "maquina_fuente_combinaciones_procesadas_total", "counter", "Combinaciones resueltas por fuente");
+    for (size_t i = 0; i < metricas.fuentes.size(); i++) {
+        salida << "maquina_fuente_combinaciones_procesadas_total" << fuente(i) << " " << metricas.fuentes[i].procesadas << "\n";
+    }
+    escribirMetrica(salida, "maquina_fuente_soluciones_validas_total", "counter", "Soluciones válidas por fuente");
+    for (size_t i = 0; i < metricas.fuentes.size(); i++) {
+        salida << "maquina_fuente_soluciones_validas_total" << fuente(i) << " " << metricas.fuentes[i].validas << "\n";
+    }
+    escribirMetrica(salida, "maquina_fuente_mejor_costo", "gauge", "Menor costo encontrado por fuente");
+    for (size_t i = 0; i < metricas.fuentes.size(); i++) {
+        if (metricas.fuentes[i].validas > 0) {
+            salida << "maquina_fuente_mejor_costo" << fuente(i) << " " << valorPrometheus(metricas.fuentes[i].mejor_costo) << "\n";
+        }
+    }
+    escribirMetrica(salida, "maquina_fuente_tasa_combinaciones_por_segundo", "gauge", "Tasa promedio por fuente");
+    for (size_t i = 0; i < metricas.fuentes.size(); i++) {
+        salida << "maquina_fuente_tasa_combinaciones_por_segundo" << fuente(i) << " "
+               << valorPrometheus(metricas.fuentes[i].tasa) << "\n";
+    }
+
+    const std::string temporal = ruta + ".tmp";
+    {
+        std::ofstream archivo(temporal, std::ios::trunc);
+        archivo << salida.str();
+        if (!archivo.flush()) {
+            return false;
+        }
+    }
+    return std::rename(temporal.c_str(), ruta.c_str()) == 0;
+}
+
+PublicadorMetricas::PublicadorMetricas(const std::string& ruta, std::chrono::milliseconds intervalo,
+                                       std::function<MetricasBarrido()> leer) :
+    ruta_(ruta), intervalo_(intervalo), leer_(std::move(leer)), terminar_(false) {
+    hilo_ = std::thread(&PublicadorMetricas::ciclo, this);
+}
+
+PublicadorMetricas::~PublicadorMetricas() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        terminar_ = true;
+    }
+    cv_.notify_all();
+    hilo_.join();
+}
+
+void PublicadorMetricas::ciclo() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        bool terminar = cv_.wait_for(lock, intervalo_, [&] { return terminar_; });
+        lock.unlock();
+        escribirMetricasPrometheus(ruta_, leer_());
+        lock.lock();
+        if (terminar) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,290 @@
+#include "topologia.hpp"
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+// CPUs de la máscara de afinidad del proceso (todas si no se puede leer)
+std::vector<int> cpusPermitidas() {
+    std::vector<int> cpus;
+    cpu_set_t mascara;
+    CPU_ZERO(&mascara);
+    if (sched_getaffinity(0, sizeof(mascara), &mascara) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &mascara)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    if (cpus.empty()) {
+        for (int cpu = 0; cpu < static_cast<int>(std::max(1u, std::thread::hardware_concurrency())); cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+bool leerLinea(const std::string& ruta, std::string& linea) {
+    std::ifstream archivo(ruta);
+    linea.clear();
+    return archivo && (std::getline(archivo, linea) || archivo.eof());
+}
+
+// Número al final de un nombre como "node3"; -1 si no tiene esa forma
+int numeroConPrefijo(const std::string& nombre, const std::string& prefijo) {
+    if (nombre.size() <= prefijo.size() || nombre.compare(0, prefijo.size(), prefijo) != 0 ||
+        !std::all_of(nombre.begin() + prefijo.size(), nombre.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return -1;
+    }
+    return std::stoi(nombre.substr(prefijo.size()));
+}
+
+// Nodos NUMA de <raiz>/node/nodeN/cpulist, restringidos a `permitidas`
+std::vector<DominioMemoria> leerNodos(const std::string& raiz, const std::vector<int>& permitidas) {
+    std::vector<DominioMemoria> dominios;
+    std::error_code error;
+    for (const auto& entrada : std::filesystem::directory_iterator(raiz + "/node", error)) {
+        int nodo = numeroConPrefijo(entrada.path().filename().string(), "node");
+        std::string lista;
+        if (nodo < 0 || !leerLinea(entrada.path().string() + "/cpulist", lista)) {
+            continue;
+        }
+        DominioMemoria dominio{nodo, {}};
+        // Los nodos solo de memoria (sin CPUs) quedan vacíos y se descartan
+        for (int cpu : interpretarListaCpus(lista)) {
+            if (std::binary_search(permitidas.begin(), permitidas.end(), cpu)) {
+                dominio.cpus.push_back(cpu);
+            }
+        }
+        if (!dominio.cpus.empty()) {
+            dominios.push_back(dominio);
+        }
+    }
+    return dominios;
+}
+
+// Sockets de <raiz>/cpu/cpuN/topology/physical_package_id; vacío si falta alguno
+std::vector<DominioMemoria> leerSockets(const std::string& raiz, const std::vector<int>& permitidas) {
+    std::map<int, std::vector<int>> por_socket;
+    for (int cpu : permitidas) {
+        std::string linea;
+        if (!leerLinea(raiz + "/cpu/cpu" + std::to_string(cpu) + "/topology/physical_package_id", linea) ||
+            linea.empty()) {
+            return {};
+        }
+        por_socket[std::stoi(linea)].push_back(cpu);
+    }
+    std::vector<DominioMemoria> dominios;
+    for (const auto& [socket, cpus] : por_socket) {
+        dominios.push_back(DominioMemoria{socket, cpus});
+    }
+    return dominios;
+}
+}
+
+std::vector<int> interpretarListaCpus(const std::string& texto) {
+    std::vector<int> cpus;
+    std::istringstream entrada(texto);
+    std::string tramo;
+    while (std::getline(entrada, tramo, ',')) {
+        tramo.erase(std::remove_if(tramo.begin(), tramo.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }),
+                    tramo.end());
+        if (tramo.empty()) {
+            continue;
+        }
+        size_t guion = tramo.find('-');
+        try {
+            int desde = std::stoi(tramo.substr(0, guion));
+            int hasta = guion == std::string::npos ? desde : std::stoi(tramo.substr(guion + 1));
+            if (desde < 0 || hasta < desde) {
+                throw std::invalid_argument(tramo);
+            }
+            for (int cpu = desde; cpu <= hasta; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            throw std::invalid_argument("lista de CPUs inválida: " + texto);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+std::string formatearListaCpus(const std::vector<int>& cpus) {
+    std::string texto;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) {
+            j++;
+        }
+        if (!texto.empty()) texto += ",";
+        texto += std::to_string(cpus[i]);
+        if (j > i) texto += "-" + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return texto;
+}
+
+Topologia Topologia::detectar(const std::string& raiz) {
+    std::vector<int> permitidas = cpusPermitidas();
+    Topologia topologia;
+    topologia.dominios_ = leerNodos(raiz, permitidas);
+    topologia.origen_ = "nodos NUMA";
+    if (topologia.dominios_.empty()) {
+        topologia.dominios_ = leerSockets(raiz, permitidas);
+        topologia.origen_ = "sockets";
+    }
+    if (topologia.dominios_.empty()) {
+        topologia.dominios_.push_back(DominioMemoria{0, permitidas});
+        topologia.origen_ = "dominio único";
+    }
+    std::sort(topologia.dominios_.begin(), topologia.dominios_.end(),
+              [](const DominioMemoria& a, const DominioMemoria& b) { return a.id < b.id; });
+    return topologia;
+}
+
+Topologia Topologia::repartir(unsigned indice, unsigned total) const {
+    if (total == 0 || indice >= total) {
+        throw std::invalid_argument("Reparto de CPUs inválido");
+    }
+    // Cada CPU con su dominio, en orden de dominio
+    std::vector<std::pair<int, int>> todas;
+    for (const DominioMemoria& dominio : dominios_) {
+        for (int cpu : dominio.cpus) {
+            todas.emplace_back(dominio.id, cpu);
+        }
+    }
+    size_t desde = static_cast<size_t>(indice) * todas.size() / total;
+    size_t hasta = static_cast<size_t>(indice + 1) * todas.size() / total;
+    if (desde == hasta) {
+        // Más procesos que CPUs: los procesos comparten CPUs
+        desde = indice % todas.size();
+        hasta = desde + 1;
+    }
+
+    Topologia parte;
+    parte.origen_ = origen_;
+    for (size_t i = desde; i < hasta; i++) {
+        if (parte.dominios_.empty() || parte.dominios_.back().id != todas[i].first) {
+            parte.dominios_.push_back(DominioMemoria{todas[i].first, {}});
+        }
+        parte.dominios_.back().cpus.push_back(todas[i].second);
+    }
+    return parte;
+}
+
+void Topologia::asignarHilos(unsigned num_hilos, std::vector<int>& cpus, std::vector<unsigned>& dominios) const {
+    // Por vueltas: la primera CPU de cada dominio, luego la segunda, ...
+    size_t max_cpus = 0;
+    for (const DominioMemoria& dominio : dominios_) {
+        max_cpus = std::max(max_cpus, dominio.cpus.size());
+    }
+    std::vector<std::pair<int, unsigned>> orden;
+    for (size_t vuelta = 0; vuelta < max_cpus; vuelta++) {
+        for (unsigned d = 0; d < dominios_.size(); d++) {
+            if (vuelta < dominios_[d].cpus.size()) {
+                orden.emplace_back(dominios_[d].cpus[vuelta], d);
+            }
+        }
+    }
+    cpus.resize(num_hilos);
+    dominios.resize(num_hilos);
+    for (unsigned hilo = 0; hilo < num_hilos; hilo++) {
+        cpus[hilo] = orden[hilo % orden.size()].first;
+        dominios[hilo] = orden[hilo % orden.size()].second;
+    }
+}
+
+std::vector<int> Topologia::cpus() const {
+    std::vector<int> todas;
+    for (const DominioMemoria& dominio : dominios_) {
+        todas.insert(todas.end(), dominio.cpus.begin(), dominio.cpus.end());
+    }
+    std::sort(todas.begin(), todas.end());
+    return todas;
+}
+
+std::string Topologia::describir() const {
+    std::string texto = origen_ + ":";
+    for (size_t d = 0; d < dominios_.size(); d++) {
+        texto += (d == 0 ? " " : " | ") + std::to_string(dominios_[d].id) + " [" +
+                 formatearListaCpus(dominios_[d].cpus) + "]";
+    }
+    return texto;
+}
+
+bool fijarHiloActual(const std::vector<int>& cpus) {
+    cpu_set_t mascara;
+    CPU_ZERO(&mascara);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &mascara);
+        }
+    }
+    return CPU_COUNT(&mascara) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(mascara), &mascara) == 0;
+}
+
+void ejecutarEnDominio(const Topologia& topologia, unsigned dominio, const std::function<void()>& funcion) {
+    std::exception_ptr error;
+    std::thread hilo([&] {
+        try {
+            fijarHiloActual(topologia.dominios().at(dominio).cpus);
+            funcion();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    });
+    hilo.join();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void aplicarAfinidad(PoolBloques& pool, const Topologia& topologia) {
+    std::vector<int> cpus;
+    std::vector<unsigned> dominios;
+    topologia.asignarHilos(pool.getNumHilos(), cpus, dominios);
+    pool.configurarDominios(dominios, [cpus](unsigned hilo) { fijarHiloActual({cpus[hilo]}); });
+}
+
+std::vector<RendimientoDominio> rendimientoPorDominio(const Topologia& topologia, const PoolBloques& pool, int proceso) {
+    std::vector<RendimientoDominio> filas;
+    std::vector<PoolBloques::EstadisticasDominio> estadisticas = pool.estadisticasDominios();
+    for (size_t d = 0; d < estadisticas.size(); d++) {
+        int id = d < topologia.dominios().size() ? topologia.dominios()[d].id : static_cast<int>(d);
+        filas.push_back(RendimientoDominio{proceso, id, estadisticas[d]});
+    }
+    return filas;
+}
+
+void imprimirRendimientoDominios(std::ostream& salida, const std::vector<RendimientoDominio>& filas) {
+    bool con_procesos = std::any_of(filas.begin(), filas.end(), [](const RendimientoDominio& f) { return f.proceso >= 0; });
+    std::ios::fmtflags formato = salida.flags();
+    std::streamsize precision = salida.precision();
+    salida << "\n=== RENDIMIENTO POR DOMINIO DE MEMORIA ===\n";
+    if (con_procesos) salida << std::setw(8) << "Proceso";
+    salida << std::setw(8) << "Dominio" << std::setw(7) << "Hilos" << std::setw(15) << "Combinaciones"
+           << std::setw(14) << "Tasa (c/s)" << std::setw(14) << "Por hilo" << std::setw(11) << "Robos loc."
+           << std::setw(11) << "Robos rem." << "\n";
+    for (const RendimientoDominio& fila : filas) {
+        const PoolBloques::EstadisticasDominio& e = fila.estadisticas;
+        // Tasa del dominio con todos sus hilos ocupados a la vez
+        double por_hilo = e.segundos > 0.0 ? e.combinaciones / e.segundos : 0.0;
+        if (con_procesos) salida << std::setw(8) << fila.proceso;
+        salida << std::setw(8) << fila.dominio << std::setw(7) << e.hilos << std::setw(15) << e.combinaciones
+               << std::fixed << std::setprecision(0) << std::setw(14) << por_hilo * e.hilos << std::setw(14) << por_hilo
+               << std::setw(11) << e.robos_locales << std::setw(11) << e.robos_remotos << "\n";
+    }
+    salida.flags(formato);
+    salida.precision(precision);
+}
@@ -0,0 +1,548 @@
+#include "calculador_costos.hpp"
+#include "calculador_tabular.hpp"
+#include "cubo_resultados.hpp"
+#include "escenario.hpp"
+#include "pool_bloques.hpp"
+#include <algorithm>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Verificación diferencial de motores: cada patrón eólico se resuelve con un
+// motor candidato y con el de referencia (CalculadorCostos::resolver) y se
+// comparan la validez, el costo en punto fijo (centésimas, como el cubo) y la
+// secuencia: que respete la máquina de estados y que su costo, recalculado acá,
+// sea el óptimo de la referencia. Varias secuencias pueden compartir el costo
+// óptimo, así que una secuencia distinta pero óptima no es una diferencia.
+// Cada diferencia se reduce a un patrón mínimo que la reproduce, en el formato
+// de analizador_individual (hora 0 a la izquierda).
+//
+// Uso: verificar_motores [--motor tabular|cubo] [--cubo archivo] [--todas | --muestra N]
+//                        [--rango D H] [--semilla S] [--hilos N] [--bloque N]
+//                        [--reproductores archivo] [--max-reproductores N]
+// Sale con 1 si hay alguna diferencia.
+
+namespace {
+const int NUM_HORAS = 24;
+const uint32_t TOTAL_PATRONES = 1u << NUM_HORAS;
+const double ENERGIA_EOLICA = 500.0;
+const double COSTO_FRIO = 1.0, COSTO_TIBIO = 2.5, COSTO_CALIENTE = 5.0;
+const double ESCALA_COSTO = 100.0;   // Costos comparados en centésimas
+const std::vector<double> DEMANDA = {300, 200, 100, 100, 100, 200, 300, 500, 800, 1000, 1000, 1000,
+                                     1000, 900, 800, 800, 800, 1000, 1000, 1000, 600, 600, 400, 300};
+
+// Tipos de diferencia, como bits de una máscara
+enum TipoDiferencia {
+    VALIDEZ = 1 << 0,                    // Uno encuentra solución y el otro no
+    COSTO = 1 << 1,                      // Costos distintos en punto fijo
+    SECUENCIA_INFACTIBLE = 1 << 2,       // La secuencia del candidato rompe las reglas
+    SECUENCIA_NO_OPTIMA = 1 << 3,        // Es factible pero no cuesta el óptimo
+    REFERENCIA_INCONSISTENTE = 1 << 4    // La secuencia de la referencia no cuesta lo que dice
+};
+const int NUM_TIPOS = 5;
+const char* const NOMBRES_TIPOS[NUM_TIPOS] = {"validez", "costo", "secuencia infactible", "secuencia no óptima",
+                                              "referencia inconsistente"};
+
+struct ResultadoMotor {
+    bool valida = false;
+    double costo = 0.0;
+    EstadoMaquina estados[NUM_HORAS] = {};
+};
+
+// Motor a verificar. Responde los IDs [desde, hasta) de su propia convención;
+// `ids_invertidos` indica que son los del analizador exhaustivo (bit h = hora h)
+// y no los de analizador_individual (hora 0 = bit 23)
+struct MotorCandidato {
+    std::string nombre;
+    uint32_t desde = 0;
+    uint32_t hasta = TOTAL_PATRONES;
+    bool ids_invertidos = false;
+    std::function<void(uint32_t, ResultadoMotor&)> resolver;   // Recibe la combinación
+
+    uint32_t combinacionDeId(uint32_t id) const { return ids_invertidos ? invertirPatron24(id) : id; }
+    bool responde(uint32_t combinacion) const {
+        uint32_t id = combinacionDeId(combinacion);   // Invertir es su propia inversa
+        return id >= desde && id < hasta;
+    }
+};
+
+struct Opciones {
+    std::string motor;
+    std::string archivo_cubo;
+    bool todas;
+    uint32_t muestra;
+    bool con_rango;
+    uint32_t desde;
+    uint32_t hasta;
+    uint64_t semilla;
+    unsigned num_hilos;
+    uint32_t tam_bloque;
+    std::string archivo_reproductores;
+    size_t max_reproductores;
+
+    Opciones() : motor("tabular"), todas(false), muestra(20000), con_rango(false), desde(0), hasta(TOTAL_PATRONES),
+                 semilla(20240601), num_hilos(0), tam_bloque(0), max_reproductores(20) {}
+};
+
+bool interpretarOpciones(int argc, char* argv[], Opciones& opciones) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hay_valor = i + 1 < argc;
+        if (arg == "--motor" && hay_valor) {
+            opciones.motor = argv[++i];
+        } else if (arg == "--cubo" && hay_valor) {
+            opciones.archivo_cubo = argv[++i];
+        } else if (arg == "--todas") {
+            opciones.todas = true;
+        } else if (arg == "--muestra" && hay_valor) {
+            opciones.muestra = std::stoul(argv[++i]);
+        } else if (arg == "--rango" && i + 2 < argc) {
+            opciones.desde = std::stoul(argv[++i]);
+            opciones.hasta = std::stoul(argv[++i]);
+            opciones.con_rango = true;
+        } else if (arg == "--semilla" && hay_valor) {
+            opciones.semilla = std::stoull(argv[++i]);
+        } else if (arg == "--hilos" && hay_valor) {
+            opciones.num_hilos = std::stoul(argv[++i]);
+        } else if (arg == "--bloque" && hay_valor) {
+            opciones.tam_bloque = std::stoul(argv[++i]);
+        } else if (arg == "--reproductores" && hay_valor) {
+            opciones.archivo_reproductores = argv[++i];
+        } else if (arg == "--max-reproductores" && hay_valor) {
+            opciones.max_reproductores = std::stoul(argv[++i]);
+        } else if (arg == "--ayuda" || arg == "-h") {
+            return false;
+        } else {
+            throw std::invalid_argument("opción desconocida o incompleta: " + arg);
+        }
+    }
+    if (opciones.desde >= opciones.hasta || opciones.hasta > TOTAL_PATRONES) {
+        throw std::invalid_argument("rango inválido");
+    }
+    return true;
+}
+
+// Motor de referencia: el solver recursivo con memoización, tal como lo usan
+// los barridos
+void resolverReferencia(uint32_t combinacion, ResultadoMotor& resultado) {
+    std::vector<double> eolica(NUM_HORAS);
+    for (int hora = 0; hora < NUM_HORAS; hora++) {
+        eolica[hora] = (combinacion >> (23 - hora)) & 1u ? ENERGIA_EOLICA : 0.0;
+    }
+    Escenario escenario;
+    escenario.configurarDirecto(DEMANDA, eolica);
+    CalculadorCostos calculador(escenario);
+    calculador.configurarCostos(COSTO_FRIO, COSTO_TIBIO, COSTO_CALIENTE);
+    calculador.configurarSilencioso(true);
+    Solucion solucion = calculador.resolver();
+
+    resultado.valida = solucion.es_valida;
+    resultado.costo = solucion.costo_total;
+    std::copy(solucion.estados_por_hora.begin(), solucion.estados_por_hora.end(), resultado.estados);
+}
+
+std::unique_ptr<MotorCandidato> crearMotor(const Opciones& opciones, std::shared_ptr<const CuboResultados>& cubo) {
+    auto motor = std::make_unique<MotorCandidato>();
+    motor->nombre = opciones.motor;
+    if (opciones.motor == "tabular") {
+        auto tabular = std::make_shared<CalculadorTabular>();
+        tabular->configurarDemanda(DEMANDA, ENERGIA_EOLICA);
+        tabular->configurarCostos(COSTO_FRIO, COSTO_TIBIO, COSTO_CALIENTE);
+        motor->resolver = [tabular](uint32_t combinacion, ResultadoMotor& resultado) {
+            uint32_t criticas = tabular->mascaraCriticas(CalculadorTabular::eolicaPorHora(combinacion));
+            resultado.costo = tabular->resolver(criticas, resultado.estados);
+            resultado.valida = resultado.costo != CalculadorTabular::INFINITO;
+        };
+    } else if (opciones.motor == "cubo") {
+        // Un barrido ya guardado: se verifica contra la referencia fila por fila
+        if (opciones.archivo_cubo.empty()) {
+            throw std::invalid_argument("--motor cubo necesita --cubo archivo");
+        }
+        cubo = std::make_shared<const CuboResultados>(opciones.archivo_cubo);
+        if (!cubo->mismaConfiguracion(DEMANDA, ENERGIA_EOLICA, COSTO_FRIO, COSTO_TIBIO, COSTO_CALIENTE)) {
+            throw std::runtime_error("El cubo " + opciones.archivo_cubo + " se generó con otra demanda o con otros costos");
+        }
+        motor->desde = cubo->desde();
+        motor->hasta = cubo->hasta();
+        motor->ids_invertidos = true;
+        std::shared_ptr<const CuboResultados> datos = cubo;
+        motor->resolver = [datos](uint32_t combinacion, ResultadoMotor& resultado) {
+            uint32_t id = invertirPatron24(combinacion);
+            resultado.valida = datos->valida(id);
+            resultado.costo = datos->costo(id);
+            for (int hora = 0; hora < NUM_HORAS; hora++) {
+                resultado.estados[hora] = datos->estado(id, hora);
+            }
+        };
+    } else {
+        throw std::invalid_argument("motor desconocido: " + opciones.motor + " (tabular o cubo)");
+    }
+    return motor;
+}
+
+// Horas que la eólica no cubre (bit h = hora h), con la condición de
+// Escenario::demandaCubiertaConEO
+uint32_t horasCriticas(uint32_t combinacion) {
+    uint32_t criticas = 0;
+    for (int hora = 0; hora < NUM_HORAS; hora++) {
+        double eolica = (combinacion >> (23 - hora)) & 1u ? ENERGIA_EOLICA : 0.0;
+        if (!(eolica >= DEMANDA[hora])) {
+            criticas |= 1u << hora;
+        }
+    }
+    return criticas;
+}
+
+int64_t costoFijo(double costo) {
+    return std::llround(costo * ESCALA_COSTO);
+}
+
+// Transiciones de CalculadorCostos::obtenerTransicionesPosibles, escritas de
+// nuevo acá para no juzgar a un motor con sus propias tablas
+bool transicionPermitida(EstadoMaquina desde, EstadoMaquina hacia) {
+    switch (desde) {
+        case EstadoMaquina::ON_CALIENTE:
+        case EstadoMaquina::ON_TIBIO:
+            return hacia == EstadoMaquina::ON_CALIENTE || hacia == EstadoMaquina::OFF_CALIENTE;
+        case EstadoMaquina::OFF_CALIENTE:
+        case EstadoMaquina::ON_FRIO:
+            return hacia == EstadoMaquina::ON_TIBIO || hacia == EstadoMaquina::OFF_TIBIO;
+        case EstadoMaquina::OFF_TIBIO:
+        case EstadoMaquina::OFF_FRIO:
+            return hacia == EstadoMaquina::ON_FRIO || hacia == EstadoMaquina::OFF_FRIO;
+    }
+    return false;
+}
+
+int64_t costoEstadoFijo(EstadoMaquina estado) {
+    switch (estado) {
+        case EstadoMaquina::ON_CALIENTE: return costoFijo(COSTO_CALIENTE);
+        case EstadoMaquina::ON_TIBIO: return costoFijo(COSTO_TIBIO);
+        case EstadoMaquina::ON_FRIO: return costoFijo(COSTO_FRIO);
+        default: return 0;
+    }
+}
+
+// Costo de una secuencia en centésimas, o -1 si no es factible: las horas
+// críticas en ON/CALIENTE, transiciones de la máquina de estados y, si la
+// eólica cubre la hora 23, terminar apagada (los estados que explora resolver())
+int64_t costoSecuencia(const EstadoMaquina* estados, uint32_t criticas) {
+    int64_t costo = 0;
+    for (int hora = 0; hora < NUM_HORAS; hora++) {
+        bool critica = (criticas >> hora) & 1u;
+        if (critica && estados[hora] != EstadoMaquina::ON_CALIENTE) {
+            return -1;
+        }
+        if (hora > 0 && !transicionPermitida(estados[hora - 1], estados[hora])) {
+            return -1;
+        }
+        costo += costoEstadoFijo(estados[hora]);
+    }
+    EstadoMaquina ultimo = estados[NUM_HORAS - 1];
+    if (!((criticas >> (NUM_HORAS - 1)) & 1u) && ultimo != EstadoMaquina::OFF_FRIO &&
+        ultimo != EstadoMaquina::OFF_TIBIO && ultimo != EstadoMaquina::OFF_CALIENTE) {
+        return -1;
+    }
+    return costo;
+}
+
+// Diferencias entre las dos respuestas de un patrón (máscara de TipoDiferencia).
+// `empate` queda en true si las secuencias difieren pero ambas son óptimas
+int compararResultados(const ResultadoMotor& referencia, const ResultadoMotor& candidato, uint32_t criticas,
+                       bool& empate) {
+    empate = false;
+    if (!referencia.valida) {
+        return candidato.valida ? VALIDEZ : 0;
+    }
+    int diferencias = 0;
+    int64_t optimo = costoFijo(referencia.costo);
+    if (costoSecuencia(referencia.estados, criticas) != optimo) {
+        diferencias |= REFERENCIA_INCONSISTENTE;
+    }
+    if (!candidato.valida) {
+        return diferencias | VALIDEZ;
+    }
+    if (costoFijo(candidato.costo) != optimo) {
+        diferencias |= COSTO;
+    }
+    int64_t costo_secuencia = costoSecuencia(candidato.estados, criticas);
+    if (costo_secuencia < 0) {
+        diferencias |= SECUENCIA_INFACTIBLE;
+    } else if (costo_secuencia != optimo) {
+        diferencias |= SECUENCIA_NO_OPTIMA;
+    } else if (!std::equal(referencia.estados, referencia.estados + NUM_HORAS, candidato.estados)) {
+        empate = true;
+    }
+    return diferencias;
+}
+
+int verificarPatron(uint32_t combinacion, const MotorCandidato& motor) {
+    ResultadoMotor referencia, candidato;
+    resolverReferencia(combinacion, referencia);
+    motor.resolver(combinacion, candidato);
+    bool empate;
+    return compararResultados(referencia, candidato, horasCriticas(combinacion), empate);
+}
+
+// Apaga de a una las horas con viento mientras el patrón siga mostrando alguna
+// de las mismas diferencias; lo que queda no tiene ninguna hora con viento de más
+uint32_t minimizarPatron(uint32_t combinacion, int tipos, const MotorCandidato& motor) {
+    bool cambio = true;
+    while (cambio) {
+        cambio = false;
+        for (int bit = 0; bit < NUM_HORAS; bit++) {
+            uint32_t menor = combinacion & ~(1u << bit);
+            if (menor != combinacion && motor.responde(menor) && (verificarPatron(menor, motor) & tipos)) {
+                combinacion = menor;
+                cambio = true;
+            }
+        }
+    }
+    return combinacion;
+}
+
+std::string patronIndividual(uint32_t combinacion) {
+    return std::bitset<NUM_HORAS>(combinacion).to_string();
+}
+
+std::string describirTipos(int tipos) {
+    std::string texto;
+    for (int t = 0; t < NUM_TIPOS; t++) {
+        if (tipos & (1 << t)) {
+            texto += (texto.empty() ? "" : ", ") + std::string(NOMBRES_TIPOS[t]);
+        }
+    }
+    return texto;
+}
+
+struct DiferenciaEncontrada {
+    uint32_t combinacion;
+    int tipos;
+};
+
+// Aporte de un bloque; se acumula al emitirlo, en orden
+struct ParcialBloque {
+    uint64_t patrones = 0;
+    uint64_t validas = 0;
+    uint64_t empates = 0;
+    uint64_t por_tipo[NUM_TIPOS] = {};
+    double segundos_candidato = 0.0;
+    double segundos_referencia = 0.0;
+    std::vector<DiferenciaEncontrada> diferencias;
+};
+
+// Patrones de la muestra (combinaciones): casos borde que el motor responda y
+// `cantidad` IDs al azar de su rango
+std::vector<uint32_t> generarMuestra(const MotorCandidato& motor, uint32_t desde, uint32_t hasta, uint32_t cantidad,
+                                     uint64_t semilla) {
+    std::vector<uint32_t> patrones;
+    // Sin viento, viento todo el día y una sola hora distinta de cada uno
+    std::vector<uint32_t> bordes = {0, TOTAL_PATRONES - 1};
+    for (int bit = 0; bit < NUM_HORAS; bit++) {
+        bordes.push_back(1u << bit);
+        bordes.push_back((TOTAL_PATRONES - 1) ^ (1u << bit));
+    }
+    for (uint32_t combinacion : bordes) {
+        uint32_t id = motor.combinacionDeId(combinacion);
+        if (id >= desde && id < hasta) {
+            patrones.push_back(combinacion);
+        }
+    }
+    std::mt19937_64 generador(semilla);
+    std::uniform_int_distribution<uint32_t> distribucion(desde, hasta - 1);
+    for (uint32_t i = 0; i < cantidad; i++) {
+        patrones.push_back(motor.combinacionDeId(distribucion(generador)));
+    }
+    return patrones;
+}
+}
+
+int main(int argc, char* argv[]) {
+    Opciones opciones;
+    try {
+        if (!interpretarOpciones(argc, argv, opciones)) {
+            std::cerr << "Uso: " << argv[0] << " [--motor tabular|cubo] [--cubo archivo] [--todas | --muestra N]\n"
+                      << "       [--rango D H] [--semilla S] [--hilos N] [--bloque N]\n"
+                      << "       [--reproductores archivo] [--max-reproductores N]\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    try {
+        using Reloj = std::chrono::steady_clock;
+        auto inicio = Reloj::now();
+        std::shared_ptr<const CuboResultados> cubo;
+        std::unique_ptr<MotorCandidato> motor = crearMotor(opciones, cubo);
+
+        // Rango en IDs del motor: el pedido, recortado a lo que el motor responde
+        uint32_t desde = std::max(opciones.desde, motor->desde);
+        uint32_t hasta = std::min(opciones.hasta, motor->hasta);
+        if (desde >= hasta) {
+            throw std::invalid_argument("el rango pedido no tiene patrones que el motor pueda responder");
+        }
+
+        // En modo muestra el pool recorre posiciones de la lista; con --todas, IDs
+        std::vector<uint32_t> muestra;
+        if (!opciones.todas) {
+            muestra = generarMuestra(*motor, desde, hasta, opciones.muestra, opciones.semilla);
+        }
+        uint32_t pool_desde = opciones.todas ? desde : 0;
+        uint32_t pool_hasta = opciones.todas ? hasta : static_cast<uint32_t>(muestra.size());
+        auto combinacionEn = [&](uint32_t posicion) {
+            return opciones.todas ? motor->combinacionDeId(posicion) : muestra[posicion];
+        };
+
+        uint32_t tam_bloque = opciones.tam_bloque > 0 ? opciones.tam_bloque : (opciones.todas ? 4096 : 256);
+        PoolBloques pool(opciones.num_hilos, tam_bloque);
+
+        std::cout << "=== VERIFICACIÓN DIFERENCIAL DE MOTORES ===\n";
+        std::cout << "Candidato: " << motor->nombre << " | Referencia: CalculadorCostos::resolver\n";
+        if (opciones.todas) {
+            std::cout << "Patrones: todos los IDs de [" << desde << ", " << hasta << ")";
+        } else {
+            std::cout << "Patrones: " << muestra.size() << " (" << muestra.size() - opciones.muestra
+                      << " casos borde y " << opciones.muestra << " al azar, semilla " << opciones.semilla << ")";
+        }
+        std::cout << " | Hilos: " << pool.getNumHilos() << "\n";
+
+        uint32_t num_bloques = (pool_hasta - pool_desde + tam_bloque - 1) / tam_bloque;
+        std::vector<ParcialBloque> parciales(num_bloques);
+
+        // Cada motor resuelve el bloque entero por separado, así el tiempo de
+        // cada uno no incluye al otro ni a la comparación
+        auto procesar = [&](const PoolBloques::Bloque& bloque, unsigned, std::string&) {
+            ParcialBloque& parcial = parciales[bloque.indice];
+            uint32_t cantidad = bloque.hasta - bloque.desde;
+            std::vector<ResultadoMotor> candidatos(cantidad), referencias(cantidad);
+
+            auto inicio_motor = Reloj::now();
+            for (uint32_t i = 0; i < cantidad; i++) {
+                motor->resolver(combinacionEn(bloque.desde + i), candidatos[i]);
+            }
+            auto inicio_referencia = Reloj::now();
+            for (uint32_t i = 0; i < cantidad; i++) {
+                resolverReferencia(combinacionEn(bloque.desde + i), referencias[i]);
+            }
+            auto fin = Reloj::now();
+            parcial.segundos_candidato = std::chrono::duration<double>(inicio_referencia - inicio_motor).count();
+            parcial.segundos_referencia = std::chrono::duration<double>(fin - inicio_referencia).count();
+
+            for (uint32_t i = 0; i < cantidad; i++) {
+                uint32_t combinacion = combinacionEn(bloque.desde + i);
+                bool empate;
+                int tipos = compararResultados(referencias[i], candidatos[i], horasCriticas(combinacion), empate);
+                parcial.patrones++;
+                parcial.validas += referencias[i].valida;
+                parcial.empates += empate;
+                if (tipos != 0) {
+                    for (int t = 0; t < NUM_TIPOS; t++) {
+                        parcial.por_tipo[t] += (tipos >> t) & 1;
+                    }
+                    parcial.diferencias.push_back(DiferenciaEncontrada{combinacion, tipos});
+                }
+            }
+        };
+
+        ParcialBloque total;
+        uint32_t ultimo_reporte = 0;
+        auto emitir = [&](const PoolBloques::Bloque& bloque, std::string&) {
+            ParcialBloque& parcial = parciales[bloque.indice];
+            total.patrones += parcial.patrones;
+            total.validas += parcial.validas;
+            total.empates += parcial.empates;
+            for (int t = 0; t < NUM_TIPOS; t++) {
+                total.por_tipo[t] += parcial.por_tipo[t];
+            }
+            total.segundos_candidato += parcial.segundos_candidato;
+            total.segundos_referencia += parcial.segundos_referencia;
+            total.diferencias.insert(total.diferencias.end(), parcial.diferencias.begin(), parcial.diferencias.end());
+            ParcialBloque().diferencias.swap(parcial.diferencias);
+
+            uint32_t porcentaje = static_cast<uint32_t>(uint64_t(bloque.hasta - pool_desde) * 100 / (pool_hasta - pool_desde));
+            if (porcentaje != ultimo_reporte) {
+                ultimo_reporte = porcentaje;
+                std::cout << "\r[" << porcentaje << "%] " << total.patrones << " patrones | Diferencias: "
+                          << total.diferencias.size() << std::flush;
+            }
+        };
+        pool.ejecutar(pool_desde, pool_hasta, procesar, emitir);
+
+        std::cout << "\n\n=== RESULTADO ===\n";
+        std::cout << "Patrones verificados: " << total.patrones << "\n";
+        std::cout << "Soluciones válidas (referencia): " << total.validas << "\n";
+        std::cout << "Secuencias distintas con el mismo costo óptimo: " << total.empates << "\n";
+        std::cout << "Patrones con diferencias: " << total.diferencias.size()
+                  << (total.diferencias.empty() ? " ✅" : " ❌") << "\n";
+        for (int t = 0; t < NUM_TIPOS; t++) {
+            if (total.por_tipo[t] > 0) {
+                std::cout << "  " << std::left << std::setw(26) << NOMBRES_TIPOS[t] << std::right
+                          << total.por_tipo[t] << "\n";
+            }
+        }
+
+        // Reproductores mínimos, sin repetir: muchos patrones suelen reducirse al mismo
+        if (!total.diferencias.empty()) {
+            std::vector<DiferenciaEncontrada> reproductores;
+            for (const DiferenciaEncontrada& diferencia : total.diferencias) {
+                if (reproductores.size() >= opciones.max_reproductores) {
+                    break;
+                }
+                uint32_t minimo = minimizarPatron(diferencia.combinacion, diferencia.tipos, *motor);
+                bool repetido = std::any_of(reproductores.begin(), reproductores.end(),
+                                            [&](const DiferenciaEncontrada& r) { return r.combinacion == minimo; });
+                if (!repetido) {
+                    reproductores.push_back(DiferenciaEncontrada{minimo, verificarPatron(minimo, *motor)});
+                }
+            }
+
+            std::cout << "\nReproductores mínimos (formato de analizador_individual, hora 0 a la izquierda):\n";
+            for (const DiferenciaEncontrada& r : reproductores) {
+                std::cout << "  " << patronIndividual(r.combinacion) << "  " << describirTipos(r.tipos)
+                          << "  → ./analizador_individual --patron " << patronIndividual(r.combinacion) << "\n";
+            }
+            if (!opciones.archivo_reproductores.empty()) {
+                std::ofstream archivo(opciones.archivo_reproductores);
+                archivo << "# Diferencias de " << motor->nombre << " contra CalculadorCostos::resolver\n"
+                        << "# ./analizador_individual --archivo " << opciones.archivo_reproductores << "\n";
+                for (const DiferenciaEncontrada& r : reproductores) {
+                    archivo << "# " << describirTipos(r.tipos) << "\n" << patronIndividual(r.combinacion) << "\n";
+                }
+                if (!archivo) {
+                    throw std::runtime_error("No se pudo escribir " + opciones.archivo_reproductores);
+                }
+                std::cout << "Reproductores guardados en: " << opciones.archivo_reproductores << "\n";
+            }
+        }
+
+        // Tiempo de hilo de cada motor: no depende de cuántos hilos se usaron
+        std::cout << "\n=== RENDIMIENTO (por hilo) ===\n";
+        auto fila = [&](const std::string& nombre, double segundos) {
+            std::cout << "  " << std::left << std::setw(12) << nombre << std::right << std::fixed
+                      << std::setprecision(0) << std::setw(12) << total.patrones / std::max(segundos, 1e-9)
+                      << " patrones/s  (" << std::setprecision(3) << segundos << " s)\n";
+        };
+        fila("referencia", total.segundos_referencia);
+        fila(motor->nombre, total.segundos_candidato);
+        std::cout << "  Aceleración: " << std::setprecision(1)
+                  << total.segundos_referencia / std::max(total.segundos_candidato, 1e-9) << "x\n";
+        std::cout << "Tiempo total: " << std::setprecision(2)
+                  << std::chrono::duration<double>(Reloj::now() - inicio).count() << " s\n";
+
+        return total.diferencias.empty() ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "\nError: " << e.what() << "\n";
+        return 1;
+    }
+}